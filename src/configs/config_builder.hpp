@@ -164,6 +164,8 @@ const config& cfg##_config::instance() \
 
 #define TBLIS_CONFIG_GEMM_UKR(S,D,C,Z) \
     TBLIS_CONFIG_UKR2(this_config, gemm_ukr, gemm_ukr_t, S,D,C,Z, gemm_ukr_def)
+#define TBLIS_CONFIG_GEMM_MIXED_UKR(S,D,C,Z) \
+    TBLIS_CONFIG_UKR2(this_config, gemm_mixed_ukr, gemm_mixed_ukr_t, S,D,C,Z, gemm_mixed_ukr_def)
 
 #define TBLIS_CONFIG_PACK_NN_MR_UKR(S,D,C,Z) \
     TBLIS_CONFIG_UKR3(this_config, matrix_constants::MAT_A, pack_nn_mr_ukr, pack_nn_ukr_t, S,D,C,Z, pack_nn_ukr_def)
@@ -193,6 +195,14 @@ const config& cfg##_config::instance() \
     TBLIS_CONFIG_UKR3(this_config, matrix_constants::MAT_A, pack_sb_mr_ukr, pack_sb_ukr_t, S,D,C,Z, pack_sb_ukr_def)
 #define TBLIS_CONFIG_PACK_SB_NR_UKR(S,D,C,Z) \
     TBLIS_CONFIG_UKR3(this_config, matrix_constants::MAT_B, pack_sb_nr_ukr, pack_sb_ukr_t, S,D,C,Z, pack_sb_ukr_def)
+#define TBLIS_CONFIG_PACK_NB_MIXED_MR_UKR(S,D,C,Z) \
+    TBLIS_CONFIG_UKR3(this_config, matrix_constants::MAT_A, pack_nb_mixed_mr_ukr, pack_nb_mixed_ukr_t, S,D,C,Z, pack_nb_mixed_ukr_def)
+#define TBLIS_CONFIG_PACK_NB_MIXED_NR_UKR(S,D,C,Z) \
+    TBLIS_CONFIG_UKR3(this_config, matrix_constants::MAT_B, pack_nb_mixed_nr_ukr, pack_nb_mixed_ukr_t, S,D,C,Z, pack_nb_mixed_ukr_def)
+#define TBLIS_CONFIG_PACK_SB_MIXED_MR_UKR(S,D,C,Z) \
+    TBLIS_CONFIG_UKR3(this_config, matrix_constants::MAT_A, pack_sb_mixed_mr_ukr, pack_sb_mixed_ukr_t, S,D,C,Z, pack_sb_mixed_ukr_def)
+#define TBLIS_CONFIG_PACK_SB_MIXED_NR_UKR(S,D,C,Z) \
+    TBLIS_CONFIG_UKR3(this_config, matrix_constants::MAT_B, pack_sb_mixed_nr_ukr, pack_sb_mixed_ukr_t, S,D,C,Z, pack_sb_mixed_ukr_def)
 #define TBLIS_CONFIG_PACK_SS_SCAL_MR_UKR(S,D,C,Z) \
     TBLIS_CONFIG_UKR3(this_config, matrix_constants::MAT_A, pack_ss_scal_mr_ukr, pack_ss_scal_ukr_t, S,D,C,Z, pack_ss_scal_ukr_def)
 #define TBLIS_CONFIG_PACK_SS_SCAL_NR_UKR(S,D,C,Z) \
@@ -317,6 +327,7 @@ struct config_template
     TBLIS_CONFIG_GEMM_NC(_,_,_,_)
     TBLIS_CONFIG_GEMM_KC(_,_,_,_)
     TBLIS_CONFIG_GEMM_UKR(_,_,_,_)
+    TBLIS_CONFIG_GEMM_MIXED_UKR(_,_,_,_)
     TBLIS_CONFIG_GEMM_ROW_MAJOR(_,_,_,_)
     TBLIS_CONFIG_GEMM_FLIP_UKR(_,_,_,_)
 
@@ -334,6 +345,10 @@ struct config_template
     TBLIS_CONFIG_PACK_NB_NR_UKR(_,_,_,_)
     TBLIS_CONFIG_PACK_SB_MR_UKR(_,_,_,_)
     TBLIS_CONFIG_PACK_SB_NR_UKR(_,_,_,_)
+    TBLIS_CONFIG_PACK_NB_MIXED_MR_UKR(_,_,_,_)
+    TBLIS_CONFIG_PACK_NB_MIXED_NR_UKR(_,_,_,_)
+    TBLIS_CONFIG_PACK_SB_MIXED_MR_UKR(_,_,_,_)
+    TBLIS_CONFIG_PACK_SB_MIXED_NR_UKR(_,_,_,_)
     TBLIS_CONFIG_PACK_SS_SCAL_MR_UKR(_,_,_,_)
     TBLIS_CONFIG_PACK_SS_SCAL_NR_UKR(_,_,_,_)
 
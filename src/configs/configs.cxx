@@ -1,6 +1,9 @@
 #include "configs.hpp"
+#include "tuning.hpp"
 #include "configs/include_configs.hpp"
 
+#include <memory>
+
 namespace tblis
 {
 
@@ -38,6 +41,7 @@ struct default_config
 {
     instance_fn_t value_fn = nullptr;
     const config* value = nullptr;
+    std::unique_ptr<config> tuned;
 
     default_config()
     {
@@ -74,6 +78,13 @@ struct default_config
         {
             printf("tblis: Using configuration %s.\n", value->name);
         }
+
+        /*
+         * Override the cache blocksizes and thread partitioning with any
+         * values stored by bin/tune for this machine.
+         */
+        tuned.reset(new config(*value));
+        if (load_tuning(*tuned)) value = tuned.get();
     }
 };
 
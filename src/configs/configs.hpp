@@ -138,6 +138,7 @@ struct config
     blocksize gemm_kc;
 
     microkernel<gemm_ukr_t> gemm_ukr;
+    microkernel<gemm_mixed_ukr_t> gemm_mixed_ukr;
 
     parameter<bool> gemm_row_major;
     parameter<bool> gemm_flip_ukr;
@@ -156,6 +157,10 @@ struct config
     microkernel<pack_nb_ukr_t> pack_nb_nr_ukr;
     microkernel<pack_sb_ukr_t> pack_sb_mr_ukr;
     microkernel<pack_sb_ukr_t> pack_sb_nr_ukr;
+    microkernel<pack_nb_mixed_ukr_t> pack_nb_mixed_mr_ukr;
+    microkernel<pack_nb_mixed_ukr_t> pack_nb_mixed_nr_ukr;
+    microkernel<pack_sb_mixed_ukr_t> pack_sb_mixed_mr_ukr;
+    microkernel<pack_sb_mixed_ukr_t> pack_sb_mixed_nr_ukr;
     microkernel<pack_ss_scal_ukr_t> pack_ss_scal_mr_ukr;
     microkernel<pack_ss_scal_ukr_t> pack_ss_scal_nr_ukr;
 
@@ -196,6 +201,7 @@ struct config
       gemm_kc(typename Traits::template gemm_kc<float>()),
 
       gemm_ukr(typename Traits::template gemm_ukr<float>()),
+      gemm_mixed_ukr(typename Traits::template gemm_mixed_ukr<float>()),
 
       gemm_row_major(typename Traits::template gemm_row_major<float>()),
       gemm_flip_ukr(typename Traits::template gemm_flip_ukr<float>()),
@@ -214,6 +220,10 @@ struct config
       pack_nb_nr_ukr(typename Traits::template pack_nb_nr_ukr<float>()),
       pack_sb_mr_ukr(typename Traits::template pack_sb_mr_ukr<float>()),
       pack_sb_nr_ukr(typename Traits::template pack_sb_nr_ukr<float>()),
+      pack_nb_mixed_mr_ukr(typename Traits::template pack_nb_mixed_mr_ukr<float>()),
+      pack_nb_mixed_nr_ukr(typename Traits::template pack_nb_mixed_nr_ukr<float>()),
+      pack_sb_mixed_mr_ukr(typename Traits::template pack_sb_mixed_mr_ukr<float>()),
+      pack_sb_mixed_nr_ukr(typename Traits::template pack_sb_mixed_nr_ukr<float>()),
       pack_ss_scal_mr_ukr(typename Traits::template pack_ss_scal_mr_ukr<float>()),
       pack_ss_scal_nr_ukr(typename Traits::template pack_ss_scal_nr_ukr<float>()),
 
@@ -21,6 +21,17 @@ EXTERN_GEMM_UKR(double, bli_dgemm_asm_4x12);
 namespace tblis
 {
 
+EXTERN_GEMM_UKR(scomplex, haswell_cgemm_3x8);
+EXTERN_GEMM_UKR(dcomplex, haswell_zgemm_3x4);
+
+EXTERN_TRANS_UKR( float, haswell_strans_8x8);
+EXTERN_TRANS_UKR(double, haswell_dtrans_4x4);
+
+EXTERN_PACK_NN_UKR(scomplex, haswell_cpackm_3xk);
+EXTERN_PACK_NN_UKR(scomplex, haswell_cpackm_8xk);
+EXTERN_PACK_NN_UKR(dcomplex, haswell_zpackm_3xk);
+EXTERN_PACK_NN_UKR(dcomplex, haswell_zpackm_4xk);
+
 extern int haswell_check();
 
 TBLIS_BEGIN_CONFIG(haswell_d12x4)
@@ -81,19 +92,26 @@ TBLIS_END_CONFIG
 
 TBLIS_BEGIN_CONFIG(haswell_d6x8)
 
-    TBLIS_CONFIG_GEMM_MR(   6,    6, _, _)
-    TBLIS_CONFIG_GEMM_NR(  16,    8, _, _)
-    TBLIS_CONFIG_GEMM_KR(   8,    4, _, _)
-    TBLIS_CONFIG_GEMM_MC( 144,   72, _, _)
-    TBLIS_CONFIG_GEMM_NC(4080, 4080, _, _)
-    TBLIS_CONFIG_GEMM_KC( 256,  256, _, _)
+    TBLIS_CONFIG_GEMM_MR(   6,    6,    3,    3)
+    TBLIS_CONFIG_GEMM_NR(  16,    8,    8,    4)
+    TBLIS_CONFIG_GEMM_KR(   8,    4,    4,    2)
+    TBLIS_CONFIG_GEMM_MC( 144,   72,  144,   72)
+    TBLIS_CONFIG_GEMM_NC(4080, 4080, 4080, 4080)
+    TBLIS_CONFIG_GEMM_KC( 256,  256,  256,  256)
 
     TBLIS_CONFIG_GEMM_UKR(bli_sgemm_asm_6x16,
                           bli_dgemm_asm_6x8,
-                          _,
-                          _)
+                          haswell_cgemm_3x8,
+                          haswell_zgemm_3x4)
 
-    TBLIS_CONFIG_GEMM_ROW_MAJOR(true, true, _, _)
+    TBLIS_CONFIG_PACK_NN_MR_UKR(_, _, haswell_cpackm_3xk, haswell_zpackm_3xk)
+    TBLIS_CONFIG_PACK_NN_NR_UKR(_, _, haswell_cpackm_8xk, haswell_zpackm_4xk)
+
+    TBLIS_CONFIG_TRANS_MR(   8,    4, _, _)
+    TBLIS_CONFIG_TRANS_NR(   8,    4, _, _)
+    TBLIS_CONFIG_TRANS_UKR(haswell_strans_8x8, haswell_dtrans_4x4, _, _)
+
+    TBLIS_CONFIG_GEMM_ROW_MAJOR(true, true, true, true)
 
     TBLIS_CONFIG_CHECK(haswell_check)
 
@@ -0,0 +1,237 @@
+#include "config.hpp"
+#include "packm_complex.hpp"
+
+#include <immintrin.h>
+
+namespace tblis
+{
+
+template <typename T> struct avx2_complex;
+
+template <> struct avx2_complex<scomplex>
+{
+    typedef __m256 vec;
+    constexpr static len_type NC = 4;
+
+    static vec zero() { return _mm256_setzero_ps(); }
+    static vec set1(float x) { return _mm256_set1_ps(x); }
+    static vec bcast(const float* x) { return _mm256_broadcast_ss(x); }
+    static vec load(const scomplex* x) { return _mm256_loadu_ps((const float*)x); }
+    static void store(scomplex* x, vec v) { _mm256_storeu_ps((float*)x, v); }
+    static vec fma(vec a, vec b, vec c) { return _mm256_fmadd_ps(a, b, c); }
+    static vec mul(vec a, vec b) { return _mm256_mul_ps(a, b); }
+    static vec add(vec a, vec b) { return _mm256_add_ps(a, b); }
+    static vec addsub(vec a, vec b) { return _mm256_addsub_ps(a, b); }
+    static vec swap(vec a) { return _mm256_permute_ps(a, 0xb1); }
+};
+
+template <> struct avx2_complex<dcomplex>
+{
+    typedef __m256d vec;
+    constexpr static len_type NC = 2;
+
+    static vec zero() { return _mm256_setzero_pd(); }
+    static vec set1(double x) { return _mm256_set1_pd(x); }
+    static vec bcast(const double* x) { return _mm256_broadcast_sd(x); }
+    static vec load(const dcomplex* x) { return _mm256_loadu_pd((const double*)x); }
+    static void store(dcomplex* x, vec v) { _mm256_storeu_pd((double*)x, v); }
+    static vec fma(vec a, vec b, vec c) { return _mm256_fmadd_pd(a, b, c); }
+    static vec mul(vec a, vec b) { return _mm256_mul_pd(a, b); }
+    static vec add(vec a, vec b) { return _mm256_add_pd(a, b); }
+    static vec addsub(vec a, vec b) { return _mm256_addsub_pd(a, b); }
+    static vec swap(vec a) { return _mm256_permute_pd(a, 0x5); }
+};
+
+/*
+ * Row-major complex microkernel. Each element of A is split into broadcast
+ * real and imaginary parts which are accumulated against the interleaved
+ * row of B in separate registers. Since
+ *
+ *   (ar*br - ai*bi, ar*bi + ai*br) = addsub(ar*(br,bi), swap(ai*(br,bi)))
+ *
+ * the two sets of accumulators only have to be combined once after the k
+ * loop, so the inner loop consists purely of broadcasts and FMAs.
+ */
+template <typename T, len_type MR, len_type NR>
+static void gemm_complex_avx2_row(stride_type k,
+                                  const T* TBLIS_RESTRICT alpha,
+                                  const T* TBLIS_RESTRICT p_a, const T* TBLIS_RESTRICT p_b,
+                                  const T* TBLIS_RESTRICT beta,
+                                  T* TBLIS_RESTRICT p_c, stride_type rs_c)
+{
+    typedef avx2_complex<T> V;
+    typedef typename V::vec vec;
+    typedef typename T::value_type U;
+    constexpr len_type NV = NR/V::NC;
+
+    static_assert(NR%V::NC == 0, "NR must be a multiple of the vector length");
+
+    vec ab_r[MR][NV], ab_i[MR][NV];
+
+    TBLIS_UNROLL
+    for (len_type i = 0;i < MR;i++)
+    {
+        TBLIS_UNROLL
+        for (len_type v = 0;v < NV;v++)
+        {
+            ab_r[i][v] = V::zero();
+            ab_i[i][v] = V::zero();
+        }
+
+        _mm_prefetch((const char*)(p_c + i*rs_c), _MM_HINT_T0);
+    }
+
+    while (k --> 0)
+    {
+        vec b[NV];
+
+        TBLIS_UNROLL
+        for (len_type v = 0;v < NV;v++)
+            b[v] = V::load(p_b + v*V::NC);
+
+        _mm_prefetch((const char*)(p_b + 8*NR), _MM_HINT_T0);
+
+        TBLIS_UNROLL
+        for (len_type i = 0;i < MR;i++)
+        {
+            vec a_r = V::bcast((const U*)(p_a + i)  );
+            vec a_i = V::bcast((const U*)(p_a + i)+1);
+
+            TBLIS_UNROLL
+            for (len_type v = 0;v < NV;v++)
+            {
+                ab_r[i][v] = V::fma(a_r, b[v], ab_r[i][v]);
+                ab_i[i][v] = V::fma(a_i, b[v], ab_i[i][v]);
+            }
+        }
+
+        p_a += MR;
+        p_b += NR;
+    }
+
+    vec alpha_r = V::set1(alpha->real());
+    vec alpha_i = V::set1(alpha->imag());
+
+    vec ab[MR][NV];
+
+    TBLIS_UNROLL
+    for (len_type i = 0;i < MR;i++)
+    {
+        TBLIS_UNROLL
+        for (len_type v = 0;v < NV;v++)
+        {
+            vec tmp = V::addsub(ab_r[i][v], V::swap(ab_i[i][v]));
+            ab[i][v] = V::addsub(V::mul(tmp, alpha_r), V::mul(V::swap(tmp), alpha_i));
+        }
+    }
+
+    if (*beta == T(0))
+    {
+        TBLIS_UNROLL
+        for (len_type i = 0;i < MR;i++)
+            TBLIS_UNROLL
+            for (len_type v = 0;v < NV;v++)
+                V::store(p_c + i*rs_c + v*V::NC, ab[i][v]);
+    }
+    else
+    {
+        vec beta_r = V::set1(beta->real());
+        vec beta_i = V::set1(beta->imag());
+
+        TBLIS_UNROLL
+        for (len_type i = 0;i < MR;i++)
+        {
+            TBLIS_UNROLL
+            for (len_type v = 0;v < NV;v++)
+            {
+                vec c = V::load(p_c + i*rs_c + v*V::NC);
+                c = V::addsub(V::mul(c, beta_r), V::mul(V::swap(c), beta_i));
+                V::store(p_c + i*rs_c + v*V::NC, V::add(c, ab[i][v]));
+            }
+        }
+    }
+}
+
+template <typename T, len_type MR, len_type NR>
+static void gemm_complex_avx2(stride_type k,
+                              const T* TBLIS_RESTRICT alpha,
+                              const T* TBLIS_RESTRICT p_a, const T* TBLIS_RESTRICT p_b,
+                              const T* TBLIS_RESTRICT beta,
+                              T* TBLIS_RESTRICT p_c, stride_type rs_c, stride_type cs_c)
+{
+    if (cs_c == 1)
+    {
+        gemm_complex_avx2_row<T,MR,NR>(k, alpha, p_a, p_b, beta, p_c, rs_c);
+    }
+    else
+    {
+        T p_ab[MR*NR] __attribute__((aligned(64)));
+        static const T zero = T(0);
+
+        gemm_complex_avx2_row<T,MR,NR>(k, alpha, p_a, p_b, &zero, p_ab, NR);
+
+        if (*beta == T(0))
+        {
+            for (len_type i = 0;i < MR;i++)
+                for (len_type j = 0;j < NR;j++)
+                    p_c[i*rs_c + j*cs_c] = p_ab[i*NR + j];
+        }
+        else
+        {
+            for (len_type i = 0;i < MR;i++)
+                for (len_type j = 0;j < NR;j++)
+                    p_c[i*rs_c + j*cs_c] = p_ab[i*NR + j] +
+                                           (*beta)*p_c[i*rs_c + j*cs_c];
+        }
+    }
+}
+
+void haswell_cgemm_3x8(stride_type k,
+                       const scomplex* alpha,
+                       const scomplex* a, const scomplex* b,
+                       const scomplex* beta,
+                       scomplex* c, stride_type rs_c, stride_type cs_c,
+                       auxinfo_t*)
+{
+    gemm_complex_avx2<scomplex, 3, 8>(k, alpha, a, b, beta, c, rs_c, cs_c);
+}
+
+void haswell_zgemm_3x4(stride_type k,
+                       const dcomplex* alpha,
+                       const dcomplex* a, const dcomplex* b,
+                       const dcomplex* beta,
+                       dcomplex* c, stride_type rs_c, stride_type cs_c,
+                       auxinfo_t*)
+{
+    gemm_complex_avx2<dcomplex, 3, 4>(k, alpha, a, b, beta, c, rs_c, cs_c);
+}
+
+void haswell_cpackm_3xk(len_type m, len_type k,
+                        bool conj_a, const scomplex* p_a, stride_type rs_a, stride_type cs_a,
+                        scomplex* p_ap)
+{
+    pack_complex<scomplex, 3>(m, k, conj_a, p_a, rs_a, cs_a, p_ap);
+}
+
+void haswell_cpackm_8xk(len_type m, len_type k,
+                        bool conj_a, const scomplex* p_a, stride_type rs_a, stride_type cs_a,
+                        scomplex* p_ap)
+{
+    pack_complex<scomplex, 8>(m, k, conj_a, p_a, rs_a, cs_a, p_ap);
+}
+
+void haswell_zpackm_3xk(len_type m, len_type k,
+                        bool conj_a, const dcomplex* p_a, stride_type rs_a, stride_type cs_a,
+                        dcomplex* p_ap)
+{
+    pack_complex<dcomplex, 3>(m, k, conj_a, p_a, rs_a, cs_a, p_ap);
+}
+
+void haswell_zpackm_4xk(len_type m, len_type k,
+                        bool conj_a, const dcomplex* p_a, stride_type rs_a, stride_type cs_a,
+                        dcomplex* p_ap)
+{
+    pack_complex<dcomplex, 4>(m, k, conj_a, p_a, rs_a, cs_a, p_ap);
+}
+
+}
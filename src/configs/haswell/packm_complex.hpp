@@ -0,0 +1,156 @@
+#ifndef _TBLIS_CONFIGS_HASWELL_PACKM_COMPLEX_HPP_
+#define _TBLIS_CONFIGS_HASWELL_PACKM_COMPLEX_HPP_
+
+#include "util/basic_types.h"
+
+#include <immintrin.h>
+
+namespace tblis
+{
+
+/*
+ * Sign mask which flips the imaginary parts of the complex numbers in a
+ * vector, or leaves them alone if conj is false.
+ */
+static inline __m256d conj_mask(const dcomplex*, bool conj)
+{
+    return conj ? _mm256_set_pd(-0.0, 0.0, -0.0, 0.0) : _mm256_setzero_pd();
+}
+
+static inline __m256d conj_mask(const scomplex*, bool conj)
+{
+    return conj ? _mm256_castps_pd(_mm256_set_ps(-0.0f, 0.0f, -0.0f, 0.0f,
+                                                 -0.0f, 0.0f, -0.0f, 0.0f))
+                : _mm256_setzero_pd();
+}
+
+/*
+ * Transpose an MR x k panel of A with unit column stride into the packed
+ * format. A dcomplex is moved as a 128-bit unit (2x2 blocks), a scomplex as
+ * a 64-bit unit (4x4 blocks), so that no complex number is ever split.
+ *
+ * These are static since they are compiled with different instruction sets
+ * for each configuration that includes them.
+ */
+template <len_type MR>
+static void pack_complex_transpose(len_type k, bool conj_a,
+                                   const dcomplex* TBLIS_RESTRICT p_a, stride_type rs_a,
+                                   dcomplex* TBLIS_RESTRICT p_ap)
+{
+    __m256d mask = conj_mask(p_a, conj_a);
+
+    len_type p = 0;
+    for (;p < k-1;p += 2)
+    {
+        len_type mr = 0;
+        for (;mr < MR-1;mr += 2)
+        {
+            __m256d r0 = _mm256_xor_pd(mask, _mm256_loadu_pd((const double*)(p_a + rs_a*(mr  ) + p)));
+            __m256d r1 = _mm256_xor_pd(mask, _mm256_loadu_pd((const double*)(p_a + rs_a*(mr+1) + p)));
+
+            _mm256_storeu_pd((double*)(p_ap + MR*(p  ) + mr), _mm256_permute2f128_pd(r0, r1, 0x20));
+            _mm256_storeu_pd((double*)(p_ap + MR*(p+1) + mr), _mm256_permute2f128_pd(r0, r1, 0x31));
+        }
+
+        for (;mr < MR;mr++)
+        {
+            p_ap[MR*(p  ) + mr] = conj(conj_a, p_a[rs_a*mr + p  ]);
+            p_ap[MR*(p+1) + mr] = conj(conj_a, p_a[rs_a*mr + p+1]);
+        }
+    }
+
+    for (;p < k;p++)
+        for (len_type mr = 0;mr < MR;mr++)
+            p_ap[MR*p + mr] = conj(conj_a, p_a[rs_a*mr + p]);
+}
+
+template <len_type MR>
+static void pack_complex_transpose(len_type k, bool conj_a,
+                                   const scomplex* TBLIS_RESTRICT p_a, stride_type rs_a,
+                                   scomplex* TBLIS_RESTRICT p_ap)
+{
+    __m256d mask = conj_mask(p_a, conj_a);
+
+    len_type p = 0;
+    for (;p < k-3;p += 4)
+    {
+        len_type mr = 0;
+        for (;mr < MR-3;mr += 4)
+        {
+            __m256d r0 = _mm256_xor_pd(mask, _mm256_loadu_pd((const double*)(p_a + rs_a*(mr  ) + p)));
+            __m256d r1 = _mm256_xor_pd(mask, _mm256_loadu_pd((const double*)(p_a + rs_a*(mr+1) + p)));
+            __m256d r2 = _mm256_xor_pd(mask, _mm256_loadu_pd((const double*)(p_a + rs_a*(mr+2) + p)));
+            __m256d r3 = _mm256_xor_pd(mask, _mm256_loadu_pd((const double*)(p_a + rs_a*(mr+3) + p)));
+
+            __m256d t0 = _mm256_unpacklo_pd(r0, r1);
+            __m256d t1 = _mm256_unpackhi_pd(r0, r1);
+            __m256d t2 = _mm256_unpacklo_pd(r2, r3);
+            __m256d t3 = _mm256_unpackhi_pd(r2, r3);
+
+            _mm256_storeu_pd((double*)(p_ap + MR*(p  ) + mr), _mm256_permute2f128_pd(t0, t2, 0x20));
+            _mm256_storeu_pd((double*)(p_ap + MR*(p+1) + mr), _mm256_permute2f128_pd(t1, t3, 0x20));
+            _mm256_storeu_pd((double*)(p_ap + MR*(p+2) + mr), _mm256_permute2f128_pd(t0, t2, 0x31));
+            _mm256_storeu_pd((double*)(p_ap + MR*(p+3) + mr), _mm256_permute2f128_pd(t1, t3, 0x31));
+        }
+
+        for (;mr < MR;mr++)
+            for (len_type kr = 0;kr < 4;kr++)
+                p_ap[MR*(p+kr) + mr] = conj(conj_a, p_a[rs_a*mr + p+kr]);
+    }
+
+    for (;p < k;p++)
+        for (len_type mr = 0;mr < MR;mr++)
+            p_ap[MR*p + mr] = conj(conj_a, p_a[rs_a*mr + p]);
+}
+
+/*
+ * Pack kernel for complex panels without an extent (ME == MR). Full panels
+ * with either unit row or unit column stride are handled with vector
+ * loads and stores, everything else goes through the generic loop.
+ * Conjugation is applied on the fly by flipping the imaginary sign bits.
+ */
+template <typename T, len_type MR>
+static void pack_complex(len_type m, len_type k, bool conj_a,
+                         const T* TBLIS_RESTRICT p_a, stride_type rs_a, stride_type cs_a,
+                         T* TBLIS_RESTRICT p_ap)
+{
+    if (m == MR && rs_a == 1)
+    {
+        constexpr len_type NV = (MR*sizeof(T))/32;
+        constexpr len_type NL = (NV*32)/sizeof(T);
+
+        __m256d mask = conj_mask(p_a, conj_a);
+
+        for (len_type p = 0;p < k;p++)
+        {
+            for (len_type v = 0;v < NV;v++)
+                _mm256_storeu_pd((double*)p_ap + 4*v,
+                    _mm256_xor_pd(mask, _mm256_loadu_pd((const double*)p_a + 4*v)));
+
+            for (len_type mr = NL;mr < MR;mr++)
+                p_ap[mr] = conj(conj_a, p_a[mr]);
+
+            p_a += cs_a;
+            p_ap += MR;
+        }
+    }
+    else if (m == MR && cs_a == 1)
+    {
+        pack_complex_transpose<MR>(k, conj_a, p_a, rs_a, p_ap);
+    }
+    else
+    {
+        for (len_type p = 0;p < k;p++)
+        {
+            for (len_type mr = 0;mr < m;mr++)
+                p_ap[mr + MR*p] = conj(conj_a, p_a[rs_a*mr + cs_a*p]);
+
+            for (len_type mr = m;mr < MR;mr++)
+                p_ap[mr + MR*p] = T();
+        }
+    }
+}
+
+}
+
+#endif
@@ -0,0 +1,79 @@
+#include "config.hpp"
+
+#include "kernels/1v/simd.hpp"
+
+#include <immintrin.h>
+
+namespace tblis
+{
+
+template <typename T> struct avx_1v;
+
+template <> struct avx_1v<float>
+{
+    typedef __m256 vec;
+    constexpr static len_type NR = 8;
+
+    static vec zero() { return _mm256_setzero_ps(); }
+    static vec set1(float x) { return _mm256_set1_ps(x); }
+    static vec set2(float x, float y) { return _mm256_setr_ps(x, y, x, y, x, y, x, y); }
+    static vec load(const float* x) { return _mm256_loadu_ps(x); }
+    static void store(float* x, vec v) { _mm256_storeu_ps(x, v); }
+    static vec add(vec a, vec b) { return _mm256_add_ps(a, b); }
+    static vec mul(vec a, vec b) { return _mm256_mul_ps(a, b); }
+    static vec fma(vec a, vec b, vec c) { return _mm256_fmadd_ps(a, b, c); }
+    static vec fmaddsub(vec a, vec b, vec c) { return _mm256_fmaddsub_ps(a, b, c); }
+    static vec max(vec a, vec b) { return _mm256_max_ps(a, b); }
+    static vec min(vec a, vec b) { return _mm256_min_ps(a, b); }
+    static vec sqrt(vec a) { return _mm256_sqrt_ps(a); }
+    static vec abs(vec a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+    static vec conj(vec a) { return _mm256_xor_ps(a, set2(0.0f, -0.0f)); }
+    static vec swap(vec a) { return _mm256_permute_ps(a, 0xb1); }
+    static vec dup_even(vec a) { return _mm256_moveldup_ps(a); }
+    static vec dup_odd(vec a) { return _mm256_movehdup_ps(a); }
+    static vec blend_odd(vec a, vec b) { return _mm256_blend_ps(a, b, 0xaa); }
+
+    static int first_eq(vec a, vec b)
+    {
+        int mask = _mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_EQ_OQ));
+        return mask ? __builtin_ctz(mask) : -1;
+    }
+};
+
+template <> struct avx_1v<double>
+{
+    typedef __m256d vec;
+    constexpr static len_type NR = 4;
+
+    static vec zero() { return _mm256_setzero_pd(); }
+    static vec set1(double x) { return _mm256_set1_pd(x); }
+    static vec set2(double x, double y) { return _mm256_setr_pd(x, y, x, y); }
+    static vec load(const double* x) { return _mm256_loadu_pd(x); }
+    static void store(double* x, vec v) { _mm256_storeu_pd(x, v); }
+    static vec add(vec a, vec b) { return _mm256_add_pd(a, b); }
+    static vec mul(vec a, vec b) { return _mm256_mul_pd(a, b); }
+    static vec fma(vec a, vec b, vec c) { return _mm256_fmadd_pd(a, b, c); }
+    static vec fmaddsub(vec a, vec b, vec c) { return _mm256_fmaddsub_pd(a, b, c); }
+    static vec max(vec a, vec b) { return _mm256_max_pd(a, b); }
+    static vec min(vec a, vec b) { return _mm256_min_pd(a, b); }
+    static vec sqrt(vec a) { return _mm256_sqrt_pd(a); }
+    static vec abs(vec a) { return _mm256_andnot_pd(_mm256_set1_pd(-0.0), a); }
+    static vec conj(vec a) { return _mm256_xor_pd(a, set2(0.0, -0.0)); }
+    static vec swap(vec a) { return _mm256_permute_pd(a, 0x5); }
+    static vec dup_even(vec a) { return _mm256_movedup_pd(a); }
+    static vec dup_odd(vec a) { return _mm256_permute_pd(a, 0xf); }
+    static vec blend_odd(vec a, vec b) { return _mm256_blend_pd(a, b, 0xa); }
+
+    static int first_eq(vec a, vec b)
+    {
+        int mask = _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_EQ_OQ));
+        return mask ? __builtin_ctz(mask) : -1;
+    }
+};
+
+TBLIS_SIMD_1V_UKRS(haswell_s, avx_1v<float>,    float)
+TBLIS_SIMD_1V_UKRS(haswell_d, avx_1v<double>,   double)
+TBLIS_SIMD_1V_UKRS(haswell_c, avx_1v<float>,  scomplex)
+TBLIS_SIMD_1V_UKRS(haswell_z, avx_1v<double>, dcomplex)
+
+}
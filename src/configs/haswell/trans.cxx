@@ -0,0 +1,142 @@
+#include "config.hpp"
+
+#include <immintrin.h>
+
+namespace tblis
+{
+
+template <typename T> struct avx_trans;
+
+template <> struct avx_trans<float>
+{
+    typedef __m256 vec;
+    constexpr static len_type NV = 8;
+
+    static vec set1(float x) { return _mm256_set1_ps(x); }
+    static vec load(const float* x) { return _mm256_loadu_ps(x); }
+    static void store(float* x, vec v) { _mm256_storeu_ps(x, v); }
+    static vec mul(vec a, vec b) { return _mm256_mul_ps(a, b); }
+    static vec fma(vec a, vec b, vec c) { return _mm256_fmadd_ps(a, b, c); }
+
+    static void transpose(vec (&v)[NV])
+    {
+        vec t0 = _mm256_unpacklo_ps(v[0], v[1]);
+        vec t1 = _mm256_unpackhi_ps(v[0], v[1]);
+        vec t2 = _mm256_unpacklo_ps(v[2], v[3]);
+        vec t3 = _mm256_unpackhi_ps(v[2], v[3]);
+        vec t4 = _mm256_unpacklo_ps(v[4], v[5]);
+        vec t5 = _mm256_unpackhi_ps(v[4], v[5]);
+        vec t6 = _mm256_unpacklo_ps(v[6], v[7]);
+        vec t7 = _mm256_unpackhi_ps(v[6], v[7]);
+
+        vec u0 = _mm256_shuffle_ps(t0, t2, 0x44);
+        vec u1 = _mm256_shuffle_ps(t0, t2, 0xee);
+        vec u2 = _mm256_shuffle_ps(t1, t3, 0x44);
+        vec u3 = _mm256_shuffle_ps(t1, t3, 0xee);
+        vec u4 = _mm256_shuffle_ps(t4, t6, 0x44);
+        vec u5 = _mm256_shuffle_ps(t4, t6, 0xee);
+        vec u6 = _mm256_shuffle_ps(t5, t7, 0x44);
+        vec u7 = _mm256_shuffle_ps(t5, t7, 0xee);
+
+        v[0] = _mm256_permute2f128_ps(u0, u4, 0x20);
+        v[1] = _mm256_permute2f128_ps(u1, u5, 0x20);
+        v[2] = _mm256_permute2f128_ps(u2, u6, 0x20);
+        v[3] = _mm256_permute2f128_ps(u3, u7, 0x20);
+        v[4] = _mm256_permute2f128_ps(u0, u4, 0x31);
+        v[5] = _mm256_permute2f128_ps(u1, u5, 0x31);
+        v[6] = _mm256_permute2f128_ps(u2, u6, 0x31);
+        v[7] = _mm256_permute2f128_ps(u3, u7, 0x31);
+    }
+};
+
+template <> struct avx_trans<double>
+{
+    typedef __m256d vec;
+    constexpr static len_type NV = 4;
+
+    static vec set1(double x) { return _mm256_set1_pd(x); }
+    static vec load(const double* x) { return _mm256_loadu_pd(x); }
+    static void store(double* x, vec v) { _mm256_storeu_pd(x, v); }
+    static vec mul(vec a, vec b) { return _mm256_mul_pd(a, b); }
+    static vec fma(vec a, vec b, vec c) { return _mm256_fmadd_pd(a, b, c); }
+
+    static void transpose(vec (&v)[NV])
+    {
+        vec t0 = _mm256_unpacklo_pd(v[0], v[1]);
+        vec t1 = _mm256_unpackhi_pd(v[0], v[1]);
+        vec t2 = _mm256_unpacklo_pd(v[2], v[3]);
+        vec t3 = _mm256_unpackhi_pd(v[2], v[3]);
+
+        v[0] = _mm256_permute2f128_pd(t0, t2, 0x20);
+        v[1] = _mm256_permute2f128_pd(t1, t3, 0x20);
+        v[2] = _mm256_permute2f128_pd(t0, t2, 0x31);
+        v[3] = _mm256_permute2f128_pd(t1, t3, 0x31);
+    }
+};
+
+/*
+ * A full NV x NV block where A is unit-stride along one dimension and B along
+ * the other is loaded as NV vectors, transposed in registers, and stored as NV
+ * vectors. Anything else goes through the scalar loop.
+ */
+template <typename T>
+static void trans_avx(len_type m, len_type n,
+                      T alpha, bool conj_A, const T* A, stride_type rs_A, stride_type cs_A,
+                      T  beta, bool conj_B,       T* B, stride_type rs_B, stride_type cs_B)
+{
+    typedef avx_trans<T> V;
+    typedef typename V::vec vec;
+    constexpr len_type NV = V::NV;
+
+    bool row_A = (cs_A == 1 && rs_B == 1);
+    bool col_A = (rs_A == 1 && cs_B == 1);
+
+    if (m != NV || n != NV || !(row_A || col_A))
+    {
+        trans_ukr_gen(m, n, alpha, conj_A, A, rs_A, cs_A,
+                             beta, conj_B, B, rs_B, cs_B);
+        return;
+    }
+
+    stride_type s_A = (row_A ? rs_A : cs_A);
+    stride_type s_B = (row_A ? cs_B : rs_B);
+
+    vec v[NV];
+
+    for (len_type i = 0;i < NV;i++)
+        v[i] = V::load(A + i*s_A);
+
+    V::transpose(v);
+
+    vec alpha_v = V::set1(alpha);
+
+    if (beta == T(0))
+    {
+        for (len_type i = 0;i < NV;i++)
+            V::store(B + i*s_B, V::mul(alpha_v, v[i]));
+    }
+    else
+    {
+        vec beta_v = V::set1(beta);
+
+        for (len_type i = 0;i < NV;i++)
+            V::store(B + i*s_B, V::fma(beta_v, V::load(B + i*s_B),
+                                       V::mul(alpha_v, v[i])));
+    }
+}
+
+void haswell_strans_8x8(len_type m, len_type n,
+                        float alpha, bool conj_A, const float* A, stride_type rs_A, stride_type cs_A,
+                        float  beta, bool conj_B,       float* B, stride_type rs_B, stride_type cs_B)
+{
+    trans_avx(m, n, alpha, conj_A, A, rs_A, cs_A, beta, conj_B, B, rs_B, cs_B);
+}
+
+void haswell_dtrans_4x4(len_type m, len_type n,
+                        double alpha, bool conj_A, const double* A, stride_type rs_A, stride_type cs_A,
+                        double  beta, bool conj_B,       double* B, stride_type rs_B, stride_type cs_B)
+{
+    trans_avx(m, n, alpha, conj_A, A, rs_A, cs_A, beta, conj_B, B, rs_B, cs_B);
+}
+
+}
@@ -21,7 +21,7 @@ namespace tblis
 {
 
 void knl_dpackm_30xk(len_type m, len_type k,
-                     const double* p_a, stride_type rs_a, stride_type cs_a,
+                     bool conj_a, const double* p_a, stride_type rs_a, stride_type cs_a,
                      double* p_ap)
 {
     constexpr double one = 1.0;
@@ -33,12 +33,12 @@ void knl_dpackm_30xk(len_type m, len_type k,
     else
     {
         pack_nn_ukr_def<knl_d30x8_knc_config, double, matrix_constants::MAT_A>
-            (m, k, p_a, rs_a, cs_a, p_ap);
+            (m, k, conj_a, p_a, rs_a, cs_a, p_ap);
     }
 }
 
 void knl_dpackm_24xk(len_type m, len_type k,
-                     const double* p_a, stride_type rs_a, stride_type cs_a,
+                     bool conj_a, const double* p_a, stride_type rs_a, stride_type cs_a,
                      double* p_ap)
 {
     constexpr double one = 1.0;
@@ -50,12 +50,12 @@ void knl_dpackm_24xk(len_type m, len_type k,
     else
     {
         pack_nn_ukr_def<knl_d24x8_config, double, matrix_constants::MAT_A>
-            (m, k, p_a, rs_a, cs_a, p_ap);
+            (m, k, conj_a, p_a, rs_a, cs_a, p_ap);
     }
 }
 
 void knl_dpackm_8xk(len_type m, len_type k,
-                    const double* p_a, stride_type rs_a, stride_type cs_a,
+                    bool conj_a, const double* p_a, stride_type rs_a, stride_type cs_a,
                     double* p_ap)
 {
     constexpr double one = 1.0;
@@ -67,12 +67,12 @@ void knl_dpackm_8xk(len_type m, len_type k,
     else
     {
         pack_nn_ukr_def<knl_d24x8_config, double, matrix_constants::MAT_B>
-            (m, k, p_a, rs_a, cs_a, p_ap);
+            (m, k, conj_a, p_a, rs_a, cs_a, p_ap);
     }
 }
 
 void knl_spackm_24xk(len_type m, len_type k,
-                     const float* p_a, stride_type rs_a, stride_type cs_a,
+                     bool conj_a, const float* p_a, stride_type rs_a, stride_type cs_a,
                      float* p_ap)
 {
     constexpr float one = 1.0;
@@ -84,12 +84,12 @@ void knl_spackm_24xk(len_type m, len_type k,
     else
     {
         pack_nn_ukr_def<knl_d24x8_config, float, matrix_constants::MAT_A>
-            (m, k, p_a, rs_a, cs_a, p_ap);
+            (m, k, conj_a, p_a, rs_a, cs_a, p_ap);
     }
 }
 
 void knl_spackm_16xk(len_type m, len_type k,
-                     const float* p_a, stride_type rs_a, stride_type cs_a,
+                     bool conj_a, const float* p_a, stride_type rs_a, stride_type cs_a,
                      float* p_ap)
 {
     constexpr float one = 1.0;
@@ -101,7 +101,7 @@ void knl_spackm_16xk(len_type m, len_type k,
     else
     {
         pack_nn_ukr_def<knl_d24x8_config, float, matrix_constants::MAT_B>
-            (m, k, p_a, rs_a, cs_a, p_ap);
+            (m, k, conj_a, p_a, rs_a, cs_a, p_ap);
     }
 }
 
@@ -14,23 +14,41 @@ EXTERN_GEMM_UKR(double, bli_dgemm_asm_6x8);
 namespace tblis
 {
 
+EXTERN_GEMM_UKR(scomplex, skx_cgemm_6x16);
+EXTERN_GEMM_UKR(dcomplex, skx_zgemm_6x8);
+
+EXTERN_TRANS_UKR( float, skx_strans_16x16);
+EXTERN_TRANS_UKR(double, skx_dtrans_8x8);
+
+EXTERN_PACK_NN_UKR(scomplex, skx_cpackm_6xk);
+EXTERN_PACK_NN_UKR(scomplex, skx_cpackm_16xk);
+EXTERN_PACK_NN_UKR(dcomplex, skx_zpackm_6xk);
+EXTERN_PACK_NN_UKR(dcomplex, skx_zpackm_8xk);
+
 extern int skx1_check();
 
 TBLIS_BEGIN_CONFIG(skx1)
 
-    TBLIS_CONFIG_GEMM_MR(   6,    6, _, _)
-    TBLIS_CONFIG_GEMM_NR(  16,    8, _, _)
-    TBLIS_CONFIG_GEMM_KR(   8,    4, _, _)
-    TBLIS_CONFIG_GEMM_MC( 288,  144, _, _)
-    TBLIS_CONFIG_GEMM_NC(4080, 4080, _, _)
-    TBLIS_CONFIG_GEMM_KC( 256,  256, _, _)
+    TBLIS_CONFIG_GEMM_MR(   6,    6,    6,    6)
+    TBLIS_CONFIG_GEMM_NR(  16,    8,   16,    8)
+    TBLIS_CONFIG_GEMM_KR(   8,    4,    4,    2)
+    TBLIS_CONFIG_GEMM_MC( 288,  144,  144,   72)
+    TBLIS_CONFIG_GEMM_NC(4080, 4080, 4080, 4080)
+    TBLIS_CONFIG_GEMM_KC( 256,  256,  256,  256)
 
     TBLIS_CONFIG_GEMM_UKR(bli_sgemm_asm_6x16,
                           bli_dgemm_asm_6x8,
-                          _,
-                          _)
+                          skx_cgemm_6x16,
+                          skx_zgemm_6x8)
+
+    TBLIS_CONFIG_PACK_NN_MR_UKR(_, _, skx_cpackm_6xk, skx_zpackm_6xk)
+    TBLIS_CONFIG_PACK_NN_NR_UKR(_, _, skx_cpackm_16xk, skx_zpackm_8xk)
+
+    TBLIS_CONFIG_TRANS_MR(  16,    8, _, _)
+    TBLIS_CONFIG_TRANS_NR(  16,    8, _, _)
+    TBLIS_CONFIG_TRANS_UKR(skx_strans_16x16, skx_dtrans_8x8, _, _)
 
-    TBLIS_CONFIG_GEMM_ROW_MAJOR(true, true, _, _)
+    TBLIS_CONFIG_GEMM_ROW_MAJOR(true, true, true, true)
 
     TBLIS_CONFIG_CHECK(skx1_check)
 
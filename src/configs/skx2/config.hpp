@@ -24,13 +24,24 @@ EXTERN_GEMM_UKR(double, bli_dgemm_opt_8x8_l2_flip);
 namespace tblis
 {
 
+EXTERN_GEMM_UKR(scomplex, skx_cgemm_6x16);
+EXTERN_GEMM_UKR(dcomplex, skx_zgemm_6x8);
+
+EXTERN_TRANS_UKR( float, skx_strans_16x16);
+EXTERN_TRANS_UKR(double, skx_dtrans_8x8);
+
+EXTERN_PACK_NN_UKR(scomplex, skx_cpackm_6xk);
+EXTERN_PACK_NN_UKR(scomplex, skx_cpackm_16xk);
+EXTERN_PACK_NN_UKR(dcomplex, skx_zpackm_6xk);
+EXTERN_PACK_NN_UKR(dcomplex, skx_zpackm_8xk);
+
 extern int skx2_check();
 
 #define L2_BLOCK_SIZES \
-    TBLIS_CONFIG_GEMM_MC( 480,   240, _, _) \
-    TBLIS_CONFIG_GEMM_NC(3072,  3072, _, _) \
-    TBLIS_CONFIG_GEMM_KC_MAX(384, 384, _, _, \
-                             480, 480, _, _) \
+    TBLIS_CONFIG_GEMM_MC( 480,   240,  240,  120) \
+    TBLIS_CONFIG_GEMM_NC(3072,  3072, 3072, 3072) \
+    TBLIS_CONFIG_GEMM_KC_MAX(384, 384, 256, 256, \
+                             480, 480, 320, 320) \
     TBLIS_CONFIG_M_THREAD_RATIO(_,3,_,_) \
     TBLIS_CONFIG_N_THREAD_RATIO(_,2,_,_) \
     TBLIS_CONFIG_MR_MAX_THREAD(_,1,_,_) \
@@ -140,18 +151,25 @@ TBLIS_END_CONFIG
 
 TBLIS_BEGIN_CONFIG(skx_16x12_l2)
 
-    TBLIS_CONFIG_GEMM_MR(32, 16, _, _)
-    TBLIS_CONFIG_GEMM_NR(12, 12, _, _)
-    TBLIS_CONFIG_GEMM_KR(16,  8, _, _)
+    TBLIS_CONFIG_GEMM_MR(32, 16,  6,  6)
+    TBLIS_CONFIG_GEMM_NR(12, 12, 16,  8)
+    TBLIS_CONFIG_GEMM_KR(16,  8,  4,  2)
     L2_BLOCK_SIZES
 
     TBLIS_CONFIG_GEMM_UKR(bli_sgemm_opt_12x32_l2,
                           bli_dgemm_opt_12x16_l2,
-                          _,
-                          _)
+                          skx_cgemm_6x16,
+                          skx_zgemm_6x8)
+
+    TBLIS_CONFIG_PACK_NN_MR_UKR(_, _, skx_cpackm_6xk, skx_zpackm_6xk)
+    TBLIS_CONFIG_PACK_NN_NR_UKR(_, _, skx_cpackm_16xk, skx_zpackm_8xk)
+
+    TBLIS_CONFIG_TRANS_MR(  16,    8, _, _)
+    TBLIS_CONFIG_TRANS_NR(  16,    8, _, _)
+    TBLIS_CONFIG_TRANS_UKR(skx_strans_16x16, skx_dtrans_8x8, _, _)
 
-    TBLIS_CONFIG_GEMM_ROW_MAJOR(false, false, _, _)
-    TBLIS_CONFIG_GEMM_FLIP_UKR(true, true, _, _)
+    TBLIS_CONFIG_GEMM_ROW_MAJOR(false, false, true, true)
+    TBLIS_CONFIG_GEMM_FLIP_UKR(true, true, false, false)
 
     TBLIS_CONFIG_CHECK(skx2_check)
 
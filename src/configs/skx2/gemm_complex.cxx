@@ -0,0 +1,231 @@
+#include "config.hpp"
+#include "configs/haswell/packm_complex.hpp"
+
+#include <immintrin.h>
+
+namespace tblis
+{
+
+template <typename T> struct avx512_complex;
+
+template <> struct avx512_complex<scomplex>
+{
+    typedef __m512 vec;
+    constexpr static len_type NC = 8;
+
+    static vec zero() { return _mm512_setzero_ps(); }
+    static vec set1(float x) { return _mm512_set1_ps(x); }
+    static vec load(const scomplex* x) { return _mm512_loadu_ps((const float*)x); }
+    static void store(scomplex* x, vec v) { _mm512_storeu_ps((float*)x, v); }
+    static vec fma(vec a, vec b, vec c) { return _mm512_fmadd_ps(a, b, c); }
+    static vec fmaddsub(vec a, vec b, vec c) { return _mm512_fmaddsub_ps(a, b, c); }
+    static vec mul(vec a, vec b) { return _mm512_mul_ps(a, b); }
+    static vec add(vec a, vec b) { return _mm512_add_ps(a, b); }
+    static vec swap(vec a) { return _mm512_permute_ps(a, 0xb1); }
+};
+
+template <> struct avx512_complex<dcomplex>
+{
+    typedef __m512d vec;
+    constexpr static len_type NC = 4;
+
+    static vec zero() { return _mm512_setzero_pd(); }
+    static vec set1(double x) { return _mm512_set1_pd(x); }
+    static vec load(const dcomplex* x) { return _mm512_loadu_pd((const double*)x); }
+    static void store(dcomplex* x, vec v) { _mm512_storeu_pd((double*)x, v); }
+    static vec fma(vec a, vec b, vec c) { return _mm512_fmadd_pd(a, b, c); }
+    static vec fmaddsub(vec a, vec b, vec c) { return _mm512_fmaddsub_pd(a, b, c); }
+    static vec mul(vec a, vec b) { return _mm512_mul_pd(a, b); }
+    static vec add(vec a, vec b) { return _mm512_add_pd(a, b); }
+    static vec swap(vec a) { return _mm512_permute_pd(a, 0x55); }
+};
+
+/*
+ * Same algorithm as the AVX2 kernel in configs/haswell/gemm_complex.cxx.
+ * There is no addsub instruction in AVX-512, so the real and imaginary
+ * accumulators are combined with fmaddsub(ab_r, 1, swap(ab_i)) instead.
+ */
+template <typename T, len_type MR, len_type NR>
+static void gemm_complex_avx512_row(stride_type k,
+                                    const T* TBLIS_RESTRICT alpha,
+                                    const T* TBLIS_RESTRICT p_a, const T* TBLIS_RESTRICT p_b,
+                                    const T* TBLIS_RESTRICT beta,
+                                    T* TBLIS_RESTRICT p_c, stride_type rs_c)
+{
+    typedef avx512_complex<T> V;
+    typedef typename V::vec vec;
+    typedef typename T::value_type U;
+    constexpr len_type NV = NR/V::NC;
+
+    static_assert(NR%V::NC == 0, "NR must be a multiple of the vector length");
+
+    vec ab_r[MR][NV], ab_i[MR][NV];
+
+    TBLIS_UNROLL
+    for (len_type i = 0;i < MR;i++)
+    {
+        TBLIS_UNROLL
+        for (len_type v = 0;v < NV;v++)
+        {
+            ab_r[i][v] = V::zero();
+            ab_i[i][v] = V::zero();
+        }
+
+        _mm_prefetch((const char*)(p_c + i*rs_c), _MM_HINT_T0);
+    }
+
+    while (k --> 0)
+    {
+        vec b[NV];
+
+        TBLIS_UNROLL
+        for (len_type v = 0;v < NV;v++)
+            b[v] = V::load(p_b + v*V::NC);
+
+        _mm_prefetch((const char*)(p_b + 8*NR), _MM_HINT_T0);
+
+        TBLIS_UNROLL
+        for (len_type i = 0;i < MR;i++)
+        {
+            vec a_r = V::set1(((const U*)(p_a + i))[0]);
+            vec a_i = V::set1(((const U*)(p_a + i))[1]);
+
+            TBLIS_UNROLL
+            for (len_type v = 0;v < NV;v++)
+            {
+                ab_r[i][v] = V::fma(a_r, b[v], ab_r[i][v]);
+                ab_i[i][v] = V::fma(a_i, b[v], ab_i[i][v]);
+            }
+        }
+
+        p_a += MR;
+        p_b += NR;
+    }
+
+    vec one = V::set1(U(1));
+    vec alpha_r = V::set1(alpha->real());
+    vec alpha_i = V::set1(alpha->imag());
+
+    vec ab[MR][NV];
+
+    TBLIS_UNROLL
+    for (len_type i = 0;i < MR;i++)
+    {
+        TBLIS_UNROLL
+        for (len_type v = 0;v < NV;v++)
+        {
+            vec tmp = V::fmaddsub(ab_r[i][v], one, V::swap(ab_i[i][v]));
+            ab[i][v] = V::fmaddsub(tmp, alpha_r, V::mul(V::swap(tmp), alpha_i));
+        }
+    }
+
+    if (*beta == T(0))
+    {
+        TBLIS_UNROLL
+        for (len_type i = 0;i < MR;i++)
+            TBLIS_UNROLL
+            for (len_type v = 0;v < NV;v++)
+                V::store(p_c + i*rs_c + v*V::NC, ab[i][v]);
+    }
+    else
+    {
+        vec beta_r = V::set1(beta->real());
+        vec beta_i = V::set1(beta->imag());
+
+        TBLIS_UNROLL
+        for (len_type i = 0;i < MR;i++)
+        {
+            TBLIS_UNROLL
+            for (len_type v = 0;v < NV;v++)
+            {
+                vec c = V::load(p_c + i*rs_c + v*V::NC);
+                c = V::fmaddsub(c, beta_r, V::mul(V::swap(c), beta_i));
+                V::store(p_c + i*rs_c + v*V::NC, V::add(c, ab[i][v]));
+            }
+        }
+    }
+}
+
+template <typename T, len_type MR, len_type NR>
+static void gemm_complex_avx512(stride_type k,
+                                const T* TBLIS_RESTRICT alpha,
+                                const T* TBLIS_RESTRICT p_a, const T* TBLIS_RESTRICT p_b,
+                                const T* TBLIS_RESTRICT beta,
+                                T* TBLIS_RESTRICT p_c, stride_type rs_c, stride_type cs_c)
+{
+    if (cs_c == 1)
+    {
+        gemm_complex_avx512_row<T,MR,NR>(k, alpha, p_a, p_b, beta, p_c, rs_c);
+    }
+    else
+    {
+        T p_ab[MR*NR] __attribute__((aligned(64)));
+        static const T zero = T(0);
+
+        gemm_complex_avx512_row<T,MR,NR>(k, alpha, p_a, p_b, &zero, p_ab, NR);
+
+        if (*beta == T(0))
+        {
+            for (len_type i = 0;i < MR;i++)
+                for (len_type j = 0;j < NR;j++)
+                    p_c[i*rs_c + j*cs_c] = p_ab[i*NR + j];
+        }
+        else
+        {
+            for (len_type i = 0;i < MR;i++)
+                for (len_type j = 0;j < NR;j++)
+                    p_c[i*rs_c + j*cs_c] = p_ab[i*NR + j] +
+                                           (*beta)*p_c[i*rs_c + j*cs_c];
+        }
+    }
+}
+
+void skx_cgemm_6x16(stride_type k,
+                    const scomplex* alpha,
+                    const scomplex* a, const scomplex* b,
+                    const scomplex* beta,
+                    scomplex* c, stride_type rs_c, stride_type cs_c,
+                    auxinfo_t*)
+{
+    gemm_complex_avx512<scomplex, 6, 16>(k, alpha, a, b, beta, c, rs_c, cs_c);
+}
+
+void skx_zgemm_6x8(stride_type k,
+                   const dcomplex* alpha,
+                   const dcomplex* a, const dcomplex* b,
+                   const dcomplex* beta,
+                   dcomplex* c, stride_type rs_c, stride_type cs_c,
+                   auxinfo_t*)
+{
+    gemm_complex_avx512<dcomplex, 6, 8>(k, alpha, a, b, beta, c, rs_c, cs_c);
+}
+
+void skx_cpackm_6xk(len_type m, len_type k,
+                    bool conj_a, const scomplex* p_a, stride_type rs_a, stride_type cs_a,
+                    scomplex* p_ap)
+{
+    pack_complex<scomplex, 6>(m, k, conj_a, p_a, rs_a, cs_a, p_ap);
+}
+
+void skx_cpackm_16xk(len_type m, len_type k,
+                     bool conj_a, const scomplex* p_a, stride_type rs_a, stride_type cs_a,
+                     scomplex* p_ap)
+{
+    pack_complex<scomplex, 16>(m, k, conj_a, p_a, rs_a, cs_a, p_ap);
+}
+
+void skx_zpackm_6xk(len_type m, len_type k,
+                    bool conj_a, const dcomplex* p_a, stride_type rs_a, stride_type cs_a,
+                    dcomplex* p_ap)
+{
+    pack_complex<dcomplex, 6>(m, k, conj_a, p_a, rs_a, cs_a, p_ap);
+}
+
+void skx_zpackm_8xk(len_type m, len_type k,
+                    bool conj_a, const dcomplex* p_a, stride_type rs_a, stride_type cs_a,
+                    dcomplex* p_ap)
+{
+    pack_complex<dcomplex, 8>(m, k, conj_a, p_a, rs_a, cs_a, p_ap);
+}
+
+}
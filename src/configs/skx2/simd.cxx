@@ -0,0 +1,92 @@
+#include "config.hpp"
+
+#include "kernels/1v/simd.hpp"
+
+#include <immintrin.h>
+
+namespace tblis
+{
+
+/*
+ * Only AVX-512F instructions are used here.
+ */
+template <typename T> struct avx512_1v;
+
+template <> struct avx512_1v<float>
+{
+    typedef __m512 vec;
+    constexpr static len_type NR = 16;
+
+    static vec zero() { return _mm512_setzero_ps(); }
+    static vec set1(float x) { return _mm512_set1_ps(x); }
+    static vec set2(float x, float y) { return _mm512_setr4_ps(x, y, x, y); }
+    static vec load(const float* x) { return _mm512_loadu_ps(x); }
+    static void store(float* x, vec v) { _mm512_storeu_ps(x, v); }
+    static vec add(vec a, vec b) { return _mm512_add_ps(a, b); }
+    static vec mul(vec a, vec b) { return _mm512_mul_ps(a, b); }
+    static vec fma(vec a, vec b, vec c) { return _mm512_fmadd_ps(a, b, c); }
+    static vec fmaddsub(vec a, vec b, vec c) { return _mm512_fmaddsub_ps(a, b, c); }
+    static vec max(vec a, vec b) { return _mm512_max_ps(a, b); }
+    static vec min(vec a, vec b) { return _mm512_min_ps(a, b); }
+    static vec sqrt(vec a) { return _mm512_sqrt_ps(a); }
+    static vec abs(vec a) { return _mm512_abs_ps(a); }
+    static vec swap(vec a) { return _mm512_permute_ps(a, 0xb1); }
+    static vec dup_even(vec a) { return _mm512_moveldup_ps(a); }
+    static vec dup_odd(vec a) { return _mm512_movehdup_ps(a); }
+    static vec blend_odd(vec a, vec b) { return _mm512_mask_blend_ps(0xaaaa, a, b); }
+
+    static vec conj(vec a)
+    {
+        return _mm512_castsi512_ps(_mm512_xor_si512(_mm512_castps_si512(a),
+                                                    _mm512_castps_si512(set2(0.0f, -0.0f))));
+    }
+
+    static int first_eq(vec a, vec b)
+    {
+        int mask = _mm512_cmp_ps_mask(a, b, _CMP_EQ_OQ);
+        return mask ? __builtin_ctz(mask) : -1;
+    }
+};
+
+template <> struct avx512_1v<double>
+{
+    typedef __m512d vec;
+    constexpr static len_type NR = 8;
+
+    static vec zero() { return _mm512_setzero_pd(); }
+    static vec set1(double x) { return _mm512_set1_pd(x); }
+    static vec set2(double x, double y) { return _mm512_setr4_pd(x, y, x, y); }
+    static vec load(const double* x) { return _mm512_loadu_pd(x); }
+    static void store(double* x, vec v) { _mm512_storeu_pd(x, v); }
+    static vec add(vec a, vec b) { return _mm512_add_pd(a, b); }
+    static vec mul(vec a, vec b) { return _mm512_mul_pd(a, b); }
+    static vec fma(vec a, vec b, vec c) { return _mm512_fmadd_pd(a, b, c); }
+    static vec fmaddsub(vec a, vec b, vec c) { return _mm512_fmaddsub_pd(a, b, c); }
+    static vec max(vec a, vec b) { return _mm512_max_pd(a, b); }
+    static vec min(vec a, vec b) { return _mm512_min_pd(a, b); }
+    static vec sqrt(vec a) { return _mm512_sqrt_pd(a); }
+    static vec abs(vec a) { return _mm512_abs_pd(a); }
+    static vec swap(vec a) { return _mm512_permute_pd(a, 0x55); }
+    static vec dup_even(vec a) { return _mm512_movedup_pd(a); }
+    static vec dup_odd(vec a) { return _mm512_permute_pd(a, 0xff); }
+    static vec blend_odd(vec a, vec b) { return _mm512_mask_blend_pd(0xaa, a, b); }
+
+    static vec conj(vec a)
+    {
+        return _mm512_castsi512_pd(_mm512_xor_si512(_mm512_castpd_si512(a),
+                                                    _mm512_castpd_si512(set2(0.0, -0.0))));
+    }
+
+    static int first_eq(vec a, vec b)
+    {
+        int mask = _mm512_cmp_pd_mask(a, b, _CMP_EQ_OQ);
+        return mask ? __builtin_ctz(mask) : -1;
+    }
+};
+
+TBLIS_SIMD_1V_UKRS(skx_s, avx512_1v<float>,    float)
+TBLIS_SIMD_1V_UKRS(skx_d, avx512_1v<double>,   double)
+TBLIS_SIMD_1V_UKRS(skx_c, avx512_1v<float>,  scomplex)
+TBLIS_SIMD_1V_UKRS(skx_z, avx512_1v<double>, dcomplex)
+
+}
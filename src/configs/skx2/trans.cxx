@@ -0,0 +1,165 @@
+#include "config.hpp"
+
+#include <immintrin.h>
+
+namespace tblis
+{
+
+template <typename T> struct avx512_trans;
+
+template <> struct avx512_trans<float>
+{
+    typedef __m512 vec;
+    constexpr static len_type NV = 16;
+
+    static vec set1(float x) { return _mm512_set1_ps(x); }
+    static vec load(const float* x) { return _mm512_loadu_ps(x); }
+    static void store(float* x, vec v) { _mm512_storeu_ps(x, v); }
+    static vec mul(vec a, vec b) { return _mm512_mul_ps(a, b); }
+    static vec fma(vec a, vec b, vec c) { return _mm512_fmadd_ps(a, b, c); }
+
+    static void transpose(vec (&v)[NV])
+    {
+        vec t[16], u[16];
+
+        /*
+         * Interleave pairs of rows, then pairs of pairs, so that each 128-bit
+         * lane holds one element of four consecutive rows.
+         */
+        for (int i = 0;i < 16;i += 2)
+        {
+            t[i  ] = _mm512_unpacklo_ps(v[i], v[i+1]);
+            t[i+1] = _mm512_unpackhi_ps(v[i], v[i+1]);
+        }
+
+        for (int i = 0;i < 16;i += 4)
+        {
+            u[i  ] = _mm512_shuffle_ps(t[i  ], t[i+2], 0x44);
+            u[i+1] = _mm512_shuffle_ps(t[i  ], t[i+2], 0xee);
+            u[i+2] = _mm512_shuffle_ps(t[i+1], t[i+3], 0x44);
+            u[i+3] = _mm512_shuffle_ps(t[i+1], t[i+3], 0xee);
+        }
+
+        /*
+         * Then gather the lanes.
+         */
+        for (int i = 0;i < 4;i++)
+        {
+            t[i   ] = _mm512_shuffle_f32x4(u[i  ], u[i+ 4], 0x88);
+            t[i+ 4] = _mm512_shuffle_f32x4(u[i  ], u[i+ 4], 0xdd);
+            t[i+ 8] = _mm512_shuffle_f32x4(u[i+8], u[i+12], 0x88);
+            t[i+12] = _mm512_shuffle_f32x4(u[i+8], u[i+12], 0xdd);
+        }
+
+        for (int i = 0;i < 8;i++)
+        {
+            v[i  ] = _mm512_shuffle_f32x4(t[i], t[i+8], 0x88);
+            v[i+8] = _mm512_shuffle_f32x4(t[i], t[i+8], 0xdd);
+        }
+    }
+};
+
+template <> struct avx512_trans<double>
+{
+    typedef __m512d vec;
+    constexpr static len_type NV = 8;
+
+    static vec set1(double x) { return _mm512_set1_pd(x); }
+    static vec load(const double* x) { return _mm512_loadu_pd(x); }
+    static void store(double* x, vec v) { _mm512_storeu_pd(x, v); }
+    static vec mul(vec a, vec b) { return _mm512_mul_pd(a, b); }
+    static vec fma(vec a, vec b, vec c) { return _mm512_fmadd_pd(a, b, c); }
+
+    static void transpose(vec (&v)[NV])
+    {
+        vec t[8], u[8];
+
+        for (int i = 0;i < 8;i += 2)
+        {
+            t[i  ] = _mm512_unpacklo_pd(v[i], v[i+1]);
+            t[i+1] = _mm512_unpackhi_pd(v[i], v[i+1]);
+        }
+
+        for (int i = 0;i < 8;i += 4)
+        {
+            u[i  ] = _mm512_shuffle_f64x2(t[i  ], t[i+2], 0x88);
+            u[i+1] = _mm512_shuffle_f64x2(t[i  ], t[i+2], 0xdd);
+            u[i+2] = _mm512_shuffle_f64x2(t[i+1], t[i+3], 0x88);
+            u[i+3] = _mm512_shuffle_f64x2(t[i+1], t[i+3], 0xdd);
+        }
+
+        v[0] = _mm512_shuffle_f64x2(u[0], u[4], 0x88);
+        v[4] = _mm512_shuffle_f64x2(u[0], u[4], 0xdd);
+        v[2] = _mm512_shuffle_f64x2(u[1], u[5], 0x88);
+        v[6] = _mm512_shuffle_f64x2(u[1], u[5], 0xdd);
+        v[1] = _mm512_shuffle_f64x2(u[2], u[6], 0x88);
+        v[5] = _mm512_shuffle_f64x2(u[2], u[6], 0xdd);
+        v[3] = _mm512_shuffle_f64x2(u[3], u[7], 0x88);
+        v[7] = _mm512_shuffle_f64x2(u[3], u[7], 0xdd);
+    }
+};
+
+/*
+ * Same algorithm as the AVX kernel in configs/haswell/trans.cxx.
+ */
+template <typename T>
+static void trans_avx512(len_type m, len_type n,
+                         T alpha, bool conj_A, const T* A, stride_type rs_A, stride_type cs_A,
+                         T  beta, bool conj_B,       T* B, stride_type rs_B, stride_type cs_B)
+{
+    typedef avx512_trans<T> V;
+    typedef typename V::vec vec;
+    constexpr len_type NV = V::NV;
+
+    bool row_A = (cs_A == 1 && rs_B == 1);
+    bool col_A = (rs_A == 1 && cs_B == 1);
+
+    if (m != NV || n != NV || !(row_A || col_A))
+    {
+        trans_ukr_gen(m, n, alpha, conj_A, A, rs_A, cs_A,
+                             beta, conj_B, B, rs_B, cs_B);
+        return;
+    }
+
+    stride_type s_A = (row_A ? rs_A : cs_A);
+    stride_type s_B = (row_A ? cs_B : rs_B);
+
+    vec v[NV];
+
+    for (len_type i = 0;i < NV;i++)
+        v[i] = V::load(A + i*s_A);
+
+    V::transpose(v);
+
+    vec alpha_v = V::set1(alpha);
+
+    if (beta == T(0))
+    {
+        for (len_type i = 0;i < NV;i++)
+            V::store(B + i*s_B, V::mul(alpha_v, v[i]));
+    }
+    else
+    {
+        vec beta_v = V::set1(beta);
+
+        for (len_type i = 0;i < NV;i++)
+            V::store(B + i*s_B, V::fma(beta_v, V::load(B + i*s_B),
+                                       V::mul(alpha_v, v[i])));
+    }
+}
+
+void skx_strans_16x16(len_type m, len_type n,
+                      float alpha, bool conj_A, const float* A, stride_type rs_A, stride_type cs_A,
+                      float  beta, bool conj_B,       float* B, stride_type rs_B, stride_type cs_B)
+{
+    trans_avx512(m, n, alpha, conj_A, A, rs_A, cs_A, beta, conj_B, B, rs_B, cs_B);
+}
+
+void skx_dtrans_8x8(len_type m, len_type n,
+                    double alpha, bool conj_A, const double* A, stride_type rs_A, stride_type cs_A,
+                    double  beta, bool conj_B,       double* B, stride_type rs_B, stride_type cs_B)
+{
+    trans_avx512(m, n, alpha, conj_A, A, rs_A, cs_A, beta, conj_B, B, rs_B, cs_B);
+}
+
+}
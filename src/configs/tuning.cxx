@@ -0,0 +1,215 @@
+#include "tuning.hpp"
+
+#include "util/cpuid.hpp"
+#include "util/env.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+namespace tblis
+{
+
+namespace
+{
+
+const char type_chars[] = "sdcz";
+
+len_type round_up(len_type x, len_type r)
+{
+    return std::max(r, ((x+r-1)/r)*r);
+}
+
+void set_blocksize(blocksize& bs, int idx, len_type value)
+{
+    len_type value_r = round_up(value, bs._iota[idx]);
+    len_type over = bs._max[idx]-bs._def[idx];
+    bs._def[idx] = value_r;
+    bs._max[idx] = value_r+over;
+    bs._extent[idx] = value_r;
+}
+
+void set_tuning(config& cfg, int idx, const tuning& t)
+{
+    set_blocksize(cfg.gemm_mc, idx, t.mc);
+    set_blocksize(cfg.gemm_nc, idx, t.nc);
+    set_blocksize(cfg.gemm_kc, idx, t.kc);
+    cfg.m_thread_ratio._val[idx] = std::max(1u, t.m_thread_ratio);
+    cfg.n_thread_ratio._val[idx] = std::max(1u, t.n_thread_ratio);
+    cfg.mr_max_thread._val[idx] = std::max(1u, t.mr_max_thread);
+    cfg.nr_max_thread._val[idx] = std::max(1u, t.nr_max_thread);
+}
+
+struct tuning_entry
+{
+    std::string machine;
+    std::string config;
+    char type;
+    tuning params;
+};
+
+bool parse_entry(const std::string& line, tuning_entry& entry)
+{
+    std::istringstream is(line);
+    is >> entry.machine;
+
+    if (entry.machine.empty() || entry.machine[0] == '#') return false;
+
+    auto& t = entry.params;
+    is >> entry.config >> entry.type >> t.mc >> t.nc >> t.kc
+       >> t.m_thread_ratio >> t.n_thread_ratio
+       >> t.mr_max_thread >> t.nr_max_thread;
+
+    return !is.fail();
+}
+
+}
+
+template <typename T>
+tuning get_tuning(const config& cfg)
+{
+    return {cfg.gemm_mc.def<T>(), cfg.gemm_nc.def<T>(), cfg.gemm_kc.def<T>(),
+            cfg.m_thread_ratio.value<T>(), cfg.n_thread_ratio.value<T>(),
+            cfg.mr_max_thread.value<T>(), cfg.nr_max_thread.value<T>()};
+}
+
+template <typename T>
+void set_tuning(config& cfg, const tuning& t)
+{
+    set_tuning(cfg, type_idx<T>::value, t);
+}
+
+std::string machine_name()
+{
+    std::ostringstream os;
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386) || defined(_M_IX86)
+
+    int family, model, features;
+    int vendor = get_cpu_type(family, model, features);
+
+    os << (vendor == VENDOR_INTEL ? "intel" :
+           vendor == VENDOR_AMD   ? "amd"   : "unknown")
+       << '-' << family << '-' << model;
+
+#else
+
+    os << "unknown";
+
+#endif
+
+    os << '-' << std::thread::hardware_concurrency();
+
+    return os.str();
+}
+
+std::string tuning_file()
+{
+    const char* file = getenv("TBLIS_TUNING_FILE");
+    if (file) return file;
+
+    const char* home = getenv("HOME");
+    if (home) return std::string(home) + "/.tblis_tuning";
+
+    return "";
+}
+
+bool load_tuning(config& cfg, const std::string& file)
+{
+    if (file.empty()) return false;
+
+    std::ifstream ifs(file);
+    if (!ifs) return false;
+
+    auto machine = machine_name();
+    bool found = false;
+
+    std::string line;
+    while (std::getline(ifs, line))
+    {
+        tuning_entry entry;
+        if (!parse_entry(line, entry) ||
+            entry.machine != machine ||
+            entry.config != cfg.name) continue;
+
+        auto type = std::find(type_chars, type_chars+4, entry.type);
+        if (type == type_chars+4) continue;
+
+        set_tuning(cfg, type-type_chars, entry.params);
+        found = true;
+
+        if (get_verbose() >= 1)
+        {
+            printf("tblis: Using tuned parameters for %s (%c): "
+                   "MC=%ld NC=%ld KC=%ld\n", cfg.name, entry.type,
+                   (long)entry.params.mc, (long)entry.params.nc,
+                   (long)entry.params.kc);
+        }
+    }
+
+    return found;
+}
+
+template <typename T>
+void save_tuning(const config& cfg, const std::string& file)
+{
+    if (file.empty()) return;
+
+    auto machine = machine_name();
+    char type = type_chars[type_idx<T>::value];
+    std::vector<std::string> lines;
+
+    {
+        std::ifstream ifs(file);
+        std::string line;
+        while (std::getline(ifs, line))
+        {
+            tuning_entry entry;
+            if (parse_entry(line, entry) &&
+                entry.machine == machine &&
+                entry.config == cfg.name &&
+                entry.type == type) continue;
+
+            lines.push_back(line);
+        }
+    }
+
+    auto t = get_tuning<T>(cfg);
+
+    std::ostringstream os;
+    os << machine << ' ' << cfg.name << ' ' << type << ' '
+       << t.mc << ' ' << t.nc << ' ' << t.kc << ' '
+       << t.m_thread_ratio << ' ' << t.n_thread_ratio << ' '
+       << t.mr_max_thread << ' ' << t.nr_max_thread;
+    lines.push_back(os.str());
+
+    /*
+     * Write to a temporary file first so that concurrent readers never see
+     * a partially written file.
+     */
+    auto tmp = file + ".tmp";
+
+    {
+        std::ofstream ofs(tmp);
+        if (!ofs)
+            tblis_abort_with_message(nullptr,
+                "tblis: Could not write tuning file %s!", tmp.c_str());
+
+        for (auto& line : lines) ofs << line << '\n';
+    }
+
+    if (rename(tmp.c_str(), file.c_str()) != 0)
+        tblis_abort_with_message(nullptr,
+            "tblis: Could not write tuning file %s!", file.c_str());
+}
+
+#define FOREACH_TYPE(T) \
+template tuning get_tuning<T>(const config& cfg); \
+template void set_tuning<T>(config& cfg, const tuning& t); \
+template void save_tuning<T>(const config& cfg, const std::string& file);
+#include "configs/foreach_type.h"
+
+}
@@ -0,0 +1,62 @@
+#ifndef _TBLIS_CONFIGS_TUNING_HPP_
+#define _TBLIS_CONFIGS_TUNING_HPP_
+
+#include "configs.hpp"
+
+#include <string>
+
+namespace tblis
+{
+
+/*
+ * The parameters of a configuration which can be changed at runtime without
+ * affecting correctness: the cache blocksizes and the thread partitioning
+ * of the GEMM loops.
+ */
+struct tuning
+{
+    len_type mc, nc, kc;
+    unsigned m_thread_ratio, n_thread_ratio;
+    unsigned mr_max_thread, nr_max_thread;
+};
+
+template <typename T>
+tuning get_tuning(const config& cfg);
+
+/*
+ * Set the tuning parameters for type T. The cache blocksizes are rounded up
+ * to multiples of the corresponding register blocksizes.
+ */
+template <typename T>
+void set_tuning(config& cfg, const tuning& t);
+
+/*
+ * A string identifying the kind of machine we are running on (CPU model and
+ * number of hardware threads), so that one tuning file can be shared
+ * between different machines.
+ */
+std::string machine_name();
+
+/*
+ * The location of the tuning file: $TBLIS_TUNING_FILE if set, otherwise
+ * $HOME/.tblis_tuning. An empty string means that no file should be used.
+ */
+std::string tuning_file();
+
+/*
+ * Apply all entries in the tuning file which match cfg and this machine.
+ * Returns true if any parameters were changed.
+ */
+bool load_tuning(config& cfg, const std::string& file = tuning_file());
+
+/*
+ * Store the tuning parameters for type T of cfg in the tuning file,
+ * replacing any previous entry for the same machine, configuration, and
+ * type.
+ */
+template <typename T>
+void save_tuning(const config& cfg, const std::string& file = tuning_file());
+
+}
+
+#endif
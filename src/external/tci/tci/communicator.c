@@ -86,11 +86,17 @@ int tci_comm_bcast_nowait(tci_comm* comm, void** object, unsigned root)
 
 int tci_comm_gang(tci_comm* parent, tci_comm* child,
                   int type, unsigned n, unsigned bs)
+{
+    return tci_comm_gang_ranked(parent, child, type, n, bs, parent->tid);
+}
+
+int tci_comm_gang_ranked(tci_comm* parent, tci_comm* child,
+                         int type, unsigned n, unsigned bs, unsigned rank)
 {
     unsigned nt = parent->nthread;
-    unsigned tid = parent->tid;
+    unsigned tid = rank;
 
-    if (n == 1) return tci_comm_init(child, parent->context, nt, tid, 1, 0);
+    if (n == 1) return tci_comm_init(child, parent->context, nt, parent->tid, 1, 0);
     if (n >= nt) return tci_comm_init(child, NULL, 1, 0, nt, tid);
 
     unsigned new_tid = 0;
@@ -68,6 +68,15 @@ int tci_comm_bcast_nowait(tci_comm* comm, void** object, unsigned root);
 int tci_comm_gang(tci_comm* parent, tci_comm* child,
                   int type, unsigned n, unsigned bs);
 
+/*
+ * Same as tci_comm_gang, except that threads are placed into gangs as if the
+ * calling thread had thread number rank. The ranks of all threads must be a
+ * permutation of 0...nthread-1. This allows, for example, threads which
+ * share a NUMA domain to be placed in the same gang.
+ */
+int tci_comm_gang_ranked(tci_comm* parent, tci_comm* child,
+                         int type, unsigned n, unsigned bs, unsigned rank);
+
 void tci_comm_distribute_over_gangs(tci_comm* comm, tci_range range,
                                     tci_range_func func, void* payload);
 
@@ -187,16 +196,30 @@ class communicator
 
                 template <typename Func>
                 void visit(unsigned task, Func&& func)
+                {
+                    visit(task, 1, std::forward<Func>(func));
+                }
+
+                /*
+                 * The task may not run until the task set is destroyed, and
+                 * may run on a different thread, so func must capture any
+                 * per-task state by value.
+                 */
+                template <typename Func>
+                void visit(unsigned task, uint64_t work, Func&& func)
                 {
                     typedef typename std::decay<Func>::type RealFunc;
                     RealFunc* payload = new RealFunc(std::forward<Func>(func));
-                    tci_task_set_visit(&_tasks,
-                    [](tci_comm* comm, unsigned, void* payload_)
+                    if (tci_task_set_visit_work(&_tasks,
+                        [](tci_comm* comm, unsigned, void* payload_)
+                        {
+                            RealFunc* payload = (RealFunc*)payload_;
+                            (*payload)(*reinterpret_cast<const communicator*>(comm));
+                            delete payload;
+                        }, task, work, payload) != 0)
                     {
-                        RealFunc* payload = (RealFunc*)payload_;
-                        (*payload)(*reinterpret_cast<const communicator*>(comm));
                         delete payload;
-                    }, task, payload);
+                    }
                 }
 
             protected:
@@ -319,6 +342,14 @@ class communicator
             return child;
         }
 
+        communicator gang(int type, unsigned n, unsigned bs, unsigned rank) const
+        {
+            communicator child;
+            int ret = tci_comm_gang_ranked(*this, &child._comm, type, n, bs, rank);
+            if (ret != 0) throw std::system_error(ret, std::system_category());
+            return child;
+        }
+
         template <typename Func>
         void distribute_over_gangs(const tci_range& n, Func&& func) const
         {
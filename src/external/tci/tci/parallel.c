@@ -1,9 +1,20 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
 #include "parallel.h"
+#include "yield.h"
 
 #include <stdlib.h>
+#include <string.h>
+#include <limits.h>
 #include <math.h>
 #include <assert.h>
 
+#if TCI_USE_PTHREADS_THREADS && defined(__linux__)
+#include <sched.h>
+#endif
+
 #if TCI_USE_OPENMP_THREADS
 
 int tci_parallelize(tci_thread_func func, void* payload,
@@ -66,15 +77,14 @@ void* tci_run_thread(void* raw_data)
     return NULL;
 }
 
-int tci_parallelize(tci_thread_func func, void* payload,
-                    unsigned nthread, unsigned arity)
+/*
+ * Create and join a fresh set of threads. This is only used when the
+ * persistent pool is not available, i.e. when tci_parallelize is called
+ * concurrently from several threads or from within a parallel region.
+ */
+static int tci_parallelize_spawn(tci_thread_func func, void* payload,
+                                 unsigned nthread, unsigned arity)
 {
-    if (nthread <= 1)
-    {
-        func(tci_single, payload);
-        return 0;
-    }
-
     tci_context* context;
     int ret = tci_context_init(&context, nthread, arity);
     if (ret != 0) return ret;
@@ -110,6 +120,307 @@ int tci_parallelize(tci_thread_func func, void* payload,
     return tci_comm_destroy(&comm0);
 }
 
+/*
+ * Worker threads are kept alive between calls to tci_parallelize. Worker i
+ * always plays the role of thread i+1, and is pinned to the (i+1)-th CPU of
+ * the process affinity mask (set TCI_PIN_THREADS=0 to disable).
+ *
+ * A new parallel region is published by bumping the job word, which holds a
+ * sequence number in the upper 32 bits and the number of threads in the lower
+ * 32 bits so that a worker can tell whether it takes part from a single load.
+ * Idle workers spin on the job word for a while and then sleep on a condition
+ * variable, according to the idle policy.
+ */
+
+#define TCI_DEFAULT_SPIN_COUNT 10000
+
+typedef struct
+{
+    pthread_mutex_t busy;
+    pthread_mutex_t mutex;
+    pthread_cond_t wake;
+    pthread_cond_t done;
+
+    uint64_t job;
+    unsigned pending;
+    unsigned nsleeping;
+    unsigned nworker;
+
+    tci_thread_func func;
+    void* payload;
+    tci_context* context;
+
+    int policy;
+    unsigned spin_count;
+    bool pin;
+
+#if defined(__linux__) && defined(CPU_SET)
+    cpu_set_t cpus;
+    unsigned ncpu;
+#endif
+} tci_thread_pool;
+
+typedef struct
+{
+    unsigned tid;
+    uint64_t job;
+} tci_pool_worker_data;
+
+static tci_thread_pool tci_pool =
+{
+    .busy = PTHREAD_MUTEX_INITIALIZER,
+    .mutex = PTHREAD_MUTEX_INITIALIZER,
+    .wake = PTHREAD_COND_INITIALIZER,
+    .done = PTHREAD_COND_INITIALIZER
+};
+
+static pthread_once_t tci_pool_once = PTHREAD_ONCE_INIT;
+
+static void tci_pool_after_fork(void)
+{
+    /*
+     * Only the forking thread survives in the child, so the workers are gone.
+     */
+    pthread_mutex_init(&tci_pool.busy, NULL);
+    pthread_mutex_init(&tci_pool.mutex, NULL);
+    pthread_cond_init(&tci_pool.wake, NULL);
+    pthread_cond_init(&tci_pool.done, NULL);
+    tci_pool.nworker = 0;
+    tci_pool.nsleeping = 0;
+}
+
+static void tci_pool_init(void)
+{
+    tci_pool.policy = TCI_IDLE_SPIN_THEN_SLEEP;
+    tci_pool.spin_count = TCI_DEFAULT_SPIN_COUNT;
+    tci_pool.pin = true;
+
+    const char* str = getenv("TCI_IDLE_POLICY");
+    if (str)
+    {
+        if (strcmp(str, "spin") == 0) tci_pool.policy = TCI_IDLE_SPIN;
+        else if (strcmp(str, "sleep") == 0) tci_pool.policy = TCI_IDLE_SLEEP;
+    }
+
+    str = getenv("TCI_SPIN_COUNT");
+    if (str) tci_pool.spin_count = (unsigned)strtoul(str, NULL, 10);
+
+    str = getenv("TCI_PIN_THREADS");
+    if (str) tci_pool.pin = strcmp(str, "0") != 0 && strcmp(str, "false") != 0;
+
+#if defined(__linux__) && defined(CPU_SET)
+    tci_pool.ncpu = 0;
+    if (tci_pool.pin &&
+        sched_getaffinity(0, sizeof(cpu_set_t), &tci_pool.cpus) == 0)
+        tci_pool.ncpu = (unsigned)CPU_COUNT(&tci_pool.cpus);
+#endif
+
+    pthread_atfork(NULL, NULL, tci_pool_after_fork);
+}
+
+/*
+ * Number of times to poll before going to sleep, or UINT_MAX to never sleep.
+ */
+static unsigned tci_pool_spin_limit(void)
+{
+    switch (__atomic_load_n(&tci_pool.policy, __ATOMIC_RELAXED))
+    {
+        case TCI_IDLE_SPIN: return UINT_MAX;
+        case TCI_IDLE_SLEEP: return 0;
+        default: return __atomic_load_n(&tci_pool.spin_count, __ATOMIC_RELAXED);
+    }
+}
+
+static uint64_t tci_pool_wait_for_job(uint64_t old_job)
+{
+    tci_thread_pool* pool = &tci_pool;
+    unsigned limit = tci_pool_spin_limit();
+    uint64_t job;
+
+    for (unsigned i = 0;limit == UINT_MAX || i < limit;i++)
+    {
+        job = __atomic_load_n(&pool->job, __ATOMIC_ACQUIRE);
+        if (job != old_job) return job;
+        tci_yield();
+    }
+
+    pthread_mutex_lock(&pool->mutex);
+    pool->nsleeping++;
+    while ((job = __atomic_load_n(&pool->job, __ATOMIC_ACQUIRE)) == old_job)
+        pthread_cond_wait(&pool->wake, &pool->mutex);
+    pool->nsleeping--;
+    pthread_mutex_unlock(&pool->mutex);
+
+    return job;
+}
+
+static void tci_pool_wait_for_workers(void)
+{
+    tci_thread_pool* pool = &tci_pool;
+    unsigned limit = tci_pool_spin_limit();
+
+    for (unsigned i = 0;limit == UINT_MAX || i < limit;i++)
+    {
+        if (__atomic_load_n(&pool->pending, __ATOMIC_ACQUIRE) == 0) return;
+        tci_yield();
+    }
+
+    pthread_mutex_lock(&pool->mutex);
+    while (__atomic_load_n(&pool->pending, __ATOMIC_ACQUIRE) != 0)
+        pthread_cond_wait(&pool->done, &pool->mutex);
+    pthread_mutex_unlock(&pool->mutex);
+}
+
+static void* tci_pool_worker(void* raw_data)
+{
+    tci_thread_pool* pool = &tci_pool;
+    tci_pool_worker_data* data = (tci_pool_worker_data*)raw_data;
+    unsigned tid = data->tid;
+    uint64_t job = data->job;
+    free(data);
+
+    while (true)
+    {
+        job = tci_pool_wait_for_job(job);
+
+        /*
+         * Workers which do not take part must not touch the job data, which
+         * may already be overwritten by the next parallel region.
+         */
+        unsigned nthread = (unsigned)(job & UINT32_MAX);
+        if (tid >= nthread) continue;
+
+        tci_comm comm;
+        tci_comm_init(&comm, pool->context, nthread, tid, 1, 0);
+        pool->func(&comm, pool->payload);
+        tci_comm_destroy(&comm);
+
+        if (__atomic_sub_fetch(&pool->pending, 1, __ATOMIC_ACQ_REL) == 0)
+        {
+            pthread_mutex_lock(&pool->mutex);
+            pthread_cond_signal(&pool->done);
+            pthread_mutex_unlock(&pool->mutex);
+        }
+    }
+
+    return NULL;
+}
+
+static int tci_pool_grow(unsigned nworker)
+{
+    tci_thread_pool* pool = &tci_pool;
+
+    while (pool->nworker < nworker)
+    {
+        tci_pool_worker_data* data =
+            (tci_pool_worker_data*)malloc(sizeof(tci_pool_worker_data));
+        if (!data) return ENOMEM;
+        data->tid = pool->nworker+1;
+        data->job = pool->job;
+
+        pthread_attr_t attr;
+        pthread_attr_init(&attr);
+        pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+
+#if defined(__linux__) && defined(CPU_SET)
+        if (pool->ncpu > 1)
+        {
+            unsigned target = data->tid % pool->ncpu;
+            for (int cpu = 0;cpu < CPU_SETSIZE;cpu++)
+            {
+                if (!CPU_ISSET(cpu, &pool->cpus)) continue;
+                if (target-- == 0)
+                {
+                    cpu_set_t cpus;
+                    CPU_ZERO(&cpus);
+                    CPU_SET(cpu, &cpus);
+                    pthread_attr_setaffinity_np(&attr, sizeof(cpu_set_t), &cpus);
+                    break;
+                }
+            }
+        }
+#endif
+
+        pthread_t thread;
+        int ret = pthread_create(&thread, &attr, tci_pool_worker, data);
+        pthread_attr_destroy(&attr);
+
+        if (ret != 0)
+        {
+            free(data);
+            return ret;
+        }
+
+        pool->nworker++;
+    }
+
+    return 0;
+}
+
+int tci_parallelize(tci_thread_func func, void* payload,
+                    unsigned nthread, unsigned arity)
+{
+    if (nthread <= 1)
+    {
+        func(tci_single, payload);
+        return 0;
+    }
+
+    pthread_once(&tci_pool_once, tci_pool_init);
+
+    tci_thread_pool* pool = &tci_pool;
+
+    if (pthread_mutex_trylock(&pool->busy) != 0)
+        return tci_parallelize_spawn(func, payload, nthread, arity);
+
+    int ret = tci_pool_grow(nthread-1);
+    if (ret != 0)
+    {
+        pthread_mutex_unlock(&pool->busy);
+        return tci_parallelize_spawn(func, payload, nthread, arity);
+    }
+
+    tci_context* context;
+    ret = tci_context_init(&context, nthread, arity);
+    if (ret != 0)
+    {
+        pthread_mutex_unlock(&pool->busy);
+        return ret;
+    }
+
+    pool->func = func;
+    pool->payload = payload;
+    pool->context = context;
+    __atomic_store_n(&pool->pending, nthread-1, __ATOMIC_RELAXED);
+
+    uint64_t job = ((pool->job >> 32) + 1) << 32 | nthread;
+    __atomic_store_n(&pool->job, job, __ATOMIC_RELEASE);
+
+    pthread_mutex_lock(&pool->mutex);
+    if (pool->nsleeping > 0) pthread_cond_broadcast(&pool->wake);
+    pthread_mutex_unlock(&pool->mutex);
+
+    tci_comm comm0;
+    tci_comm_init(&comm0, context, nthread, 0, 1, 0);
+    func(&comm0, payload);
+
+    tci_pool_wait_for_workers();
+
+    ret = tci_comm_destroy(&comm0);
+
+    pthread_mutex_unlock(&pool->busy);
+
+    return ret;
+}
+
+void tci_set_idle_policy(tci_idle_policy policy, unsigned spin_count)
+{
+    pthread_once(&tci_pool_once, tci_pool_init);
+
+    __atomic_store_n(&tci_pool.policy, (int)policy, __ATOMIC_RELAXED);
+    __atomic_store_n(&tci_pool.spin_count, spin_count, __ATOMIC_RELAXED);
+}
+
 #elif TCI_USE_WINDOWS_THREADS
 
 //TODO
@@ -186,6 +497,17 @@ int tci_parallelize(tci_thread_func func, void* payload,
 
 #endif
 
+#if !TCI_USE_PTHREADS_THREADS
+
+void tci_set_idle_policy(tci_idle_policy policy, unsigned spin_count)
+{
+    // Only the pthreads backend keeps its own idle threads
+    (void)policy;
+    (void)spin_count;
+}
+
+#endif
+
 void tci_prime_factorization(unsigned n, tci_prime_factors* factors)
 {
     factors->n = n;
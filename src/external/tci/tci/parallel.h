@@ -14,6 +14,22 @@ typedef void (*tci_thread_func)(tci_comm*, void*);
 int tci_parallelize(tci_thread_func func, void* payload,
                     unsigned nthread, unsigned arity);
 
+typedef enum
+{
+    TCI_IDLE_SPIN_THEN_SLEEP,
+    TCI_IDLE_SPIN,
+    TCI_IDLE_SLEEP
+} tci_idle_policy;
+
+/*
+ * Set how idle worker threads wait for the next parallel region: spin for
+ * spin_count polls and then sleep (the default), always spin, or sleep
+ * immediately. The initial policy may also be given with the TCI_IDLE_POLICY
+ * (spin, sleep, or spin_then_sleep) and TCI_SPIN_COUNT environment variables.
+ * Only has an effect with the pthreads thread model.
+ */
+void tci_set_idle_policy(tci_idle_policy policy, unsigned spin_count);
+
 typedef struct tci_prime_factors
 {
     unsigned n;
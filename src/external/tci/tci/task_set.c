@@ -7,43 +7,205 @@ extern "C" {
 
 #if TCI_USE_OPENMP_THREADS || TCI_USE_PTHREADS_THREADS || TCI_USE_WINDOWS_THREADS
 
+/*
+ * Each gang owns a queue of the tasks assigned to it, which it works through
+ * from the front while other gangs which have run out of work steal from the
+ * back. The tasks themselves are stored by every thread of the gang (each
+ * thread has its own payload), and a queue just holds the range [head,tail)
+ * of positions which have not been started yet, packed into one word.
+ */
+struct tci_task_queue
+{
+    uint64_t range;
+    tci_task** tasks;
+    char padding[64-sizeof(uint64_t)-sizeof(tci_task**)];
+};
+
+static int tci_task_load_less(const tci_task_set* set, unsigned i, unsigned j)
+{
+    uint64_t load_i = set->load[set->heap[i]];
+    uint64_t load_j = set->load[set->heap[j]];
+    return load_i < load_j || (load_i == load_j && set->heap[i] < set->heap[j]);
+}
+
+/*
+ * Assign a task to the gang with the least work so far and update the heap.
+ * All threads make the same sequence of assignments.
+ */
+static unsigned tci_task_set_assign(tci_task_set* set, uint64_t work)
+{
+    unsigned ngang = set->subcomm.ngang;
+    unsigned gang = set->heap[0];
+    set->load[gang] += TCI_MAX(work, 1);
+
+    unsigned i = 0;
+    while (true)
+    {
+        unsigned child = 2*i+1;
+        if (child >= ngang) break;
+        if (child+1 < ngang && tci_task_load_less(set, child+1, child)) child++;
+        if (!tci_task_load_less(set, child, i)) break;
+
+        unsigned tmp = set->heap[i];
+        set->heap[i] = set->heap[child];
+        set->heap[child] = tmp;
+        i = child;
+    }
+
+    return gang;
+}
+
+static int tci_task_queue_pop(tci_task_queue* queue, int back, unsigned* pos)
+{
+    uint64_t range = __atomic_load_n(&queue->range, __ATOMIC_RELAXED);
+
+    while (true)
+    {
+        uint64_t head = range & 0xffffffffu;
+        uint64_t tail = range >> 32;
+        if (head >= tail) return 0;
+
+        uint64_t next = back ? ((tail-1) << 32) | head : range+1;
+        if (__atomic_compare_exchange_n(&queue->range, &range, next, 1,
+                                        __ATOMIC_ACQ_REL,
+                                        __ATOMIC_RELAXED))
+        {
+            *pos = back ? tail-1 : head;
+            return 1;
+        }
+    }
+}
+
+static void tci_task_set_run(tci_task_set* set)
+{
+    tci_comm* subcomm = &set->subcomm;
+    unsigned ngang = subcomm->ngang;
+    unsigned gid = subcomm->gid;
+
+    set->queues[gid].tasks[subcomm->tid] = set->tasks;
+    if (tci_comm_is_master(subcomm))
+        __atomic_store_n(&set->queues[gid].range,
+                         (uint64_t)set->ntask_local << 32, __ATOMIC_RELAXED);
+    tci_comm_barrier(set->comm);
+
+    while (true)
+    {
+        uintptr_t next = 0;
+
+        if (tci_comm_is_master(subcomm))
+        {
+            unsigned pos;
+            for (unsigned i = 0;i < ngang;i++)
+            {
+                unsigned victim = (gid+i) % ngang;
+                if (tci_task_queue_pop(set->queues+victim, i != 0, &pos))
+                {
+                    next = 1 + (uintptr_t)pos*ngang + victim;
+                    break;
+                }
+            }
+        }
+
+        tci_comm_bcast(subcomm, (void**)&next, 0);
+        if (!next) break;
+
+        unsigned victim = (next-1) % ngang;
+        unsigned pos = (next-1) / ngang;
+        tci_task* task = set->queues[victim].tasks[subcomm->tid]+pos;
+        task->func(subcomm, task->task, task->payload);
+    }
+}
+
 void tci_task_set_init(tci_task_set* set, tci_comm* comm, unsigned ntask,
                        uint64_t work)
 {
     set->comm = comm;
     set->ntask = ntask;
-
-    if (tci_comm_is_master(comm))
-    {
-        set->slots = (tci_slot*)malloc((ntask+1)*sizeof(tci_slot));
-        for (unsigned task = 0;task < ntask;task++)
-            tci_slot_init(set->slots+task+1, 0);
-    }
-    tci_comm_bcast(comm, (void**)&set->slots, 0);
+    set->slots = NULL;
+    set->queues = NULL;
+    set->tasks = NULL;
+    set->ntask_local = 0;
+    set->ntask_max = 0;
+    set->load = NULL;
+    set->heap = NULL;
 
     unsigned nt = comm->nthread;
     unsigned nt_outer, nt_inner;
     tci_partition_2x2(nt, work, (work == 0 ? 1 : nt),
                       ntask, ntask, &nt_inner, &nt_outer);
     tci_comm_gang(comm, &set->subcomm, TCI_EVENLY, nt_outer, 0);
+
+    if (nt_outer == 1) return;
+
+    if (tci_comm_is_master(comm))
+    {
+        set->queues = (tci_task_queue*)malloc(nt_outer*sizeof(tci_task_queue) +
+                                              nt*sizeof(tci_task*));
+        tci_task** tasks = (tci_task**)(set->queues+nt_outer);
+        for (unsigned gang = 0;gang < nt_outer;gang++)
+        {
+            set->queues[gang].range = 0;
+            set->queues[gang].tasks = tasks + gang*nt_inner;
+        }
+    }
+    tci_comm_bcast(comm, (void**)&set->queues, 0);
+
+    set->load = (uint64_t*)malloc(nt_outer*(sizeof(uint64_t)+sizeof(unsigned)));
+    set->heap = (unsigned*)(set->load+nt_outer);
+    for (unsigned gang = 0;gang < nt_outer;gang++)
+    {
+        set->load[gang] = 0;
+        set->heap[gang] = gang;
+    }
 }
 
 void tci_task_set_destroy(tci_task_set* set)
 {
+    if (set->queues) tci_task_set_run(set);
+
     tci_comm_barrier(set->comm);
     tci_comm_destroy(&set->subcomm);
+
+    free(set->tasks);
+    free(set->load);
     if (tci_comm_is_master(set->comm))
-        free((void*)set->slots);
+        free(set->queues);
 }
 
 int tci_task_set_visit(tci_task_set* set, tci_task_func func, unsigned task,
                        void* payload)
+{
+    return tci_task_set_visit_work(set, func, task, 1, payload);
+}
+
+int tci_task_set_visit_work(tci_task_set* set, tci_task_func func,
+                            unsigned task, uint64_t work, void* payload)
 {
     if (task > set->ntask) return EINVAL;
-    if (!tci_slot_try_fill(set->slots+task+1, 0, set->subcomm.gid+1))
+
+    /*
+     * With only one gang there is nobody to steal from, so just run the task.
+     */
+    if (!set->queues)
+    {
+        func(&set->subcomm, task, payload);
+        return 0;
+    }
+
+    if (tci_task_set_assign(set, work) != set->subcomm.gid)
         return EALREADY;
 
-    func(&set->subcomm, task, payload);
+    if (set->ntask_local == set->ntask_max)
+    {
+        set->ntask_max = TCI_MAX(2*set->ntask_max, 16);
+        set->tasks = (tci_task*)realloc(set->tasks,
+                                        set->ntask_max*sizeof(tci_task));
+    }
+
+    tci_task* local = set->tasks + set->ntask_local++;
+    local->func = func;
+    local->payload = payload;
+    local->task = task;
 
     return 0;
 }
@@ -54,7 +216,7 @@ int tci_task_set_visit_all(tci_task_set* set, tci_task_func func,
     for (unsigned task = 0;task < set->ntask;task++)
     {
         int ret = tci_task_set_visit(set, func, task, payload);
-        if (ret != 0) return ret;
+        if (ret != 0 && ret != EALREADY) return ret;
     }
 
     return 0;
@@ -96,6 +258,13 @@ int tci_task_set_visit(tci_task_set* set, tci_task_func func, unsigned task,
     return 0;
 }
 
+int tci_task_set_visit_work(tci_task_set* set, tci_task_func func,
+                            unsigned task, uint64_t work, void* payload)
+{
+    (void)work;
+    return tci_task_set_visit(set, func, task, payload);
+}
+
 int tci_task_set_visit_all(tci_task_set* set, tci_task_func func,
                            void* payload)
 {
@@ -141,6 +310,13 @@ int tci_task_set_visit(tci_task_set* set, tci_task_func func, unsigned task,
     return 0;
 }
 
+int tci_task_set_visit_work(tci_task_set* set, tci_task_func func,
+                            unsigned task, uint64_t work, void* payload)
+{
+    (void)work;
+    return tci_task_set_visit(set, func, task, payload);
+}
+
 int tci_task_set_visit_all(tci_task_set* set, tci_task_func func,
                            void* payload)
 {
@@ -205,6 +381,13 @@ int tci_task_set_visit(tci_task_set* set, tci_task_func func, unsigned task,
     return 0;
 }
 
+int tci_task_set_visit_work(tci_task_set* set, tci_task_func func,
+                            unsigned task, uint64_t work, void* payload)
+{
+    (void)work;
+    return tci_task_set_visit(set, func, task, payload);
+}
+
 int tci_task_set_visit_all(tci_task_set* set, tci_task_func func,
                            void* payload)
 {
@@ -253,6 +436,13 @@ int tci_task_set_visit(tci_task_set* set, tci_task_func func, unsigned task,
     return 0;
 }
 
+int tci_task_set_visit_work(tci_task_set* set, tci_task_func func,
+                            unsigned task, uint64_t work, void* payload)
+{
+    (void)work;
+    return tci_task_set_visit(set, func, task, payload);
+}
+
 int tci_task_set_visit_all(tci_task_set* set, tci_task_func func,
                            void* payload)
 {
@@ -288,6 +478,13 @@ int tci_task_set_visit(tci_task_set* set, tci_task_func func, unsigned task,
     return 0;
 }
 
+int tci_task_set_visit_work(tci_task_set* set, tci_task_func func,
+                            unsigned task, uint64_t work, void* payload)
+{
+    (void)work;
+    return tci_task_set_visit(set, func, task, payload);
+}
+
 int tci_task_set_visit_all(tci_task_set* set, tci_task_func func,
                            void* payload)
 {
@@ -12,12 +12,33 @@ extern "C" {
 
 typedef void (*tci_task_func)(tci_comm*, unsigned, void*);
 
+typedef struct tci_task
+{
+    tci_task_func func;
+    void* payload;
+    unsigned task;
+} tci_task;
+
+typedef struct tci_task_queue tci_task_queue;
+
 typedef struct tci_task_set
 {
     tci_comm* comm;
     tci_comm subcomm;
     tci_slot* slots;
     unsigned ntask;
+
+    /*
+     * Work-stealing state: the per-gang queues (shared), the tasks assigned
+     * to this thread's gang in visiting order, and the running cost of the
+     * tasks assigned to each gang (kept as a heap).
+     */
+    tci_task_queue* queues;
+    tci_task* tasks;
+    unsigned ntask_local;
+    unsigned ntask_max;
+    uint64_t* load;
+    unsigned* heap;
 } tci_task_set;
 
 void tci_task_set_init(tci_task_set* set, tci_comm* comm, unsigned ntask,
@@ -28,6 +49,17 @@ void tci_task_set_destroy(tci_task_set* set);
 int tci_task_set_visit(tci_task_set* set, tci_task_func func, unsigned task,
                        void* payload);
 
+/*
+ * Visit a task with an estimate of its cost. Each task is assigned to the
+ * gang which has been given the least work so far, and gangs which run out
+ * of tasks steal from the others. Every thread must visit the same tasks with
+ * the same costs in the same order. Returns 0 if the task will be run by
+ * this thread (possibly not until the task set is destroyed), or EALREADY if
+ * it will be run by another gang, in which case the payload is not used.
+ */
+int tci_task_set_visit_work(tci_task_set* set, tci_task_func func,
+                            unsigned task, uint64_t work, void* payload);
+
 int tci_task_set_visit_all(tci_task_set* set, tci_task_func func,
                            void* payload);
 
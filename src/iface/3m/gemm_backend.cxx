@@ -0,0 +1,100 @@
+#include "gemm_backend.h"
+
+#include "util/env.hpp"
+#include "internal/3m/mult.hpp"
+
+#if TBLIS_HAVE_DLFCN_H
+#include <dlfcn.h>
+#endif
+
+#include <cstdio>
+#include <cstdlib>
+
+namespace tblis
+{
+
+namespace internal
+{
+
+/*
+ * The library is never closed, since its routines may still be in use by a
+ * backend copied out with tblis_get_gemm_backend.
+ */
+static bool load_gemm_backend(const char* library, tblis_gemm_backend& backend)
+{
+#if TBLIS_HAVE_DLFCN_H
+
+    void* handle = dlopen(library, RTLD_NOW|RTLD_LOCAL);
+    if (!handle) return false;
+
+    backend.sgemm = reinterpret_cast<tblis_sgemm_fn>(dlsym(handle, "sgemm_"));
+    backend.dgemm = reinterpret_cast<tblis_dgemm_fn>(dlsym(handle, "dgemm_"));
+    backend.cgemm = reinterpret_cast<tblis_cgemm_fn>(dlsym(handle, "cgemm_"));
+    backend.zgemm = reinterpret_cast<tblis_zgemm_fn>(dlsym(handle, "zgemm_"));
+
+    if (backend.sgemm || backend.dgemm || backend.cgemm || backend.zgemm)
+        return true;
+
+    dlclose(handle);
+    backend = tblis_gemm_backend();
+    return false;
+
+#else
+
+    (void)library;
+    (void)backend;
+    return false;
+
+#endif
+}
+
+static tblis_gemm_backend initial_gemm_backend()
+{
+    tblis_gemm_backend backend = {};
+
+    const char* library = getenv("TBLIS_BLAS_LIBRARY");
+    if (library && *library && !load_gemm_backend(library, backend) &&
+        get_verbose() >= 1)
+        printf("tblis: could not load GEMM backend from %s\n", library);
+
+    return backend;
+}
+
+static tblis_gemm_backend& mutable_gemm_backend()
+{
+    static tblis_gemm_backend backend = initial_gemm_backend();
+    return backend;
+}
+
+const tblis_gemm_backend& gemm_backend()
+{
+    return mutable_gemm_backend();
+}
+
+}
+
+extern "C"
+{
+
+void tblis_set_gemm_backend(const tblis_gemm_backend* backend)
+{
+    internal::mutable_gemm_backend() = backend ? *backend : tblis_gemm_backend();
+}
+
+void tblis_get_gemm_backend(tblis_gemm_backend* backend)
+{
+    *backend = internal::gemm_backend();
+}
+
+int tblis_load_gemm_backend(const char* library)
+{
+    tblis_gemm_backend backend = {};
+    if (!internal::load_gemm_backend(library, backend)) return -1;
+
+    tblis_set_gemm_backend(&backend);
+    return 0;
+}
+
+}
+
+}
@@ -0,0 +1,81 @@
+#ifndef _TBLIS_IFACE_3M_GEMM_BACKEND_H_
+#define _TBLIS_IFACE_3M_GEMM_BACKEND_H_
+
+#include "../../util/basic_types.h"
+
+#ifdef __cplusplus
+
+namespace tblis
+{
+
+extern "C"
+{
+
+#endif
+
+/*
+ * GEMM routines with the (LP64) Fortran BLAS calling convention, so that
+ * sgemm_, dgemm_, cgemm_, and zgemm_ from a vendor BLAS may be used directly.
+ * All matrices are column-major.
+ */
+typedef void (*tblis_sgemm_fn)(const char* transa, const char* transb,
+                               const int* m, const int* n, const int* k,
+                               const float* alpha, const float* A, const int* lda,
+                                                   const float* B, const int* ldb,
+                               const float* beta,        float* C, const int* ldc);
+
+typedef void (*tblis_dgemm_fn)(const char* transa, const char* transb,
+                               const int* m, const int* n, const int* k,
+                               const double* alpha, const double* A, const int* lda,
+                                                    const double* B, const int* ldb,
+                               const double* beta,        double* C, const int* ldc);
+
+typedef void (*tblis_cgemm_fn)(const char* transa, const char* transb,
+                               const int* m, const int* n, const int* k,
+                               const scomplex* alpha, const scomplex* A, const int* lda,
+                                                      const scomplex* B, const int* ldb,
+                               const scomplex* beta,        scomplex* C, const int* ldc);
+
+typedef void (*tblis_zgemm_fn)(const char* transa, const char* transb,
+                               const int* m, const int* n, const int* k,
+                               const dcomplex* alpha, const dcomplex* A, const int* lda,
+                                                      const dcomplex* B, const int* ldb,
+                               const dcomplex* beta,        dcomplex* C, const int* ldc);
+
+/*
+ * External GEMM used by the BLAS-based dense contraction algorithm. A null
+ * entry means that TBLIS's own GEMM is used for that type. Backend routines
+ * are called from a single thread and may use their own threading.
+ */
+typedef struct tblis_gemm_backend
+{
+    tblis_sgemm_fn sgemm;
+    tblis_dgemm_fn dgemm;
+    tblis_cgemm_fn cgemm;
+    tblis_zgemm_fn zgemm;
+} tblis_gemm_backend;
+
+/*
+ * Install a backend, or go back to TBLIS's GEMM if backend is NULL. Not safe
+ * to call while a contraction is in progress.
+ */
+void tblis_set_gemm_backend(const tblis_gemm_backend* backend);
+
+void tblis_get_gemm_backend(tblis_gemm_backend* backend);
+
+/*
+ * Install sgemm_, dgemm_, cgemm_, and zgemm_ from a shared library opened
+ * with dlopen. This is done at startup if TBLIS_BLAS_LIBRARY names a library.
+ * Returns zero on success, and otherwise leaves the backend unchanged.
+ */
+int tblis_load_gemm_backend(const char* library);
+
+#ifdef __cplusplus
+}
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
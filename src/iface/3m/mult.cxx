@@ -26,10 +26,6 @@ void tblis_matrix_mult(const tblis_comm* comm, const tblis_config* cfg,
     TBLIS_ASSERT(A->type == B->type);
     TBLIS_ASSERT(A->type == C->type);
 
-    TBLIS_ASSERT(!A->conj);
-    TBLIS_ASSERT(!B->conj);
-    TBLIS_ASSERT(!C->conj);
-
     TBLIS_WITH_TYPE_AS(A->type, T,
     {
         T alpha = A->alpha<T>()*B->alpha<T>();
@@ -204,11 +200,6 @@ void tblis_matrix_mult_diag(const tblis_comm* comm, const tblis_config* cfg,
     TBLIS_ASSERT(A->type == C->type);
     TBLIS_ASSERT(A->type == D->type);
 
-    TBLIS_ASSERT(!A->conj);
-    TBLIS_ASSERT(!B->conj);
-    TBLIS_ASSERT(!C->conj);
-    TBLIS_ASSERT(!D->conj);
-
     TBLIS_WITH_TYPE_AS(A->type, T,
     {
         T alpha = A->alpha<T>()*B->alpha<T>();
@@ -18,23 +18,54 @@
 namespace tblis
 {
 
-extern "C"
+/*
+ * The strides of up to three tensors with the same shape as C (the operands
+ * of an epilogue), for each dimension of C, and then as they come out for
+ * the AC, BC, and ABC groups of the plan.
+ */
+struct C_like_strides
 {
-
-void tblis_tensor_mult(const tblis_comm* comm, const tblis_config* cfg,
-                       const tblis_tensor* A, const label_type* idx_A_,
-                       const tblis_tensor* B, const label_type* idx_B_,
-                             tblis_tensor* C, const label_type* idx_C_)
+    std::array<stride_vector, 3> stride;
+    std::array<stride_vector, 3> stride_AC, stride_BC, stride_ABC;
+};
+
+/*
+ * The strides of a weight tensor over indices shared by A and B, for each
+ * dimension of A (zero where the weight does not have that index, and for
+ * repeated indices of A all but the first), and then as they come out for the
+ * AB and ABC groups of the plan.
+ */
+struct AB_like_strides
+{
+    stride_vector stride;
+    stride_vector stride_AB, stride_ABC;
+};
+
+static internal::mult_plan make_mult_plan(const tblis_tensor* A, const label_type* idx_A_,
+                                          const tblis_tensor* B, const label_type* idx_B_,
+                                          const tblis_tensor* C, const label_type* idx_C_,
+                                          C_like_strides* C_like = nullptr,
+                                          AB_like_strides* AB_like = nullptr)
 {
-    TBLIS_ASSERT(A->type == B->type);
-    TBLIS_ASSERT(A->type == C->type);
-
     unsigned ndim_A = A->ndim;
     len_vector len_A;
     stride_vector stride_A;
     label_vector idx_A;
     diagonal(ndim_A, A->len, A->stride, idx_A_, len_A, stride_A, idx_A);
 
+    stride_vector stride_W;
+    if (AB_like)
+    {
+        unsigned ndim_W = A->ndim;
+        len_vector len_W;
+        label_vector idx_W;
+        diagonal(ndim_W, A->len, AB_like->stride.data(), idx_A_, len_W, stride_W, idx_W);
+    }
+    else
+    {
+        stride_W.resize(len_A.size());
+    }
+
     unsigned ndim_B = B->ndim;
     len_vector len_B;
     stride_vector stride_B;
@@ -47,6 +78,21 @@ void tblis_tensor_mult(const tblis_comm* comm, const tblis_config* cfg,
     label_vector idx_C;
     diagonal(ndim_C, C->len, C->stride, idx_C_, len_C, stride_C, idx_C);
 
+    std::array<stride_vector, 3> stride_X;
+    for (unsigned i = 0;i < 3;i++)
+    {
+        if (!C_like)
+        {
+            stride_X[i].resize(len_C.size());
+            continue;
+        }
+
+        unsigned ndim_X = C->ndim;
+        len_vector len_X;
+        label_vector idx_X;
+        diagonal(ndim_X, C->len, C_like->stride[i].data(), idx_C_, len_X, stride_X[i], idx_X);
+    }
+
     auto ndim_ABC = stl_ext::intersection(idx_A, idx_B, idx_C).size();
 
     if (idx_A.size() == ndim_ABC ||
@@ -61,6 +107,12 @@ void tblis_tensor_mult(const tblis_comm* comm, const tblis_config* cfg,
         stride_B.push_back(0);
         stride_C.push_back(0);
         stride_C.push_back(0);
+        stride_W.push_back(0);
+        for (auto& stride : stride_X)
+        {
+            stride.push_back(0);
+            stride.push_back(0);
+        }
         label_type idx = detail::free_idx(idx_A, idx_B, idx_C);
         idx_A.push_back(idx);
         idx_C.push_back(idx);
@@ -76,12 +128,14 @@ void tblis_tensor_mult(const tblis_comm* comm, const tblis_config* cfg,
     auto stride_A_ABC = stl_ext::select_from(stride_A, idx_A, idx_ABC);
     auto stride_B_ABC = stl_ext::select_from(stride_B, idx_B, idx_ABC);
     auto stride_C_ABC = stl_ext::select_from(stride_C, idx_C, idx_ABC);
+    auto stride_W_ABC = stl_ext::select_from(stride_W, idx_A, idx_ABC);
 
     auto idx_AB = stl_ext::exclusion(stl_ext::intersection(idx_A, idx_B), idx_ABC);
     auto len_AB = stl_ext::select_from(len_A, idx_A, idx_AB);
     TBLIS_ASSERT(len_AB == stl_ext::select_from(len_B, idx_B, idx_AB));
     auto stride_A_AB = stl_ext::select_from(stride_A, idx_A, idx_AB);
     auto stride_B_AB = stl_ext::select_from(stride_B, idx_B, idx_AB);
+    auto stride_W_AB = stl_ext::select_from(stride_W, idx_A, idx_AB);
 
     auto idx_AC = stl_ext::exclusion(stl_ext::intersection(idx_A, idx_C), idx_ABC);
     auto len_AC = stl_ext::select_from(len_A, idx_A, idx_AC);
@@ -110,68 +164,651 @@ void tblis_tensor_mult(const tblis_comm* comm, const tblis_config* cfg,
     TBLIS_ASSERT(stl_ext::intersection(idx_AC, idx_ABC).empty());
     TBLIS_ASSERT(stl_ext::intersection(idx_BC, idx_ABC).empty());
 
-    fold(len_ABC, idx_ABC, stride_A_ABC, stride_B_ABC, stride_C_ABC);
-    fold(len_AB, idx_AB, stride_A_AB, stride_B_AB);
-    fold(len_AC, idx_AC, stride_A_AC, stride_C_AC);
-    fold(len_BC, idx_BC, stride_B_BC, stride_C_BC);
+    std::array<stride_vector, 3> stride_X_AC, stride_X_BC, stride_X_ABC;
+    for (unsigned i = 0;i < 3;i++)
+    {
+        stride_X_AC[i] = stl_ext::select_from(stride_X[i], idx_C, idx_AC);
+        stride_X_BC[i] = stl_ext::select_from(stride_X[i], idx_C, idx_BC);
+        stride_X_ABC[i] = stl_ext::select_from(stride_X[i], idx_C, idx_ABC);
+    }
+
+    /*
+     * Dimensions of C are only folded where they are also contiguous in the
+     * tensors like C, and those of AB and ABC where they are contiguous in
+     * the weight (all of these strides are zero if there are none).
+     */
+    fold(len_ABC, idx_ABC, stride_A_ABC, stride_B_ABC, stride_C_ABC,
+         stride_X_ABC[0], stride_X_ABC[1], stride_X_ABC[2], stride_W_ABC);
+    fold(len_AB, idx_AB, stride_A_AB, stride_B_AB, stride_W_AB);
+    fold(len_AC, idx_AC, stride_A_AC, stride_C_AC,
+         stride_X_AC[0], stride_X_AC[1], stride_X_AC[2]);
+    fold(len_BC, idx_BC, stride_B_BC, stride_C_BC,
+         stride_X_BC[0], stride_X_BC[1], stride_X_BC[2]);
+
+    if (C_like)
+    {
+        C_like->stride_AC = stride_X_AC;
+        C_like->stride_BC = stride_X_BC;
+        C_like->stride_ABC = stride_X_ABC;
+    }
+
+    if (AB_like)
+    {
+        AB_like->stride_AB = stride_W_AB;
+        AB_like->stride_ABC = stride_W_ABC;
+    }
 
-    len_vector nolen;
-    stride_vector nostride;
+    return {len_AB, len_AC, len_BC, len_ABC,
+            stride_A_AB, stride_A_AC, stride_A_ABC,
+            stride_B_AB, stride_B_BC, stride_B_ABC,
+            stride_C_AC, stride_C_BC, stride_C_ABC};
+}
 
-    TBLIS_WITH_TYPE_AS(A->type, T,
+template <typename T>
+static void mult_with_plan(const communicator& comm, const config& cfg,
+                           const internal::mult_plan& plan,
+                           const tblis_tensor* A, const tblis_tensor* B,
+                           const tblis_tensor* C)
+{
+    T alpha = A->alpha<T>()*B->alpha<T>();
+    T beta = C->alpha<T>();
+
+    T* data_A = static_cast<T*>(A->data);
+    T* data_B = static_cast<T*>(B->data);
+    T* data_C = static_cast<T*>(C->data);
+
+    if (alpha == T(0))
+    {
+        if (beta == T(0))
+        {
+            internal::set<T>(comm, cfg, plan.len_C, T(0), data_C,
+                             plan.stride_C);
+        }
+        else if (beta != T(1) || (is_complex<T>::value && C->conj))
+        {
+            internal::scale<T>(comm, cfg, plan.len_C,
+                               beta, C->conj, data_C, plan.stride_C);
+        }
+    }
+    else
+    {
+        internal::mult<T>(comm, cfg, plan,
+                          alpha, A->conj, data_A,
+                                 B->conj, data_B,
+                           beta, C->conj, data_C);
+    }
+}
+
+/*
+ * A and B are in precision T and C is in the other precision.
+ */
+template <typename T>
+static void mult_with_plan_mixed(const communicator& comm, const config& cfg,
+                                 const internal::mult_plan& plan,
+                                 const tblis_tensor* A, const tblis_tensor* B,
+                                 const tblis_tensor* C)
+{
+    typedef other_precision_t<T> U;
+    typedef higher_precision_t<T,U> V;
+
+    V alpha = V(A->alpha<T>()*B->alpha<T>());
+    V beta = V(C->alpha<U>());
+
+    T* data_A = static_cast<T*>(A->data);
+    T* data_B = static_cast<T*>(B->data);
+    U* data_C = static_cast<U*>(C->data);
+
+    if (alpha == V(0))
+    {
+        if (beta == V(0))
+        {
+            internal::set<U>(comm, cfg, plan.len_C, U(0), data_C,
+                             plan.stride_C);
+        }
+        else if (beta != V(1) || (is_complex<U>::value && C->conj))
+        {
+            internal::scale<U>(comm, cfg, plan.len_C,
+                               U(beta), C->conj, data_C, plan.stride_C);
+        }
+    }
+    else
+    {
+        internal::mult_mixed<T,U>(comm, cfg, plan,
+                                  alpha, A->conj, data_A,
+                                         B->conj, data_B,
+                                   beta, C->conj, data_C);
+    }
+}
+
+template <typename T>
+static void mult_with_plan_as(const communicator& comm, const config& cfg,
+                              const internal::mult_plan& plan,
+                              const tblis_tensor* A, const tblis_tensor* B,
+                              const tblis_tensor* C)
+{
+    if (C->type == A->type)
+        mult_with_plan<T>(comm, cfg, plan, A, B, C);
+    else
+        mult_with_plan_mixed<T>(comm, cfg, plan, A, B, C);
+}
+
+static void reset_scalar(tblis_tensor* C)
+{
+    TBLIS_WITH_TYPE_AS(C->type, T,
     {
-        T alpha = A->alpha<T>()*B->alpha<T>();
-        T beta = C->alpha<T>();
+        C->alpha<T>() = T(1);
+        C->conj = false;
+    })
+}
 
-        T* data_A = static_cast<T*>(A->data);
-        T* data_B = static_cast<T*>(B->data);
-        T* data_C = static_cast<T*>(C->data);
+/*
+ * C may be either in the same precision as A and B or the other one (see
+ * other_precision).
+ */
+static void check_types(const tblis_tensor* A, const tblis_tensor* B,
+                        const tblis_tensor* C)
+{
+    TBLIS_ASSERT(A->type == B->type);
+
+    TBLIS_WITH_TYPE_AS(A->type, T,
+    {
+        TBLIS_ASSERT(C->type == A->type ||
+                     C->type == type_tag<other_precision_t<T>>::value);
+    })
+}
 
+static void mult_with_plan(const tblis_comm* comm, const config& cfg,
+                           const tblis_mult_options* options,
+                           const internal::mult_plan& plan,
+                           const tblis_tensor* A, const tblis_tensor* B,
+                           tblis_tensor* C)
+{
+    TBLIS_WITH_TYPE_AS(A->type, T,
+    {
         parallelize_if(
         [&](const communicator& comm)
         {
-            if (alpha == T(0))
+            internal::mult_options_scope scope(options);
+            mult_with_plan_as<T>(comm, cfg, plan, A, B, C);
+        }, comm);
+    })
+
+    reset_scalar(C);
+}
+
+/*
+ * The denominator of an epilogue is made up of two dense tensors, D_0 over
+ * the indices of C which are shared with A (the AC and ABC dimensions) and
+ * D_1 over those only shared with B (the BC dimensions). These are much
+ * smaller than C, and are laid out in the same order as C so that they fold
+ * in the same way. Their strides are put into C_like (for repeated indices
+ * of C only the first dimension gets one).
+ */
+template <typename T>
+static void make_denominators(const tblis_tensor* A, const label_type* idx_A,
+                              const tblis_tensor* B, const label_type* idx_B,
+                              const tblis_tensor* C, const label_type* idx_C,
+                              const tblis_vector* const* denom,
+                              std::array<std::vector<T>,2>& D,
+                              C_like_strides& C_like)
+{
+    unsigned ndim_C = C->ndim;
+
+    auto part = [&](label_type idx)
+    {
+        bool in_A = std::find(idx_A, idx_A+A->ndim, idx) != idx_A+A->ndim;
+        bool in_B = std::find(idx_B, idx_B+B->ndim, idx) != idx_B+B->ndim;
+        return in_B && !in_A ? 1 : 0;
+    };
+
+    dim_vector reorder = range(ndim_C);
+    std::stable_sort(reorder.begin(), reorder.end(),
+                     [&](unsigned i, unsigned j)
+                     {
+                         return C->stride[i] < C->stride[j];
+                     });
+
+    std::array<label_vector,2> idx_D;
+    std::array<len_vector,2> len_D;
+
+    for (unsigned d : reorder)
+    {
+        auto& idx = idx_D[part(idx_C[d])];
+        auto& len = len_D[part(idx_C[d])];
+
+        if (std::find(idx.begin(), idx.end(), idx_C[d]) == idx.end())
+        {
+            idx.push_back(idx_C[d]);
+            len.push_back(C->len[d]);
+        }
+    }
+
+    for (unsigned p : {0,1})
+    {
+        stride_vector stride_D(len_D[p].size());
+        stride_type size = 1;
+
+        for (unsigned i = 0;i < len_D[p].size();i++)
+        {
+            stride_D[i] = size;
+            size *= len_D[p][i];
+        }
+
+        D[p].assign(size, T(0));
+
+        for (unsigned d = 0;d < ndim_C;d++)
+        {
+            if (part(idx_C[d]) != p) continue;
+
+            auto i = std::find(idx_D[p].begin(), idx_D[p].end(), idx_C[d]) - idx_D[p].begin();
+            bool first = std::find(idx_C, idx_C+d, idx_C[d]) == idx_C+d;
+
+            C_like.stride[1+p][d] = first ? stride_D[i] : 0;
+
+            auto v = denom[d];
+            if (!v) continue;
+
+            TBLIS_ASSERT(v->type == C->type);
+            TBLIS_ASSERT(v->n == C->len[d]);
+
+            T alpha = v->alpha<T>();
+            auto data = static_cast<const T*>(v->data);
+
+            for (stride_type k = 0;k < size;k++)
             {
-                if (beta == T(0))
-                {
-                    internal::set<T>(comm, get_config(cfg),
-                                     len_AC+len_BC+len_ABC, T(0), data_C,
-                                     stride_C_AC+stride_C_BC+stride_C_ABC);
-                }
-                else if (beta != T(1) || (is_complex<T>::value && C->conj))
-                {
-                    internal::scale<T>(comm, get_config(cfg),
-                                       len_AC+len_BC+len_ABC,
-                                       beta, C->conj, data_C,
-                                       stride_C_AC+stride_C_BC+stride_C_ABC);
-                }
+                T x = data[((k/stride_D[i]) % len_D[p][i])*v->inc];
+                D[p][k] += alpha*(v->conj ? conj(x) : x);
             }
-            else
+        }
+    }
+}
+
+template <typename T>
+static void mult_with_epilogue(const tblis_comm* comm, const config& cfg,
+                               const tblis_tensor* A, const label_type* idx_A,
+                               const tblis_tensor* B, const label_type* idx_B,
+                                     tblis_tensor* C, const label_type* idx_C,
+                               const tblis_mult_epilogue& epilogue)
+{
+    internal::mult_epilogue<T> ep;
+    C_like_strides C_like;
+    std::array<std::vector<T>,2> D;
+
+    for (auto& stride : C_like.stride) stride.assign(C->ndim, 0);
+
+    if (auto E = epilogue.add)
+    {
+        TBLIS_ASSERT(E->type == C->type);
+        TBLIS_ASSERT(E->ndim == C->ndim);
+        TBLIS_ASSERT(std::equal(C->len, C->len+C->ndim, E->len));
+
+        C_like.stride[0].assign(E->stride, E->stride+E->ndim);
+
+        ep.op.add = true;
+        ep.op.gamma = E->alpha<T>();
+        ep.op.conj_E = E->conj;
+        ep.E = static_cast<const T*>(E->data);
+    }
+
+    if (epilogue.denom &&
+        std::any_of(epilogue.denom, epilogue.denom+C->ndim,
+                    [](const tblis_vector* v) { return v != nullptr; }))
+    {
+        make_denominators(A, idx_A, B, idx_B, C, idx_C, epilogue.denom, D, C_like);
+
+        ep.op.divide = true;
+        ep.D = {D[0].data(), D[1].data()};
+    }
+
+    ep.op.func = epilogue.func;
+    ep.op.func_data = epilogue.func_data;
+
+    auto plan = make_mult_plan(A, idx_A, B, idx_B, C, idx_C, &C_like);
+
+    ep.stride_AC = C_like.stride_AC;
+    ep.stride_BC = C_like.stride_BC;
+    ep.stride_ABC = C_like.stride_ABC;
+
+    T alpha = A->alpha<T>()*B->alpha<T>();
+    T beta = C->alpha<T>();
+
+    T* data_A = static_cast<T*>(A->data);
+    T* data_B = static_cast<T*>(B->data);
+    T* data_C = static_cast<T*>(C->data);
+
+    parallelize_if(
+    [&](const communicator& comm)
+    {
+        if (alpha == T(0))
+        {
+            if (beta == T(0))
             {
-                internal::mult<T>(comm, get_config(cfg),
-                                  len_AB, len_AC, len_BC, len_ABC,
-                                  alpha, A->conj, data_A,
-                                  stride_A_AB, stride_A_AC, stride_A_ABC,
-                                         B->conj, data_B,
-                                  stride_B_AB, stride_B_BC, stride_B_ABC,
-                                   beta, C->conj, data_C,
-                                  stride_C_AC, stride_C_BC, stride_C_ABC);
+                internal::set<T>(comm, cfg, plan.len_C, T(0), data_C,
+                                 plan.stride_C);
+            }
+            else if (beta != T(1) || (is_complex<T>::value && C->conj))
+            {
+                internal::scale<T>(comm, cfg, plan.len_C,
+                                   beta, C->conj, data_C, plan.stride_C);
             }
-        }, comm);
 
-        C->alpha<T>() = T(1);
-        C->conj = false;
+            comm.barrier();
+            internal::apply_epilogue<T>(comm, cfg, plan, data_C, ep);
+        }
+        else
+        {
+            internal::mult<T>(comm, cfg, plan,
+                              alpha, A->conj, data_A,
+                                     B->conj, data_B,
+                               beta, C->conj, data_C, ep);
+        }
+    }, comm);
+
+    reset_scalar(C);
+}
+
+/*
+ * C = alpha*A*diag(W)*B + beta*C, where every index of W is shared by A and
+ * B (a repeated index takes the diagonal of W).
+ */
+template <typename T>
+static void mult_weighted(const tblis_comm* comm, const config& cfg,
+                          const tblis_tensor* A, const label_type* idx_A,
+                          const tblis_tensor* W, const label_type* idx_W,
+                          const tblis_tensor* B, const label_type* idx_B,
+                                tblis_tensor* C, const label_type* idx_C)
+{
+    AB_like_strides W_like;
+    W_like.stride.assign(A->ndim, 0);
+
+    for (unsigned i = 0;i < W->ndim;i++)
+    {
+        auto dim_A = std::find(idx_A, idx_A+A->ndim, idx_W[i]) - idx_A;
+        auto dim_B = std::find(idx_B, idx_B+B->ndim, idx_W[i]) - idx_B;
+
+        TBLIS_ASSERT(dim_A < A->ndim);
+        TBLIS_ASSERT(dim_B < B->ndim);
+        TBLIS_ASSERT(W->len[i] == A->len[dim_A]);
+
+        W_like.stride[dim_A] += W->stride[i];
+    }
+
+    auto plan = make_mult_plan(A, idx_A, B, idx_B, C, idx_C, nullptr, &W_like);
+
+    T alpha = A->alpha<T>()*W->alpha<T>()*B->alpha<T>();
+    T beta = C->alpha<T>();
+
+    T* data_A = static_cast<T*>(A->data);
+    T* data_W = static_cast<T*>(W->data);
+    T* data_B = static_cast<T*>(B->data);
+    T* data_C = static_cast<T*>(C->data);
+
+    parallelize_if(
+    [&](const communicator& comm)
+    {
+        if (alpha == T(0))
+        {
+            if (beta == T(0))
+            {
+                internal::set<T>(comm, cfg, plan.len_C, T(0), data_C,
+                                 plan.stride_C);
+            }
+            else if (beta != T(1) || (is_complex<T>::value && C->conj))
+            {
+                internal::scale<T>(comm, cfg, plan.len_C,
+                                   beta, C->conj, data_C, plan.stride_C);
+            }
+        }
+        else
+        {
+            internal::mult<T>(comm, cfg, plan,
+                              alpha, A->conj, data_A,
+                                     W->conj, data_W, W_like.stride_AB, W_like.stride_ABC,
+                                     B->conj, data_B,
+                               beta, C->conj, data_C);
+        }
+    }, comm);
+
+    reset_scalar(C);
+}
+
+/*
+ * Contractions in a batch which would take at least this many flops are
+ * large enough to be worth running with all threads; smaller ones are
+ * each run by a single thread.
+ */
+constexpr stride_type batch_parallel_flops = 1l << 21;
+
+static void mult_batch(const tblis_comm* comm, const config& cfg,
+                       len_type nbatch,
+                       const tblis_tensor* A, const label_type* const* idx_A,
+                       const tblis_tensor* B, const label_type* const* idx_B,
+                             tblis_tensor* C, const label_type* const* idx_C)
+{
+    if (nbatch == 0) return;
+
+    std::vector<internal::mult_plan> plans;
+    plans.reserve(nbatch);
+
+    std::vector<std::pair<stride_type,len_type>> work(nbatch);
+    stride_type total_work = 0;
+
+    for (len_type i = 0;i < nbatch;i++)
+    {
+        plans.push_back(make_mult_plan(&A[i], idx_A[i], &B[i], idx_B[i], &C[i], idx_C[i]));
+
+        auto& plan = plans.back();
+        work[i] = {plan.n_AB*plan.n_AC*plan.n_BC*plan.n_ABC, i};
+        total_work += work[i].first;
+    }
+
+    /*
+     * Hand out the largest contractions first so that the small ones at
+     * the end can fill in any load imbalance.
+     */
+    std::sort(work.begin(), work.end(), std::greater<std::pair<stride_type,len_type>>());
+
+    parallelize_if(
+    [&](const communicator& comm)
+    {
+        auto nt = comm.num_threads();
+
+        /*
+         * Contractions which would leave the other threads idle on their
+         * own are run one at a time using every thread.
+         */
+        len_type nlarge = 0;
+        if (nt > 1)
+        {
+            while (nlarge < nbatch &&
+                   work[nlarge].first >= batch_parallel_flops &&
+                   work[nlarge].first*nt > total_work) nlarge++;
+        }
+
+        for (len_type i = 0;i < nlarge;i++)
+        {
+            auto idx = work[i].second;
+
+            TBLIS_WITH_TYPE_AS(A[idx].type, T,
+            {
+                mult_with_plan_as<T>(comm, cfg, plans[idx], &A[idx], &B[idx], &C[idx]);
+            })
+        }
+
+        comm.do_tasks_deferred(nbatch-nlarge, 0,
+        [&](communicator::deferred_task_set& tasks)
+        {
+            for (len_type i = nlarge;i < nbatch;i++)
+            {
+                tasks.visit(i-nlarge, work[i].first,
+                [&,i](const communicator& subcomm)
+                {
+                    auto idx = work[i].second;
+
+                    TBLIS_WITH_TYPE_AS(A[idx].type, T,
+                    {
+                        mult_with_plan_as<T>(subcomm, cfg, plans[idx], &A[idx], &B[idx], &C[idx]);
+                    })
+                });
+            }
+        });
+    }, comm);
+
+    for (len_type i = 0;i < nbatch;i++) reset_scalar(&C[i]);
+}
+
+struct tblis_mult_plan_s
+{
+    std::array<type_t,3> type;
+    const config& cfg;
+    internal::mult_plan plan;
+    std::array<len_vector,3> len;
+    std::array<stride_vector,3> stride;
+
+    tblis_mult_plan_s(const tblis_config* cfg_,
+                      const tblis_tensor* A, const label_type* idx_A,
+                      const tblis_tensor* B, const label_type* idx_B,
+                      const tblis_tensor* C, const label_type* idx_C)
+    : type{A->type, B->type, C->type}, cfg(get_config(cfg_)),
+      plan(make_mult_plan(A, idx_A, B, idx_B, C, idx_C)),
+      len{len_vector(A->len, A->len+A->ndim),
+          len_vector(B->len, B->len+B->ndim),
+          len_vector(C->len, C->len+C->ndim)},
+      stride{stride_vector(A->stride, A->stride+A->ndim),
+             stride_vector(B->stride, B->stride+B->ndim),
+             stride_vector(C->stride, C->stride+C->ndim)} {}
+
+    bool matches(unsigned i, const tblis_tensor* X) const
+    {
+        return X->type == type[i] &&
+               X->ndim == len[i].size() &&
+               std::equal(len[i].begin(), len[i].end(), X->len) &&
+               std::equal(stride[i].begin(), stride[i].end(), X->stride);
+    }
+};
+
+extern "C"
+{
+
+void tblis_tensor_mult(const tblis_comm* comm, const tblis_config* cfg,
+                       const tblis_tensor* A, const label_type* idx_A,
+                       const tblis_tensor* B, const label_type* idx_B,
+                             tblis_tensor* C, const label_type* idx_C)
+{
+    tblis_tensor_mult_with_options(comm, cfg, nullptr, A, idx_A, B, idx_B, C, idx_C);
+}
+
+void tblis_tensor_mult_with_options(const tblis_comm* comm, const tblis_config* cfg,
+                                    const tblis_mult_options* options,
+                                    const tblis_tensor* A, const label_type* idx_A,
+                                    const tblis_tensor* B, const label_type* idx_B,
+                                          tblis_tensor* C, const label_type* idx_C)
+{
+    check_types(A, B, C);
+
+    mult_with_plan(comm, get_config(cfg), options,
+                   make_mult_plan(A, idx_A, B, idx_B, C, idx_C),
+                   A, B, C);
+}
+
+void tblis_tensor_mult_epilogue(const tblis_comm* comm, const tblis_config* cfg,
+                                const tblis_tensor* A, const label_type* idx_A,
+                                const tblis_tensor* B, const label_type* idx_B,
+                                      tblis_tensor* C, const label_type* idx_C,
+                                const tblis_mult_epilogue* epilogue)
+{
+    check_types(A, B, C);
+    TBLIS_ASSERT(C->type == A->type);
+
+    TBLIS_WITH_TYPE_AS(A->type, T,
+    {
+        static const tblis_mult_epilogue no_epilogue = {};
+
+        mult_with_epilogue<T>(comm, get_config(cfg),
+                              A, idx_A, B, idx_B, C, idx_C,
+                              epilogue ? *epilogue : no_epilogue);
     })
 }
 
+void tblis_tensor_mult_weighted(const tblis_comm* comm, const tblis_config* cfg,
+                                const tblis_tensor* A, const label_type* idx_A,
+                                const tblis_tensor* W, const label_type* idx_W,
+                                const tblis_tensor* B, const label_type* idx_B,
+                                      tblis_tensor* C, const label_type* idx_C)
+{
+    TBLIS_ASSERT(A->type == W->type);
+    TBLIS_ASSERT(A->type == B->type);
+    TBLIS_ASSERT(A->type == C->type);
+
+    TBLIS_WITH_TYPE_AS(A->type, T,
+    {
+        mult_weighted<T>(comm, get_config(cfg),
+                         A, idx_A, W, idx_W, B, idx_B, C, idx_C);
+    })
+}
+
+tblis_mult_plan* tblis_tensor_mult_plan_create(const tblis_config* cfg,
+                                               const tblis_tensor* A, const label_type* idx_A,
+                                               const tblis_tensor* B, const label_type* idx_B,
+                                               const tblis_tensor* C, const label_type* idx_C)
+{
+    check_types(A, B, C);
+
+    auto plan = new tblis_mult_plan(cfg, A, idx_A, B, idx_B, C, idx_C);
+
+    /*
+     * Mixed-precision contractions are computed in the higher precision.
+     */
+    TBLIS_WITH_TYPE_AS(A->type, T,
+    {
+        if (C->type == A->type)
+            plan->plan.partition<T>(plan->cfg, tblis_get_num_threads());
+        else
+            plan->plan.partition<higher_precision_t<T,other_precision_t<T>>>(
+                plan->cfg, tblis_get_num_threads());
+    })
+
+    return plan;
+}
+
+void tblis_tensor_mult_plan_execute(const tblis_comm* comm, const tblis_mult_plan* plan,
+                                    const tblis_tensor* A, const tblis_tensor* B,
+                                          tblis_tensor* C)
+{
+    TBLIS_ASSERT(plan->matches(0, A));
+    TBLIS_ASSERT(plan->matches(1, B));
+    TBLIS_ASSERT(plan->matches(2, C));
+
+    mult_with_plan(comm, plan->cfg, nullptr, plan->plan, A, B, C);
+}
+
+void tblis_tensor_mult_plan_free(tblis_mult_plan* plan)
+{
+    delete plan;
+}
+
+void tblis_tensor_mult_batch(const tblis_comm* comm, const tblis_config* cfg,
+                             len_type nbatch,
+                             const tblis_tensor* A, const label_type* const* idx_A,
+                             const tblis_tensor* B, const label_type* const* idx_B,
+                                   tblis_tensor* C, const label_type* const* idx_C)
+{
+    for (len_type i = 0;i < nbatch;i++) check_types(&A[i], &B[i], &C[i]);
+
+    mult_batch(comm, get_config(cfg), nbatch, A, idx_A, B, idx_B, C, idx_C);
+}
+
 }
 
 template <typename T>
 void mult(const communicator& comm,
           T alpha, dpd_varray_view<const T> A, const label_type* idx_A_,
                    dpd_varray_view<const T> B, const label_type* idx_B_,
-          T  beta, dpd_varray_view<      T> C, const label_type* idx_C_)
+          T  beta, dpd_varray_view<      T> C, const label_type* idx_C_,
+          const tblis_mult_options* options)
 {
+    internal::mult_options_scope scope(options);
+
     unsigned nirrep = A.num_irreps();
     TBLIS_ASSERT(B.num_irreps() == nirrep);
     TBLIS_ASSERT(C.num_irreps() == nirrep);
@@ -293,15 +930,19 @@ void mult(const communicator& comm,
 template void mult(const communicator& comm, \
                    T alpha, dpd_varray_view<const T> A, const label_type* idx_A, \
                             dpd_varray_view<const T> B, const label_type* idx_B, \
-                   T  beta, dpd_varray_view<      T> C, const label_type* idx_C);
+                   T  beta, dpd_varray_view<      T> C, const label_type* idx_C, \
+                   const tblis_mult_options* options);
 #include "configs/foreach_type.h"
 
 template <typename T>
 void mult(const communicator& comm,
           T alpha, indexed_varray_view<const T> A, const label_type* idx_A_,
                    indexed_varray_view<const T> B, const label_type* idx_B_,
-          T  beta, indexed_varray_view<      T> C, const label_type* idx_C_)
+          T  beta, indexed_varray_view<      T> C, const label_type* idx_C_,
+          const tblis_mult_options* options)
 {
+    internal::mult_options_scope scope(options);
+
     unsigned ndim_A = A.dimension();
     unsigned ndim_B = B.dimension();
     unsigned ndim_C = C.dimension();
@@ -407,15 +1048,19 @@ void mult(const communicator& comm,
 template void mult(const communicator& comm, \
                    T alpha, indexed_varray_view<const T> A, const label_type* idx_A, \
                             indexed_varray_view<const T> B, const label_type* idx_B, \
-                   T  beta, indexed_varray_view<      T> C, const label_type* idx_C);
+                   T  beta, indexed_varray_view<      T> C, const label_type* idx_C, \
+                   const tblis_mult_options* options);
 #include "configs/foreach_type.h"
 
 template <typename T>
 void mult(const communicator& comm,
           T alpha, indexed_dpd_varray_view<const T> A, const label_type* idx_A_,
                    indexed_dpd_varray_view<const T> B, const label_type* idx_B_,
-          T  beta, indexed_dpd_varray_view<      T> C, const label_type* idx_C_)
+          T  beta, indexed_dpd_varray_view<      T> C, const label_type* idx_C_,
+          const tblis_mult_options* options)
 {
+    internal::mult_options_scope scope(options);
+
     unsigned nirrep = A.num_irreps();
     TBLIS_ASSERT(B.num_irreps() == nirrep);
     TBLIS_ASSERT(C.num_irreps() == nirrep);
@@ -537,7 +1182,8 @@ void mult(const communicator& comm,
 template void mult(const communicator& comm, \
                    T alpha, indexed_dpd_varray_view<const T> A, const label_type* idx_A, \
                             indexed_dpd_varray_view<const T> B, const label_type* idx_B, \
-                   T  beta, indexed_dpd_varray_view<      T> C, const label_type* idx_C);
+                   T  beta, indexed_dpd_varray_view<      T> C, const label_type* idx_C, \
+                   const tblis_mult_options* options);
 #include "configs/foreach_type.h"
 
 }
@@ -14,11 +14,166 @@ extern "C"
 
 #endif
 
+/*
+ * Algorithms for dense contractions (and for the dense contractions which
+ * make up DPD and indexed ones):
+ *
+ * TENSOR_GEMM    - TensorGEMM, the BLIS-based algorithm which packs directly
+ *                  from the tensors.
+ * TRANSPOSE_GEMM - copy A, B and C to matrices, multiply, and copy back.
+ * VECTOR         - a simple loop nest, parallelized over the batch (ABC)
+ *                  dimensions, which is fastest for many tiny contractions.
+ *
+ * AUTO chooses per call from the shapes and strides of the operands and the
+ * number of threads, while DEFAULT uses the library-wide setting.
+ */
+typedef enum
+{
+    MULT_ALGORITHM_DEFAULT        = 0,
+    MULT_ALGORITHM_AUTO           = 1,
+    MULT_ALGORITHM_TENSOR_GEMM    = 2,
+    MULT_ALGORITHM_TRANSPOSE_GEMM = 3,
+    MULT_ALGORITHM_VECTOR         = 4
+} mult_algorithm_t;
+
+/*
+ * Algorithms for DPD contractions:
+ *
+ * BLIS    - group the blocks which share irreps into single TensorGEMM calls.
+ * BLOCKED - contract one block of C at a time, distributing the blocks over
+ *           the threads.
+ * FULL    - densify the operands (a panel at a time) and contract those.
+ *
+ * AUTO chooses from the number and size of the blocks and the number of
+ * threads. For indexed DPD tensors it is the same as DEFAULT.
+ */
+typedef enum
+{
+    DPD_ALGORITHM_DEFAULT = 0,
+    DPD_ALGORITHM_AUTO    = 1,
+    DPD_ALGORITHM_BLIS    = 2,
+    DPD_ALGORITHM_BLOCKED = 3,
+    DPD_ALGORITHM_FULL    = 4
+} dpd_algorithm_t;
+
+/*
+ * Per-call options. Zero-initialization gives the defaults.
+ */
+typedef struct tblis_mult_options
+{
+    mult_algorithm_t algorithm;
+    dpd_algorithm_t dpd_algorithm;
+} tblis_mult_options;
+
+/*
+ * C may be in either the same precision as A and B, or the other precision of
+ * the same domain (e.g. single-precision A and B with double-precision C, or
+ * vice versa). Mixed-precision contractions are computed in the higher of the
+ * two precisions, with conversion folded into packing and the microkernel.
+ */
 void tblis_tensor_mult(const tblis_comm* comm, const tblis_config* cfg,
                        const tblis_tensor* A, const label_type* idx_A,
                        const tblis_tensor* B, const label_type* idx_B,
                              tblis_tensor* C, const label_type* idx_C);
 
+/*
+ * Same as tblis_tensor_mult, using the given algorithms (options may be
+ * NULL).
+ */
+void tblis_tensor_mult_with_options(const tblis_comm* comm, const tblis_config* cfg,
+                                    const tblis_mult_options* options,
+                                    const tblis_tensor* A, const label_type* idx_A,
+                                    const tblis_tensor* B, const label_type* idx_B,
+                                          tblis_tensor* C, const label_type* idx_C);
+
+/*
+ * A contraction plan caches all of the index analysis done by
+ * tblis_tensor_mult, along with the thread partitioning for
+ * tblis_get_num_threads() threads. It may be executed any number of times
+ * with tensors which differ from those used to create it only in their data
+ * pointers, scalars, and conjugation flags.
+ */
+typedef struct tblis_mult_plan_s tblis_mult_plan;
+
+tblis_mult_plan* tblis_tensor_mult_plan_create(const tblis_config* cfg,
+                                               const tblis_tensor* A, const label_type* idx_A,
+                                               const tblis_tensor* B, const label_type* idx_B,
+                                               const tblis_tensor* C, const label_type* idx_C);
+
+void tblis_tensor_mult_plan_execute(const tblis_comm* comm, const tblis_mult_plan* plan,
+                                    const tblis_tensor* A, const tblis_tensor* B,
+                                          tblis_tensor* C);
+
+void tblis_tensor_mult_plan_free(tblis_mult_plan* plan);
+
+/*
+ * Perform the nbatch independent contractions C[i] = A[i]*B[i] using a
+ * single parallel region. Small contractions are distributed over the
+ * threads whole (largest first), while any contraction big enough to keep
+ * all threads busy by itself is run in parallel. The tensors C[i] must not
+ * overlap each other or any of the inputs.
+ */
+void tblis_tensor_mult_batch(const tblis_comm* comm, const tblis_config* cfg,
+                             len_type nbatch,
+                             const tblis_tensor* A, const label_type* const* idx_A,
+                             const tblis_tensor* B, const label_type* const* idx_B,
+                                   tblis_tensor* C, const label_type* const* idx_C);
+
+/*
+ * A function applied in place to n contiguous values of the given type (that
+ * of C), with the data pointer given in tblis_mult_epilogue.
+ */
+typedef void (*tblis_epilogue_func)(void* data, type_t type, len_type n, void* values);
+
+/*
+ * Elementwise operations applied to the result of a contraction:
+ *
+ * C = func((alpha*A*B + beta*C + gamma*E) / (v_0(i) + v_1(j) + ...))
+ *
+ * add - E, a dense tensor of the same type and shape as C whose dimensions
+ *       go with the labels of C. gamma is its scalar (and it may be
+ *       conjugated).
+ *
+ * denom - one vector per dimension of C, each scaled by its scalar, making up
+ *         the denominator (e.g. the orbital energy denominators of many-body
+ *         methods). NULL entries are skipped.
+ *
+ * func - a function applied last, with func_data.
+ *
+ * Any of these may be NULL.
+ */
+typedef struct tblis_mult_epilogue
+{
+    const tblis_tensor* add;
+    const tblis_vector* const* denom;
+    tblis_epilogue_func func;
+    void* func_data;
+} tblis_mult_epilogue;
+
+/*
+ * Same as tblis_tensor_mult followed by the epilogue (A, B, and C must all be
+ * of the same type). When the contraction is done with TensorGEMM, the
+ * epilogue is applied by the microkernel as each tile of C is finished, so
+ * that C is only written once. Otherwise it is applied as a separate pass.
+ */
+void tblis_tensor_mult_epilogue(const tblis_comm* comm, const tblis_config* cfg,
+                                const tblis_tensor* A, const label_type* idx_A,
+                                const tblis_tensor* B, const label_type* idx_B,
+                                      tblis_tensor* C, const label_type* idx_C,
+                                const tblis_mult_epilogue* epilogue);
+
+/*
+ * C = alpha*A*diag(W)*B + beta*C, e.g. C_ij = sum_k A_ik W_k B_kj, where each
+ * index of W must appear in both A and B (it may also appear in C). W is
+ * applied while B is packed, so no scaled copy of A or B is formed. A, W, B,
+ * and C must all be of the same type, and the scalar of W multiplies alpha.
+ */
+void tblis_tensor_mult_weighted(const tblis_comm* comm, const tblis_config* cfg,
+                                const tblis_tensor* A, const label_type* idx_A,
+                                const tblis_tensor* W, const label_type* idx_W,
+                                const tblis_tensor* B, const label_type* idx_B,
+                                      tblis_tensor* C, const label_type* idx_C);
+
 #ifdef __cplusplus
 }
 #endif
@@ -27,45 +182,111 @@ void tblis_tensor_mult(const tblis_comm* comm, const tblis_config* cfg,
 
 template <typename T>
 void mult(T alpha, varray_view<const T> A, const label_type* idx_A,
+                   varray_view<const T> W, const label_type* idx_W,
                    varray_view<const T> B, const label_type* idx_B,
           T  beta,       varray_view<T> C, const label_type* idx_C)
 {
     tblis_tensor A_s(alpha, A);
+    tblis_tensor W_s(W);
     tblis_tensor B_s(B);
     tblis_tensor C_s(beta, C);
 
-    tblis_tensor_mult(nullptr, nullptr, &A_s, idx_A, &B_s, idx_B, &C_s, idx_C);
+    tblis_tensor_mult_weighted(nullptr, nullptr,
+                               &A_s, idx_A, &W_s, idx_W, &B_s, idx_B, &C_s, idx_C);
 }
 
 template <typename T>
 void mult(const communicator& comm,
           T alpha, varray_view<const T> A, const label_type* idx_A,
+                   varray_view<const T> W, const label_type* idx_W,
                    varray_view<const T> B, const label_type* idx_B,
           T  beta,       varray_view<T> C, const label_type* idx_C)
+{
+    tblis_tensor A_s(alpha, A);
+    tblis_tensor W_s(W);
+    tblis_tensor B_s(B);
+    tblis_tensor C_s(beta, C);
+
+    tblis_tensor_mult_weighted(comm, nullptr,
+                               &A_s, idx_A, &W_s, idx_W, &B_s, idx_B, &C_s, idx_C);
+}
+
+template <typename T>
+void mult(T alpha, varray_view<const T> A, const label_type* idx_A,
+                   varray_view<const T> B, const label_type* idx_B,
+          T  beta,       varray_view<T> C, const label_type* idx_C,
+          const tblis_mult_options* options = nullptr)
+{
+    tblis_tensor A_s(alpha, A);
+    tblis_tensor B_s(B);
+    tblis_tensor C_s(beta, C);
+
+    tblis_tensor_mult_with_options(nullptr, nullptr, options,
+                                   &A_s, idx_A, &B_s, idx_B, &C_s, idx_C);
+}
+
+template <typename T>
+void mult(const communicator& comm,
+          T alpha, varray_view<const T> A, const label_type* idx_A,
+                   varray_view<const T> B, const label_type* idx_B,
+          T  beta,       varray_view<T> C, const label_type* idx_C,
+          const tblis_mult_options* options = nullptr)
+{
+    tblis_tensor A_s(alpha, A);
+    tblis_tensor B_s(B);
+    tblis_tensor C_s(beta, C);
+
+    tblis_tensor_mult_with_options(comm, nullptr, options,
+                                   &A_s, idx_A, &B_s, idx_B, &C_s, idx_C);
+}
+
+template <typename T>
+void mult(T alpha, varray_view<const T> A, const label_type* idx_A,
+                   varray_view<const T> B, const label_type* idx_B,
+          other_precision_t<T> beta, varray_view<other_precision_t<T>> C,
+          const label_type* idx_C, const tblis_mult_options* options = nullptr)
+{
+    tblis_tensor A_s(alpha, A);
+    tblis_tensor B_s(B);
+    tblis_tensor C_s(beta, C);
+
+    tblis_tensor_mult_with_options(nullptr, nullptr, options,
+                                   &A_s, idx_A, &B_s, idx_B, &C_s, idx_C);
+}
+
+template <typename T>
+void mult(const communicator& comm,
+          T alpha, varray_view<const T> A, const label_type* idx_A,
+                   varray_view<const T> B, const label_type* idx_B,
+          other_precision_t<T> beta, varray_view<other_precision_t<T>> C,
+          const label_type* idx_C, const tblis_mult_options* options = nullptr)
 {
     tblis_tensor A_s(alpha, A);
     tblis_tensor B_s(B);
     tblis_tensor C_s(beta, C);
 
-    tblis_tensor_mult(comm, nullptr, &A_s, idx_A, &B_s, idx_B, &C_s, idx_C);
+    tblis_tensor_mult_with_options(comm, nullptr, options,
+                                   &A_s, idx_A, &B_s, idx_B, &C_s, idx_C);
 }
 
 template <typename T>
 void mult(const communicator& comm,
           T alpha, dpd_varray_view<const T> A, const label_type* idx_A,
                    dpd_varray_view<const T> B, const label_type* idx_B,
-          T  beta, dpd_varray_view<      T> C, const label_type* idx_C);
+          T  beta, dpd_varray_view<      T> C, const label_type* idx_C,
+          const tblis_mult_options* options = nullptr);
 
 template <typename T>
 void mult(T alpha, dpd_varray_view<const T> A, const label_type* idx_A,
                    dpd_varray_view<const T> B, const label_type* idx_B,
-          T  beta, dpd_varray_view<      T> C, const label_type* idx_C)
+          T  beta, dpd_varray_view<      T> C, const label_type* idx_C,
+          const tblis_mult_options* options = nullptr)
 {
     parallelize
     (
         [&](const communicator& comm)
         {
-            mult(comm, alpha, A, idx_A, B, idx_B, beta, C, idx_C);
+            mult(comm, alpha, A, idx_A, B, idx_B, beta, C, idx_C, options);
         },
         tblis_get_num_threads()
     );
@@ -75,18 +296,20 @@ template <typename T>
 void mult(const communicator& comm,
           T alpha, indexed_varray_view<const T> A, const label_type* idx_A,
                    indexed_varray_view<const T> B, const label_type* idx_B,
-          T  beta, indexed_varray_view<      T> C, const label_type* idx_C);
+          T  beta, indexed_varray_view<      T> C, const label_type* idx_C,
+          const tblis_mult_options* options = nullptr);
 
 template <typename T>
 void mult(T alpha, indexed_varray_view<const T> A, const label_type* idx_A,
                    indexed_varray_view<const T> B, const label_type* idx_B,
-          T  beta, indexed_varray_view<      T> C, const label_type* idx_C)
+          T  beta, indexed_varray_view<      T> C, const label_type* idx_C,
+          const tblis_mult_options* options = nullptr)
 {
     parallelize
     (
         [&](const communicator& comm)
         {
-            mult(comm, alpha, A, idx_A, B, idx_B, beta, C, idx_C);
+            mult(comm, alpha, A, idx_A, B, idx_B, beta, C, idx_C, options);
         },
         tblis_get_num_threads()
     );
@@ -96,18 +319,20 @@ template <typename T>
 void mult(const communicator& comm,
           T alpha, indexed_dpd_varray_view<const T> A, const label_type* idx_A,
                    indexed_dpd_varray_view<const T> B, const label_type* idx_B,
-          T  beta, indexed_dpd_varray_view<      T> C, const label_type* idx_C);
+          T  beta, indexed_dpd_varray_view<      T> C, const label_type* idx_C,
+          const tblis_mult_options* options = nullptr);
 
 template <typename T>
 void mult(T alpha, indexed_dpd_varray_view<const T> A, const label_type* idx_A,
                    indexed_dpd_varray_view<const T> B, const label_type* idx_B,
-          T  beta, indexed_dpd_varray_view<      T> C, const label_type* idx_C)
+          T  beta, indexed_dpd_varray_view<      T> C, const label_type* idx_C,
+          const tblis_mult_options* options = nullptr)
 {
     parallelize
     (
         [&](const communicator& comm)
         {
-            mult(comm, alpha, A, idx_A, B, idx_B, beta, C, idx_C);
+            mult(comm, alpha, A, idx_A, B, idx_B, beta, C, idx_C, options);
         },
         tblis_get_num_threads()
     );
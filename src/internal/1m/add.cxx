@@ -1,5 +1,7 @@
 #include "add.hpp"
 
+#include "memory/alignment.hpp"
+
 namespace tblis
 {
 namespace internal
@@ -26,18 +28,34 @@ void add(const communicator& comm, const config& cfg, len_type m, len_type n,
         const len_type MR = cfg.trans_mr.def<T>();
         const len_type NR = cfg.trans_nr.def<T>();
 
+        /*
+         * Each microkernel call only touches MR (NR) consecutive elements
+         * of a column of B (row of A), which may be less than a cache line,
+         * so go over blocks that are a few cache lines wide in both
+         * directions to use the rest of those lines before they are evicted.
+         */
+        const len_type MB = round_up(std::max<len_type>(MR, 2*64/sizeof(T)), MR);
+        const len_type NB = round_up(std::max<len_type>(NR, 2*64/sizeof(T)), NR);
+
         comm.distribute_over_threads({m, MR}, {n, NR},
         [&](len_type m_min, len_type m_max, len_type n_min, len_type n_max)
         {
-            for (len_type i = m_min;i < m_max;i += MR)
+            for (len_type i0 = m_min;i0 < m_max;i0 += MB)
+            for (len_type j0 = n_min;j0 < n_max;j0 += NB)
             {
-                len_type m_loc = std::min(m_max-i, MR);
-                for (len_type j = n_min;j < n_max;j += NR)
+                len_type i1 = std::min(m_max, i0+MB);
+                len_type j1 = std::min(n_max, j0+NB);
+
+                for (len_type i = i0;i < i1;i += MR)
                 {
-                    len_type n_loc = std::min(n_max-j, NR);
-                    cfg.trans_ukr.call<T>(m_loc, n_loc,
-                        alpha, conj_A, A + i*rs_A + j*cs_A, rs_A, cs_A,
-                         beta, conj_B, B + i*rs_B + j*cs_B, rs_B, cs_B);
+                    len_type m_loc = std::min(i1-i, MR);
+                    for (len_type j = j0;j < j1;j += NR)
+                    {
+                        len_type n_loc = std::min(j1-j, NR);
+                        cfg.trans_ukr.call<T>(m_loc, n_loc,
+                            alpha, conj_A, A + i*rs_A + j*cs_A, rs_A, cs_A,
+                             beta, conj_B, B + i*rs_B + j*cs_B, rs_B, cs_B);
+                    }
                 }
             }
         });
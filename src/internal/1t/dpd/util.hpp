@@ -67,9 +67,14 @@ class irrep_iterator
         }
 };
 
+/*
+ * Densify the part of A whose irreps along each dimension i lie in the range
+ * [first[i],last[i]), i.e. a contiguous slice of the full tensor.
+ */
 template <typename T, typename U>
 void block_to_full(const communicator& comm, const config& cfg,
-                   const dpd_varray_view<T>& A, varray<U>& A2)
+                   const dpd_varray_view<T>& A, const irrep_vector& first,
+                   const irrep_vector& last, varray<U>& A2)
 {
     unsigned nirrep = A.num_irreps();
     unsigned ndim_A = A.dimension();
@@ -78,7 +83,7 @@ void block_to_full(const communicator& comm, const config& cfg,
     matrix<len_type> off_A({ndim_A, nirrep});
     for (unsigned i = 0;i < ndim_A;i++)
     {
-        for (unsigned irrep = 0;irrep < nirrep;irrep++)
+        for (unsigned irrep = first[i];irrep < last[i];irrep++)
         {
             off_A[i][irrep] = len_A[i];
             len_A[i] += A.length(i, irrep);
@@ -93,7 +98,10 @@ void block_to_full(const communicator& comm, const config& cfg,
     {
         auto data_A2 = A2.data();
         for (unsigned i = 0;i < ndim_A;i++)
+        {
+            if (irreps_A[i] < first[i] || irreps_A[i] >= last[i]) return;
             data_A2 += off_A[i][irreps_A[i]]*A2.stride(i);
+        }
 
         add<U>(comm, cfg, {}, {}, local_A.lengths(),
                1, false, local_A.data(), {}, local_A.strides(),
@@ -101,9 +109,22 @@ void block_to_full(const communicator& comm, const config& cfg,
     });
 }
 
+template <typename T, typename U>
+void block_to_full(const communicator& comm, const config& cfg,
+                   const dpd_varray_view<T>& A, varray<U>& A2)
+{
+    block_to_full(comm, cfg, A, irrep_vector(A.dimension(), 0),
+                  irrep_vector(A.dimension(), A.num_irreps()), A2);
+}
+
+/*
+ * The inverse of block_to_full: scatter the slice A2 of the full tensor back
+ * into the blocks of A with irreps in [first[i],last[i]).
+ */
 template <typename T, typename U>
 void full_to_block(const communicator& comm, const config& cfg,
-                   const varray<U>& A2, const dpd_varray_view<T>& A)
+                   const varray<U>& A2, const dpd_varray_view<T>& A,
+                   const irrep_vector& first, const irrep_vector& last)
 {
     unsigned nirrep = A.num_irreps();
     unsigned ndim_A = A.dimension();
@@ -112,7 +133,7 @@ void full_to_block(const communicator& comm, const config& cfg,
     for (unsigned i = 0;i < ndim_A;i++)
     {
         len_type off = 0;
-        for (unsigned irrep = 0;irrep < nirrep;irrep++)
+        for (unsigned irrep = first[i];irrep < last[i];irrep++)
         {
             off_A[i][irrep] = off;
             off += A.length(i, irrep);
@@ -124,7 +145,10 @@ void full_to_block(const communicator& comm, const config& cfg,
     {
         auto data_A2 = A2.data();
         for (unsigned i = 0;i < ndim_A;i++)
+        {
+            if (irreps_A[i] < first[i] || irreps_A[i] >= last[i]) return;
             data_A2 += off_A[i][irreps_A[i]]*A2.stride(i);
+        }
 
         add<U>(comm, cfg, {}, {}, local_A.lengths(),
                1, false,        data_A2, {},      A2.strides(),
@@ -132,6 +156,14 @@ void full_to_block(const communicator& comm, const config& cfg,
     });
 }
 
+template <typename T, typename U>
+void full_to_block(const communicator& comm, const config& cfg,
+                   const varray<U>& A2, const dpd_varray_view<T>& A)
+{
+    full_to_block(comm, cfg, A2, A, irrep_vector(A.dimension(), 0),
+                  irrep_vector(A.dimension(), A.num_irreps()));
+}
+
 template <unsigned I, size_t N>
 void dense_total_lengths_and_strides_helper(std::array<len_vector,N>&,
                                             std::array<stride_vector,N>&) {}
@@ -1,5 +1,7 @@
 #include "add.hpp"
 
+#include "util/stats.h"
+
 namespace tblis
 {
 namespace internal
@@ -13,6 +15,8 @@ void add(const communicator& comm, const config& cfg, len_type n,
     comm.distribute_over_threads(n,
     [&](len_type n_min, len_type n_max)
     {
+        count_flops(KERNEL_LEVEL1, 2*(n_max-n_min));
+
         cfg.add_ukr.call<T>(n_max-n_min,
                             alpha, conj_A, A + n_min*inc_A, inc_A,
                              beta, conj_B, B + n_min*inc_B, inc_B);
@@ -1,5 +1,7 @@
 #include "dot.hpp"
 
+#include "util/stats.h"
+
 namespace tblis
 {
 namespace internal
@@ -17,6 +19,8 @@ void dot(const communicator& comm, const config& cfg, len_type n,
     {
         T micro_result = T();
 
+        count_flops(KERNEL_LEVEL1, 2*(n_max-n_min));
+
         cfg.dot_ukr.call<T>(n_max-n_min,
                             conj_A, A + n_min*inc_A, inc_A,
                             conj_B, B + n_min*inc_B, inc_B, micro_result);
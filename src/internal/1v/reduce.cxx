@@ -1,5 +1,7 @@
 #include "reduce.hpp"
 
+#include "util/stats.h"
+
 namespace tblis
 {
 namespace internal
@@ -18,6 +20,8 @@ void reduce(const communicator& comm, const config& cfg, reduce_t op, len_type n
         len_type micro_idx;
         reduce_init(op, micro_result, micro_idx);
 
+        count_flops(KERNEL_LEVEL1, n_max-n_min);
+
         cfg.reduce_ukr.call<T>(op, n_max-n_min,
                                A + n_min*inc_A, inc_A, micro_result, micro_idx);
 
@@ -1,5 +1,7 @@
 #include "scale.hpp"
 
+#include "util/stats.h"
+
 namespace tblis
 {
 namespace internal
@@ -12,6 +14,8 @@ void scale(const communicator& comm, const config& cfg, len_type n,
     comm.distribute_over_threads(n,
     [&](len_type n_min, len_type n_max)
     {
+        count_flops(KERNEL_LEVEL1, n_max-n_min);
+
         cfg.scale_ukr.call<T>(n_max-n_min, alpha, conj_A, A+n_min*inc_A, inc_A);
     });
 }
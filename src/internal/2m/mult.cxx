@@ -1,5 +1,7 @@
 #include "mult.hpp"
 
+#include "util/stats.h"
+
 namespace tblis
 {
 
@@ -13,8 +15,6 @@ void mult(const communicator& comm, const config& cfg,
                    bool conj_B, const T* B, stride_type inc_B,
           T  beta, bool conj_C,       T* C, stride_type inc_C)
 {
-    if (comm.master()) flops += 2*m*n;
-
     if (rs_A <= cs_A)
     {
         const len_type NF = cfg.addf_nf.def<T>();
@@ -22,6 +22,8 @@ void mult(const communicator& comm, const config& cfg,
         comm.distribute_over_threads(m,
         [&](len_type m_min, len_type m_max)
         {
+            count_flops(KERNEL_LEVEL2, 2*(m_max-m_min)*n);
+
             auto local_beta = beta;
             auto local_conj_C = conj_C;
 
@@ -49,6 +51,8 @@ void mult(const communicator& comm, const config& cfg,
         comm.distribute_over_threads({m, NF},
         [&](len_type m_min, len_type m_max)
         {
+            count_flops(KERNEL_LEVEL2, 2*(m_max-m_min)*n);
+
             for (len_type i = m_min;i < m_max;i += NF)
             {
                 cfg.dotf_ukr.call<T>(std::min(NF, m_max-i), n,
@@ -77,8 +81,6 @@ void mult(const communicator& comm, const config& cfg,
                    bool conj_B, const T* B, stride_type inc_B,
           T  beta, bool conj_C,       T* C, stride_type rs_C, stride_type cs_C)
 {
-    if (comm.master()) flops += 2*m*n;
-
     if (rs_C > cs_C)
     {
         std::swap(m, n);
@@ -93,6 +95,8 @@ void mult(const communicator& comm, const config& cfg,
     comm.distribute_over_threads(m, n,
     [&](len_type m_min, len_type m_max, len_type n_min, len_type n_max)
     {
+        count_flops(KERNEL_LEVEL2, 2*(m_max-m_min)*(n_max-n_min));
+
         T* Cs[16];
 
         for (len_type j = n_min;j < n_max;j += NF)
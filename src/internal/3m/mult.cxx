@@ -7,6 +7,10 @@
 
 #include "nodes/gemm.hpp"
 
+#include "internal/1t/dense/scale.hpp"
+
+#include <limits>
+
 namespace tblis
 {
 
@@ -16,6 +20,24 @@ MemoryPool BuffersForB(4096);
 namespace internal
 {
 
+/*
+ * The microkernels cannot conjugate C, so when beta*conj(C) is requested
+ * C is conjugated and scaled by beta up front and beta is set to one.
+ * Conjugation of A and B is folded into packing.
+ */
+template <typename T>
+void conj_C_and_scale(const communicator& comm, const config& cfg,
+                      len_type m, len_type n,
+                      T& beta, bool conj_C, T* C, stride_type rs_C, stride_type cs_C)
+{
+    if (!is_complex<T>::value || !conj_C || beta == T(0)) return;
+
+    scale(comm, cfg, {m, n}, beta, conj_C, C, {rs_C, cs_C});
+    comm.barrier();
+
+    beta = T(1);
+}
+
 template <typename T>
 void mult(const communicator& comm, const config& cfg,
           len_type m, len_type n, len_type k,
@@ -23,12 +45,15 @@ void mult(const communicator& comm, const config& cfg,
                    bool conj_B, const T* B, stride_type rs_B, stride_type cs_B,
           T  beta, bool conj_C,       T* C, stride_type rs_C, stride_type cs_C)
 {
-    TBLIS_ASSERT(!conj_A && !conj_B && !conj_C);
+    conj_C_and_scale(comm, cfg, m, n, beta, conj_C, C, rs_C, cs_C);
 
     normal_matrix<T> Av(m, k, const_cast<T*>(A), rs_A, cs_A);
     normal_matrix<T> Bv(k, n, const_cast<T*>(B), rs_B, cs_B);
     normal_matrix<T> Cv(m, n,                C , rs_C, cs_C);
 
+    Av.conj(conj_A);
+    Bv.conj(conj_B);
+
     GotoGEMM{}(comm, cfg, alpha, Av, Bv, beta, Cv);
 
     comm.barrier();
@@ -50,13 +75,17 @@ void mult(const communicator& comm, const config& cfg,
                    bool conj_B, const T* B, stride_type rs_B, stride_type cs_B,
           T  beta, bool conj_C,       T* C, stride_type rs_C, stride_type cs_C)
 {
-    TBLIS_ASSERT(!conj_A && !conj_B && !conj_C && !conj_D);
+    conj_C_and_scale(comm, cfg, m, n, beta, conj_C, C, rs_C, cs_C);
 
          normal_matrix<T> Av(m, k, const_cast<T*>(A), rs_A, cs_A);
     diag_scaled_matrix<T> Bv(k, n, const_cast<T*>(B), rs_B, cs_B,
                                 0, const_cast<T*>(D), inc_D);
          normal_matrix<T> Cv(m, n,                C , rs_C, cs_C);
 
+    Av.conj(conj_A);
+    Bv.conj(conj_B);
+    Bv.diag_conj(conj_D);
+
     GotoGEMM{}(comm, cfg, alpha, Av, Bv, beta, Cv);
 
     comm.barrier();
@@ -71,5 +100,118 @@ template void mult(const communicator& comm, const config& cfg, \
                    T  beta, bool conj_C,       T* C, stride_type rs_C, stride_type cs_C);
 #include "configs/foreach_type.h"
 
+template <typename T>
+using gemm_fn = void (*)(const char*, const char*,
+                         const int*, const int*, const int*,
+                         const T*, const T*, const int*,
+                                   const T*, const int*,
+                         const T*,       T*, const int*);
+
+static gemm_fn<   float> backend_gemm(const tblis_gemm_backend& b,    float) { return b.sgemm; }
+static gemm_fn<  double> backend_gemm(const tblis_gemm_backend& b,   double) { return b.dgemm; }
+static gemm_fn<scomplex> backend_gemm(const tblis_gemm_backend& b, scomplex) { return b.cgemm; }
+static gemm_fn<dcomplex> backend_gemm(const tblis_gemm_backend& b, dcomplex) { return b.zgemm; }
+
+/*
+ * The BLAS operation ('N', 'T', or 'C') and leading dimension with which an
+ * m x n matrix with the given strides can be passed to BLAS, if any.
+ */
+static bool blas_layout(len_type m, len_type n, stride_type rs, stride_type cs,
+                        bool conj, char& trans, int& ld)
+{
+    const stride_type max_ld = std::numeric_limits<int>::max();
+
+    if (!conj && (m == 1 || rs == 1) &&
+        (n == 1 || (cs >= m && cs <= max_ld)))
+    {
+        trans = 'N';
+        ld = (n == 1 ? m : cs);
+        return true;
+    }
+
+    if ((n == 1 || cs == 1) &&
+        (m == 1 || (rs >= n && rs <= max_ld)))
+    {
+        trans = (conj ? 'C' : 'T');
+        ld = (m == 1 ? n : rs);
+        return true;
+    }
+
+    return false;
+}
+
+template <typename T>
+bool has_gemm_backend()
+{
+    return backend_gemm(gemm_backend(), T()) != nullptr;
+}
+
+template <typename T>
+bool mult_backend(const communicator& comm,
+                  len_type m, len_type n, len_type k,
+                  T alpha, bool conj_A, const T* A, stride_type rs_A, stride_type cs_A,
+                           bool conj_B, const T* B, stride_type rs_B, stride_type cs_B,
+                  T  beta, bool conj_C,       T* C, stride_type rs_C, stride_type cs_C)
+{
+    auto gemm = backend_gemm(gemm_backend(), T());
+    if (!gemm) return false;
+
+    const len_type max_len = std::numeric_limits<int>::max();
+    if (m <= 0 || n <= 0 || k <= 0 ||
+        m > max_len || n > max_len || k > max_len) return false;
+
+    if (!is_complex<T>::value) conj_A = conj_B = conj_C = false;
+    if (conj_C && beta != T(0)) return false;
+
+    char trans_A, trans_B, trans_C;
+    int lda, ldb, ldc;
+
+    if (!blas_layout(m, n, rs_C, cs_C, false, trans_C, ldc)) return false;
+
+    /*
+     * BLAS only updates column-major matrices, so compute C^T = B^T A^T
+     * when C is row-major.
+     */
+    if (trans_C != 'N')
+    {
+        std::swap(m, n);
+        std::swap(A, B);
+        std::swap(conj_A, conj_B);
+        std::swap(rs_A, cs_B);
+        std::swap(cs_A, rs_B);
+        std::swap(rs_C, cs_C);
+
+        if (!blas_layout(m, n, rs_C, cs_C, false, trans_C, ldc) ||
+            trans_C != 'N') return false;
+    }
+
+    if (!blas_layout(m, k, rs_A, cs_A, conj_A, trans_A, lda) ||
+        !blas_layout(k, n, rs_B, cs_B, conj_B, trans_B, ldb)) return false;
+
+    /*
+     * The operands may have just been written by other threads.
+     */
+    comm.barrier();
+
+    if (comm.master())
+    {
+        int m_ = m, n_ = n, k_ = k;
+        gemm(&trans_A, &trans_B, &m_, &n_, &k_,
+             &alpha, A, &lda, B, &ldb, &beta, C, &ldc);
+    }
+
+    comm.barrier();
+    return true;
+}
+
+#define FOREACH_TYPE(T) \
+template bool has_gemm_backend<T>(); \
+template bool mult_backend(const communicator& comm, \
+                           len_type m, len_type n, len_type k, \
+                           T alpha, bool conj_A, const T* A, stride_type rs_A, stride_type cs_A, \
+                                    bool conj_B, const T* B, stride_type rs_B, stride_type cs_B, \
+                           T  beta, bool conj_C,       T* C, stride_type rs_C, stride_type cs_C);
+#include "configs/foreach_type.h"
+
 }
 }
@@ -4,6 +4,7 @@
 #include "util/basic_types.h"
 #include "util/thread.h"
 #include "configs/configs.hpp"
+#include "iface/3m/gemm_backend.h"
 
 namespace tblis
 {
@@ -25,6 +26,24 @@ void mult(const communicator& comm, const config& cfg,
                    bool conj_B, const T* B, stride_type rs_B, stride_type cs_B,
           T  beta, bool conj_C,       T* C, stride_type rs_C, stride_type cs_C);
 
+const tblis_gemm_backend& gemm_backend();
+
+template <typename T>
+bool has_gemm_backend();
+
+/*
+ * Compute C = alpha*A*B + beta*C with the external GEMM backend, if there is
+ * one for T and the matrices can be passed to it without copying. Returns
+ * false (having done nothing) otherwise. The backend is called by the master
+ * thread only.
+ */
+template <typename T>
+bool mult_backend(const communicator& comm,
+                  len_type m, len_type n, len_type k,
+                  T alpha, bool conj_A, const T* A, stride_type rs_A, stride_type cs_A,
+                           bool conj_B, const T* B, stride_type rs_B, stride_type cs_B,
+                  T  beta, bool conj_C,       T* C, stride_type rs_C, stride_type cs_C);
+
 }
 }
 
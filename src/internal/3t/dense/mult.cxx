@@ -1,9 +1,14 @@
 #include "mult.hpp"
 
+#include "util/env.hpp"
 #include "util/gemm_thread.hpp"
 #include "util/tensor.hpp"
 
 #include "nodes/gemm.hpp"
+#include "nodes/epilogue.hpp"
+#include "nodes/strassen.hpp"
+
+#include "matrix/diag_scaled_tensor_matrix.hpp"
 
 #include "internal/1t/dense/add.hpp"
 #include "internal/1t/dense/dot.hpp"
@@ -22,6 +27,35 @@ namespace internal
 {
 
 impl_t impl = BLIS_BASED;
+unsigned strassen_levels = envtol("TBLIS_STRASSEN", 0);
+len_type strassen_min_length = envtol("TBLIS_STRASSEN_MIN_LENGTH", 4000);
+
+enum
+{
+    HAS_NONE = 0x0,
+    HAS_AB   = 0x1,
+    HAS_AC   = 0x2,
+    HAS_BC   = 0x4,
+    HAS_ABC  = 0x8
+};
+
+/*
+ * The microkernels cannot conjugate C, so when beta*conj(C) is requested
+ * C is conjugated and scaled by beta up front and beta is set to one.
+ * Conjugation of A and B is folded into packing.
+ */
+template <typename T, typename U>
+void conj_C_and_scale(const communicator& comm, const config& cfg,
+                      const len_vector& len_C,
+                      T& beta, bool conj_C, U* C, const stride_vector& stride_C)
+{
+    if (!is_complex<T>::value || !conj_C || beta == T(0)) return;
+
+    scale(comm, cfg, len_C, U(beta), conj_C, C, stride_C);
+    comm.barrier();
+
+    beta = T(1);
+}
 
 template <typename T>
 void mult_blis(const communicator& comm, const config& cfg,
@@ -67,8 +101,6 @@ void mult_blis(const communicator& comm, const config& cfg,
     auto m2 = stl_ext::prod(len_AC)/m;
     auto n2 = stl_ext::prod(len_AB)/n;
 
-    if (comm.master()) flops += 2*m*m2*n*n2;
-
     unsigned nt_l, nt_m;
     std::tie(nt_l, nt_m) = partition_2x2(comm.num_threads(), m2, m2, m, m);
 
@@ -156,8 +188,6 @@ void mult_blis(const communicator& comm, const config& cfg,
     len_type m2 = stl_ext::prod(len_AC)/m;
     len_type n2 = stl_ext::prod(len_BC)/n;
 
-    if (comm.master()) flops += 2*m*m2*n*n2;
-
     unsigned nt_l, nt_m;
     std::tie(nt_l, nt_m) = partition_2x2(comm.num_threads(), m2*n2, m2*n2, m*n, m*n);
 
@@ -194,75 +224,403 @@ void mult_blis(const communicator& comm, const config& cfg,
 }
 
 template <typename T>
-void mult_blis(const communicator& comm, const config& cfg,
-                   const len_vector& len_AB,
-                   const len_vector& len_AC,
-                   const len_vector& len_BC,
-                   T alpha, bool conj_A, const T* A,
-                   const stride_vector& stride_A_AB,
-                   const stride_vector& stride_A_AC,
-                            bool conj_B, const T* B,
-                   const stride_vector& stride_B_AB,
-                   const stride_vector& stride_B_BC,
-                   T  beta, bool conj_C,       T* C,
-                   const stride_vector& stride_C_AC,
-                   const stride_vector& stride_C_BC)
+void tensor_gemm(const communicator& comm, const config& cfg,
+                 const gemm_thread_config* thread_config, unsigned levels,
+                 T alpha, const tensor_matrix<T>& at, const tensor_matrix<T>& bt,
+                 T  beta, const tensor_matrix<T>& ct)
 {
-    //TODO
-    TBLIS_ASSERT(!conj_A && !conj_B && !conj_C);
+    if (levels > 0)
+    {
+        StrassenGEMM gemm;
+        gemm.levels = levels;
+        gemm(comm, cfg, alpha, at, bt, ct);
+    }
+    else
+    {
+        TensorGEMM gemm;
+        gemm.thread_config = thread_config;
+        gemm(comm, cfg, alpha, at, bt, beta, ct);
+    }
+}
 
-    auto reorder_AC = detail::sort_by_stride(stride_C_AC, stride_A_AC);
-    auto reorder_BC = detail::sort_by_stride(stride_C_BC, stride_B_BC);
-    auto reorder_AB = detail::sort_by_stride(stride_A_AB, stride_B_AB);
+/*
+ * Mixed precision, where the packing and microkernel nodes take care of
+ * converting A and B or C to and from the computational type T.
+ */
+template <typename T, typename TAB, typename TC>
+void tensor_gemm(const communicator& comm, const config& cfg,
+                 const gemm_thread_config* thread_config, unsigned levels,
+                 T alpha, const tensor_matrix<TAB>& at, const tensor_matrix<TAB>& bt,
+                 T  beta, const tensor_matrix<TC>& ct)
+{
+    TBLIS_ASSERT(levels == 0);
 
-    unsigned unit_A_AC = unit_dim(stride_A_AC, reorder_AC);
-    unsigned unit_C_AC = unit_dim(stride_C_AC, reorder_AC);
-    unsigned unit_B_BC = unit_dim(stride_B_BC, reorder_BC);
-    unsigned unit_C_BC = unit_dim(stride_C_BC, reorder_BC);
-    unsigned unit_A_AB = unit_dim(stride_A_AB, reorder_AB);
-    unsigned unit_B_AB = unit_dim(stride_B_AB, reorder_AB);
+    TensorGEMM gemm;
+    gemm.thread_config = thread_config;
+    gemm(comm, cfg, alpha, at, bt, beta, ct);
+}
 
-    TBLIS_ASSERT(unit_C_AC == 0 || unit_C_AC == len_AC.size());
-    TBLIS_ASSERT(unit_C_BC == 0 || unit_C_BC == len_BC.size());
-    TBLIS_ASSERT(unit_A_AB == 0 || unit_B_AB == 0 ||
-                 (unit_A_AB == len_AB.size() && unit_B_AB == len_AB.size()));
+template <typename T>
+void tensor_gemm(const communicator& comm, const config& cfg,
+                 const gemm_thread_config* thread_config, unsigned levels,
+                 T alpha, const normal_matrix<T>& at, const normal_matrix<T>& bt,
+                 T  beta, const normal_matrix<T>& ct)
+{
+    TBLIS_ASSERT(levels == 0);
 
-    bool pack_M_3d = unit_A_AC > 0 && unit_A_AC < len_AC.size();
-    bool pack_N_3d = unit_B_BC > 0 && unit_B_BC < len_BC.size();
-    bool pack_K_3d = (unit_A_AB > 0 && unit_A_AB < len_AB.size()) ||
-                     (unit_B_AB > 0 && unit_B_AB < len_AB.size());
+    GotoGEMM gemm;
+    gemm.thread_config = thread_config;
+    gemm(comm, cfg, alpha, at, bt, beta, ct);
+}
 
-    if (pack_M_3d)
-        std::rotate(reorder_AC.begin()+1, reorder_AC.begin()+unit_A_AC, reorder_AC.end());
+/*
+ * Run the GEMM for each L, where at, bt, and ct are A_MK, B_KN, and C_MN
+ * with the data pointers to be filled in.
+ */
+template <typename T, typename TAB, typename TC, typename MatrixAB, typename MatrixC>
+void tensor_gemm_batch(const communicator& comm, const config& cfg, const mult_plan& plan,
+                       const gemm_thread_config* thread_config, unsigned levels,
+                       T alpha, const TAB* A, MatrixAB& at,
+                                const TAB* B, MatrixAB& bt,
+                       T  beta,        TC* C, MatrixC& ct)
+{
+    if (!(plan.groups & HAS_ABC))
+    {
+        tensor_gemm(comm, cfg, thread_config, levels,
+                    alpha, at, bt, beta, ct);
+        return;
+    }
 
-    if (pack_N_3d)
-        std::rotate(reorder_BC.begin()+1, reorder_BC.begin()+unit_B_BC, reorder_BC.end());
+    unsigned nt_L = plan.nt_L;
+    if (!thread_config)
+    {
+        unsigned nt_MN;
+        std::tie(nt_L, nt_MN) =
+            partition_2x2(comm.num_threads(), plan.n_ABC, plan.n_ABC,
+                          plan.n_AC*plan.n_BC, plan.n_AC*plan.n_BC);
+    }
 
-    if (pack_K_3d)
-        std::rotate(reorder_AB.begin()+1, reorder_AB.begin()+std::max(unit_A_AB, unit_B_AB), reorder_AB.end());
+    auto subcomm = comm.gang(TCI_EVENLY, nt_L);
+
+    subcomm.distribute_over_gangs(plan.n_ABC,
+    [&](len_type l_min, len_type l_max)
+    {
+        viterator<3> iter_L(plan.len_L, plan.stride_A_L, plan.stride_B_L, plan.stride_C_L);
+
+        auto A1 = A;
+        auto B1 = B;
+        auto C1 = C;
+
+        iter_L.position(l_min, A1, B1, C1);
+
+        for (len_type l = l_min;l < l_max;l++)
+        {
+            iter_L.next(A1, B1, C1);
+
+            at.data(const_cast<TAB*>(A1));
+            bt.data(const_cast<TAB*>(B1));
+            ct.data(C1);
+
+            tensor_gemm(subcomm, cfg, thread_config, levels,
+                        alpha, at, bt, beta, ct);
+        }
+    });
+}
+
+/*
+ * When A_MK, B_KN, and C_MN are plain matrices, run the normal GEMM on them
+ * directly, skipping the scatter vectors (only when A, B, and C are all of
+ * the same type).
+ */
+template <typename T, typename TAB, typename TC>
+bool mult_normal(const communicator&, const config&, const mult_plan&,
+                 const gemm_thread_config*,
+                 T, bool, const TAB*, bool, const TAB*, T, TC*)
+{
+    return false;
+}
+
+template <typename T>
+bool mult_normal(const communicator& comm, const config& cfg, const mult_plan& plan,
+                 const gemm_thread_config* thread_config,
+                 T alpha, bool conj_A, const T* A,
+                          bool conj_B, const T* B,
+                 T  beta,                    T* C)
+{
+    if (!plan.is_matrix) return false;
+
+    normal_matrix<T> at(plan.n_AC, plan.n_AB, const_cast<T*>(A), plan.rs_A, plan.cs_A);
+    normal_matrix<T> bt(plan.n_AB, plan.n_BC, const_cast<T*>(B), plan.rs_B, plan.cs_B);
+    normal_matrix<T> ct(plan.n_AC, plan.n_BC,                C , plan.rs_C, plan.cs_C);
+
+    at.conj(conj_A);
+    bt.conj(conj_B);
+
+    tensor_gemm_batch(comm, cfg, plan, thread_config, 0,
+                      alpha, A, at, B, bt, beta, C, ct);
+    return true;
+}
+
+/*
+ * Whether Strassen's algorithm is to be used (when A, B, and C are all of the
+ * same type), see strassen_levels.
+ */
+static bool use_strassen(const mult_plan& plan)
+{
+    return strassen_levels > 0 &&
+           std::min({plan.n_AC, plan.n_BC, plan.n_AB}) >= strassen_min_length;
+}
+
+/*
+ * The general case, C_MN(L) = A_MK(L) B_KN(L), where the lengths, strides, and
+ * thread partitioning of the matrices have already been worked out in the plan.
+ * A and B may be in a different precision than C, in which case the
+ * computation is done in the higher of the two (T).
+ */
+template <typename T, typename TAB, typename TC>
+void mult_blis(const communicator& comm, const config& cfg, const mult_plan& plan,
+               T alpha, bool conj_A, const TAB* A,
+                        bool conj_B, const TAB* B,
+               T  beta, bool conj_C,        TC* C)
+{
+    conj_C_and_scale(comm, cfg, plan.len_C, beta, conj_C, C, plan.stride_C);
+
+    bool planned = comm.num_threads() == plan.num_threads;
+    auto thread_config = planned ? &plan.thread_config : nullptr;
+
+    /*
+     * Strassen's algorithm updates parts of C several times, so apply beta
+     * up front.
+     */
+    bool strassen = std::is_same<TAB,TC>::value && use_strassen(plan);
+
+    if (!strassen && mult_normal(comm, cfg, plan, thread_config,
+                                 alpha, conj_A, A, conj_B, B, beta, C))
+        return;
+
+    if (strassen && beta != T(1))
+    {
+        if (beta == T(0))
+            set(comm, cfg, plan.len_C, TC(0), C, plan.stride_C);
+        else
+            scale(comm, cfg, plan.len_C, TC(beta), false, C, plan.stride_C);
+
+        comm.barrier();
+        beta = T(1);
+    }
+
+    /*
+     * The 3D packing order depends on where a block starts, so the blocks
+     * which are added together by Strassen's algorithm would not line up. It
+     * also depends on the size of the elements, so with mixed precision the
+     * order for C would not match that for A or B.
+     */
+    bool mixed = !std::is_same<TAB,TC>::value;
+    bool pack_M_3d = plan.pack_M_3d && !strassen && !mixed;
+    bool pack_N_3d = plan.pack_N_3d && !strassen && !mixed;
+    bool pack_K_3d = plan.pack_K_3d && !strassen;
+
+    tensor_matrix<TAB> at(plan.len_M, plan.len_K, const_cast<TAB*>(A),
+                          plan.stride_A_M, plan.stride_A_K,
+                          pack_M_3d, pack_K_3d);
+
+    tensor_matrix<TAB> bt(plan.len_K, plan.len_N, const_cast<TAB*>(B),
+                          plan.stride_B_K, plan.stride_B_N,
+                          pack_K_3d, pack_N_3d);
+
+    tensor_matrix<TC> ct(plan.len_M, plan.len_N, C,
+                         plan.stride_C_M, plan.stride_C_N,
+                         pack_M_3d, pack_N_3d);
+
+    at.conj(conj_A);
+    bt.conj(conj_B);
+
+    unsigned levels = strassen ? strassen_levels : 0;
+
+    tensor_gemm_batch(comm, cfg, plan, thread_config, levels,
+                      alpha, A, at, B, bt, beta, C, ct);
+}
+
+/*
+ * The general case with the epilogue fused into the microkernel. The 3D
+ * packing order is not used for M and N, since the blocks of E and D would
+ * not line up with those of C.
+ */
+template <typename T>
+void mult_blis(const communicator& comm, const config& cfg, const mult_plan& plan,
+               T alpha, bool conj_A, const T* A,
+                        bool conj_B, const T* B,
+               T  beta, bool conj_C,       T* C,
+               const mult_epilogue<T>& epilogue)
+{
+    typedef epilogue_matrix<tensor_matrix<T>> matrix_type;
+    constexpr unsigned NUM_TERMS = matrix_type::NUM_TERMS;
+
+    conj_C_and_scale(comm, cfg, plan.len_C, beta, conj_C, C, plan.stride_C);
+
+    bool planned = comm.num_threads() == plan.num_threads;
+    auto thread_config = planned ? &plan.thread_config : nullptr;
+
+    tensor_matrix<T> at(plan.len_M, plan.len_K, const_cast<T*>(A),
+                        plan.stride_A_M, plan.stride_A_K,
+                        false, plan.pack_K_3d);
+
+    tensor_matrix<T> bt(plan.len_K, plan.len_N, const_cast<T*>(B),
+                        plan.stride_B_K, plan.stride_B_N,
+                        plan.pack_K_3d, false);
+
+    at.conj(conj_A);
+    bt.conj(conj_B);
+
+    std::array<T*, NUM_TERMS> data = {C, const_cast<T*>(epilogue.E),
+                                      const_cast<T*>(epilogue.D[0]),
+                                      const_cast<T*>(epilogue.D[1])};
+
+    matrix_type ct(epilogue.op);
+
+    ct.term(matrix_type::OUTPUT,
+            tensor_matrix<T>(plan.len_M, plan.len_N, C,
+                             plan.stride_C_M, plan.stride_C_N));
+
+    for (unsigned t = 1;t < NUM_TERMS;t++)
+    {
+        ct.term(t, tensor_matrix<T>(plan.len_M, plan.len_N, data[t],
+                                    stl_ext::permuted(epilogue.stride_AC[t-1], plan.reorder_M),
+                                    stl_ext::permuted(epilogue.stride_BC[t-1], plan.reorder_N)));
+    }
+
+    if (!(plan.groups & HAS_ABC))
+    {
+        EpilogueGEMM gemm;
+        gemm.thread_config = thread_config;
+        gemm(comm, cfg, alpha, at, bt, beta, ct);
+        return;
+    }
+
+    unsigned nt_L = plan.nt_L;
+    if (!thread_config)
+    {
+        unsigned nt_MN;
+        std::tie(nt_L, nt_MN) =
+            partition_2x2(comm.num_threads(), plan.n_ABC, plan.n_ABC,
+                          plan.n_AC*plan.n_BC, plan.n_AC*plan.n_BC);
+    }
+
+    auto subcomm = comm.gang(TCI_EVENLY, nt_L);
+
+    subcomm.distribute_over_gangs(plan.n_ABC,
+    [&](len_type l_min, len_type l_max)
+    {
+        viterator<6> iter_L(plan.len_L, plan.stride_A_L, plan.stride_B_L, plan.stride_C_L,
+                            stl_ext::permuted(epilogue.stride_ABC[0], plan.reorder_L),
+                            stl_ext::permuted(epilogue.stride_ABC[1], plan.reorder_L),
+                            stl_ext::permuted(epilogue.stride_ABC[2], plan.reorder_L));
+
+        auto A1 = A;
+        auto B1 = B;
+        auto data1 = data;
 
-    tensor_matrix<T> at(stl_ext::permuted(len_AC, reorder_AC),
-                        stl_ext::permuted(len_AB, reorder_AB),
-                        const_cast<T*>(A),
-                        stl_ext::permuted(stride_A_AC, reorder_AC),
-                        stl_ext::permuted(stride_A_AB, reorder_AB),
-                        pack_M_3d, pack_K_3d);
-
-    tensor_matrix<T> bt(stl_ext::permuted(len_AB, reorder_AB),
-                        stl_ext::permuted(len_BC, reorder_BC),
-                        const_cast<T*>(B),
-                        stl_ext::permuted(stride_B_AB, reorder_AB),
-                        stl_ext::permuted(stride_B_BC, reorder_BC),
-                        pack_K_3d, pack_N_3d);
-
-    tensor_matrix<T> ct(stl_ext::permuted(len_AC, reorder_AC),
-                        stl_ext::permuted(len_BC, reorder_BC),
-                        C,
-                        stl_ext::permuted(stride_C_AC, reorder_AC),
-                        stl_ext::permuted(stride_C_BC, reorder_BC),
-                        pack_M_3d, pack_N_3d);
-
-    TensorGEMM{}(comm, cfg, alpha, at, bt, beta, ct);
+        iter_L.position(l_min, A1, B1, data1[0], data1[1], data1[2], data1[3]);
+
+        for (len_type l = l_min;l < l_max;l++)
+        {
+            iter_L.next(A1, B1, data1[0], data1[1], data1[2], data1[3]);
+
+            at.data(const_cast<T*>(A1));
+            bt.data(const_cast<T*>(B1));
+
+            for (unsigned t = 0;t < NUM_TERMS;t++)
+                if (ct.has_term(t)) ct.term(t).data(data1[t]);
+
+            EpilogueGEMM gemm;
+            gemm.thread_config = thread_config;
+            gemm(subcomm, cfg, alpha, at, bt, beta, ct);
+        }
+    });
+}
+
+/*
+ * The general case with B scaled by W while it is packed. The scatter vectors
+ * and weights for B are gathered in the plain order of K and N, so the 3D
+ * packing order is only used for M.
+ */
+template <typename T>
+void mult_blis(const communicator& comm, const config& cfg, const mult_plan& plan,
+               T alpha, bool conj_A, const T* A,
+                        bool conj_W, const T* W,
+               const stride_vector& stride_W_AB,
+               const stride_vector& stride_W_ABC,
+                        bool conj_B, const T* B,
+               T  beta, bool conj_C,       T* C)
+{
+    conj_C_and_scale(comm, cfg, plan.len_C, beta, conj_C, C, plan.stride_C);
+
+    bool planned = comm.num_threads() == plan.num_threads;
+    auto thread_config = planned ? &plan.thread_config : nullptr;
+
+    tensor_matrix<T> at(plan.len_M, plan.len_K, const_cast<T*>(A),
+                        plan.stride_A_M, plan.stride_A_K,
+                        plan.pack_M_3d, false);
+
+    diag_scaled_tensor_matrix<T> bt(plan.len_K, plan.len_N, const_cast<T*>(B),
+                                    plan.stride_B_K, plan.stride_B_N,
+                                    0, const_cast<T*>(W),
+                                    stl_ext::permuted(stride_W_AB, plan.reorder_K));
+
+    tensor_matrix<T> ct(plan.len_M, plan.len_N, C,
+                        plan.stride_C_M, plan.stride_C_N,
+                        plan.pack_M_3d, false);
+
+    at.conj(conj_A);
+    bt.conj(conj_B);
+    bt.diag_conj(conj_W);
+
+    if (!(plan.groups & HAS_ABC))
+    {
+        TensorGEMM gemm;
+        gemm.thread_config = thread_config;
+        gemm(comm, cfg, alpha, at, bt, beta, ct);
+        return;
+    }
+
+    unsigned nt_L = plan.nt_L;
+    if (!thread_config)
+    {
+        unsigned nt_MN;
+        std::tie(nt_L, nt_MN) =
+            partition_2x2(comm.num_threads(), plan.n_ABC, plan.n_ABC,
+                          plan.n_AC*plan.n_BC, plan.n_AC*plan.n_BC);
+    }
+
+    auto subcomm = comm.gang(TCI_EVENLY, nt_L);
+
+    subcomm.distribute_over_gangs(plan.n_ABC,
+    [&](len_type l_min, len_type l_max)
+    {
+        viterator<4> iter_L(plan.len_L, plan.stride_A_L, plan.stride_B_L, plan.stride_C_L,
+                            stl_ext::permuted(stride_W_ABC, plan.reorder_L));
+
+        auto A1 = A;
+        auto B1 = B;
+        auto C1 = C;
+        auto W1 = W;
+
+        iter_L.position(l_min, A1, B1, C1, W1);
+
+        for (len_type l = l_min;l < l_max;l++)
+        {
+            iter_L.next(A1, B1, C1, W1);
+
+            at.data(const_cast<T*>(A1));
+            bt.data(const_cast<T*>(B1));
+            bt.diag(const_cast<T*>(W1));
+            ct.data(C1);
+
+            TensorGEMM gemm;
+            gemm.thread_config = thread_config;
+            gemm(subcomm, cfg, alpha, at, bt, beta, ct);
+        }
+    });
 }
 
 template <typename T>
@@ -315,8 +673,6 @@ void mult_blis(const communicator& comm, const config& cfg,
     len_type m2 = stl_ext::prod(len_AC)/m;
     len_type n2 = stl_ext::prod(len_AB)/n;
 
-    if (comm.master()) flops += 2*m*m2*n*n2*l;
-
     unsigned nt_l, nt_m;
     std::tie(nt_l, nt_m) = partition_2x2(comm.num_threads(), l*m2, l*m2, m, m);
 
@@ -415,8 +771,6 @@ void mult_blis(const communicator& comm, const config& cfg,
     len_type m2 = stl_ext::prod(len_AC)/m;
     len_type n2 = stl_ext::prod(len_BC)/n;
 
-    if (comm.master()) flops += 2*m*m2*n*n2*l;
-
     unsigned nt_l, nt_m;
     std::tie(nt_l, nt_m) = partition_2x2(comm.num_threads(), l*m2*n2, l*m2*n2, m*n, m*n);
 
@@ -456,120 +810,6 @@ void mult_blis(const communicator& comm, const config& cfg,
     });
 }
 
-template <typename T>
-void mult_blis(const communicator& comm, const config& cfg,
-               const len_vector& len_AB,
-               const len_vector& len_AC,
-               const len_vector& len_BC,
-               const len_vector& len_ABC,
-               T alpha, bool conj_A, const T* A,
-               const stride_vector& stride_A_AB,
-               const stride_vector& stride_A_AC,
-               const stride_vector& stride_A_ABC,
-                        bool conj_B, const T* B,
-               const stride_vector& stride_B_AB,
-               const stride_vector& stride_B_BC,
-               const stride_vector& stride_B_ABC,
-               T  beta, bool conj_C,       T* C,
-               const stride_vector& stride_C_AC,
-               const stride_vector& stride_C_BC,
-               const stride_vector& stride_C_ABC)
-{
-    //TODO
-    TBLIS_ASSERT(!conj_A && !conj_B && !conj_C);
-
-    auto reorder_AC = detail::sort_by_stride(stride_C_AC, stride_A_AC);
-    auto reorder_BC = detail::sort_by_stride(stride_C_BC, stride_B_BC);
-    auto reorder_AB = detail::sort_by_stride(stride_A_AB, stride_B_AB);
-    auto reorder_ABC = detail::sort_by_stride(stride_C_ABC, stride_A_ABC, stride_B_ABC);
-
-    unsigned unit_A_AC = unit_dim(stride_A_AC, reorder_AC);
-    unsigned unit_C_AC = unit_dim(stride_C_AC, reorder_AC);
-    unsigned unit_B_BC = unit_dim(stride_B_BC, reorder_BC);
-    unsigned unit_C_BC = unit_dim(stride_C_BC, reorder_BC);
-    unsigned unit_A_AB = unit_dim(stride_A_AB, reorder_AB);
-    unsigned unit_B_AB = unit_dim(stride_B_AB, reorder_AB);
-
-    TBLIS_ASSERT(unit_C_AC == 0 || unit_C_AC == len_AC.size());
-    TBLIS_ASSERT(unit_C_BC == 0 || unit_C_BC == len_BC.size());
-    TBLIS_ASSERT(unit_A_AB == 0 || unit_B_AB == 0 ||
-                 (unit_A_AB == len_AB.size() && unit_B_AB == len_AB.size()));
-
-    bool pack_M_3d = unit_A_AC > 0 && unit_A_AC < len_AC.size();
-    bool pack_N_3d = unit_B_BC > 0 && unit_B_BC < len_BC.size();
-    bool pack_K_3d = (unit_A_AB > 0 && unit_A_AB < len_AB.size()) ||
-                     (unit_B_AB > 0 && unit_B_AB < len_AB.size());
-
-    if (pack_M_3d)
-        std::rotate(reorder_AC.begin()+1, reorder_AC.begin()+unit_A_AC, reorder_AC.end());
-
-    if (pack_N_3d)
-        std::rotate(reorder_BC.begin()+1, reorder_BC.begin()+unit_B_BC, reorder_BC.end());
-
-    if (pack_K_3d)
-        std::rotate(reorder_AB.begin()+1, reorder_AB.begin()+std::max(unit_A_AB, unit_B_AB), reorder_AB.end());
-
-    len_type m = stl_ext::prod(len_AC);
-    len_type n = stl_ext::prod(len_BC);
-    len_type k = stl_ext::prod(len_AB);
-    len_type l = stl_ext::prod(len_ABC);
-
-    if (comm.master()) flops += 2*m*n*k*l;
-
-    unsigned nt_l, nt_mn;
-    std::tie(nt_l, nt_mn) =
-        partition_2x2(comm.num_threads(), l, l, m*n, m*n);
-
-    auto subcomm = comm.gang(TCI_EVENLY, nt_l);
-
-    subcomm.distribute_over_gangs(l,
-    [&](len_type l_min, len_type l_max)
-    {
-        tensor_matrix<T> at(stl_ext::permuted(len_AC, reorder_AC),
-                            stl_ext::permuted(len_AB, reorder_AB),
-                            nullptr,
-                            stl_ext::permuted(stride_A_AC, reorder_AC),
-                            stl_ext::permuted(stride_A_AB, reorder_AB),
-                            pack_M_3d, pack_K_3d);
-
-        tensor_matrix<T> bt(stl_ext::permuted(len_AB, reorder_AB),
-                            stl_ext::permuted(len_BC, reorder_BC),
-                            nullptr,
-                            stl_ext::permuted(stride_B_AB, reorder_AB),
-                            stl_ext::permuted(stride_B_BC, reorder_BC),
-                            pack_K_3d, pack_N_3d);
-
-        tensor_matrix<T> ct(stl_ext::permuted(len_AC, reorder_AC),
-                            stl_ext::permuted(len_BC, reorder_BC),
-                            nullptr,
-                            stl_ext::permuted(stride_C_AC, reorder_AC),
-                            stl_ext::permuted(stride_C_BC, reorder_BC),
-                            pack_M_3d, pack_N_3d);
-
-        viterator<3> iter_ABC(stl_ext::permuted(len_ABC, reorder_ABC),
-                              stl_ext::permuted(stride_A_ABC, reorder_ABC),
-                              stl_ext::permuted(stride_B_ABC, reorder_ABC),
-                              stl_ext::permuted(stride_C_ABC, reorder_ABC));
-
-        auto A1 = A;
-        auto B1 = B;
-        auto C1 = C;
-
-        iter_ABC.position(l_min, A1, B1, C1);
-
-        for (len_type l = l_min;l < l_max;l++)
-        {
-            iter_ABC.next(A1, B1, C1);
-
-            at.data(const_cast<T*>(A1));
-            bt.data(const_cast<T*>(B1));
-            ct.data(C1);
-
-            TensorGEMM{}(subcomm, cfg, alpha, at, bt, beta, ct);
-        }
-    });
-}
-
 template <typename T>
 void mult_blas(const communicator& comm, const config& cfg,
                const len_vector& len_AB_,
@@ -605,12 +845,62 @@ void mult_blas(const communicator& comm, const config& cfg,
     auto stride_B_ABC = stride_B_ABC_; stride_B_ABC.push_back(1);
     auto stride_C_ABC = stride_C_ABC_; stride_C_ABC.push_back(1);
 
-    if (comm.master())
+    /*
+     * Use the external GEMM if there is one and it can take the matrices as
+     * they are. Otherwise, fall back to TBLIS's GEMM, unless the caller would
+     * rather copy the matrices for the backend first.
+     */
+    auto mult_matrix = [&](bool copy_if_needed, len_type m, len_type n, len_type k,
+                           bool conj_A, const T* A, stride_type rs_A, stride_type cs_A,
+                           bool conj_B, const T* B, stride_type rs_B, stride_type cs_B,
+                           T beta, bool conj_C, T* C, stride_type rs_C, stride_type cs_C)
     {
-        ar.reset(len_AC+len_AB);
-        br.reset(len_AB+len_BC);
-        cr.reset(len_AC+len_BC);
-    }
+        if (mult_backend(comm, m, n, k,
+                         alpha, conj_A, A, rs_A, cs_A,
+                                conj_B, B, rs_B, cs_B,
+                          beta, conj_C, C, rs_C, cs_C)) return true;
+
+        if (copy_if_needed && has_gemm_backend<T>()) return false;
+
+        mult(comm, cfg, m, n, k,
+             alpha, conj_A, A, rs_A, cs_A,
+                    conj_B, B, rs_B, cs_B,
+              beta, conj_C, C, rs_C, cs_C);
+        return true;
+    };
+
+    /*
+     * When each group of indices has been folded into (at most) one
+     * dimension, each ABC slice is already a matrix, so the copies can be
+     * skipped. The strides are the same for every slice, so if the first one
+     * can be done in place then so can the rest.
+     */
+    if (len_AB_.size() <= 1 && len_AC_.size() <= 1 && len_BC_.size() <= 1)
+    {
+        auto A1 = A;
+        auto B1 = B;
+        auto C1 = C;
+
+        viterator<3> it(len_ABC, stride_A_ABC, stride_B_ABC, stride_C_ABC);
+
+        bool in_place = true;
+        for (bool first = true;in_place && it.next(A1, B1, C1);first = false)
+        {
+            in_place = mult_matrix(first, len_AC[0], len_BC[0], len_AB[0],
+                                   conj_A, A1, stride_A_AC[0], stride_A_AB[0],
+                                   conj_B, B1, stride_B_AB[0], stride_B_BC[0],
+                                   beta, conj_C, C1, stride_C_AC[0], stride_C_BC[0]);
+        }
+
+        if (in_place) return;
+    }
+
+    if (comm.master())
+    {
+        ar.reset(len_AC+len_AB);
+        br.reset(len_AB+len_BC);
+        cr.reset(len_AC+len_BC);
+    }
 
     comm.broadcast(
     [&](varray<T>& ar, varray<T>& br, varray<T>& cr)
@@ -636,10 +926,10 @@ void mult_blas(const communicator& comm, const config& cfg,
                 T(1), conj_B,        B1, {}, stride_B_AB+stride_B_BC,
                 T(0),  false, br.data(), {},            br.strides());
 
-            mult(comm, cfg, cm.length(0), cm.length(1), am.length(1),
-                 alpha, false, am.data(), am.stride(0), am.stride(1),
+            mult_matrix(false, cm.length(0), cm.length(1), am.length(1),
+                        false, am.data(), am.stride(0), am.stride(1),
                         false, bm.data(), bm.stride(0), bm.stride(1),
-                  T(0), false, cm.data(), cm.stride(0), cm.stride(1));
+                         T(0), false, cm.data(), cm.stride(0), cm.stride(1));
 
             add(comm, cfg, {}, {}, cr.lengths(),
                 T(1),  false, cr.data(), {},             cr.strides(),
@@ -719,6 +1009,72 @@ void mult_ref(const communicator& comm, const config& cfg,
     });
 }
 
+/*
+ * The reference algorithm for C = alpha*A*diag(W)*B + beta*C, parallelized
+ * over all of the elements of C.
+ */
+template <typename T>
+void mult_ref(const communicator& comm, const config& cfg, const mult_plan& plan,
+              T alpha, bool conj_A, const T* A,
+                       bool conj_W, const T* W,
+              const stride_vector& stride_W_AB,
+              const stride_vector& stride_W_ABC,
+                       bool conj_B, const T* B,
+              T  beta, bool conj_C,       T* C)
+{
+    (void)cfg;
+
+    auto zero_AC = stride_vector(plan.len_AC.size());
+    auto zero_BC = stride_vector(plan.len_BC.size());
+
+    comm.distribute_over_threads(stl_ext::prod(plan.len_C),
+    [&](len_type n_min, len_type n_max)
+    {
+        if (n_min == n_max) return;
+
+        auto A1 = A;
+        auto W1 = W;
+        auto B1 = B;
+        auto C1 = C;
+
+        viterator<3> iter_AB(plan.len_AB, plan.stride_A_AB, stride_W_AB, plan.stride_B_AB);
+        viterator<4> iter_C(plan.len_ABC+plan.len_AC+plan.len_BC,
+                            plan.stride_A_ABC+plan.stride_A_AC+zero_BC,
+                            stride_W_ABC+zero_AC+zero_BC,
+                            plan.stride_B_ABC+zero_AC+plan.stride_B_BC,
+                            plan.stride_C_ABC+plan.stride_C_AC+plan.stride_C_BC);
+        iter_C.position(n_min, A1, W1, B1, C1);
+
+        for (len_type i = n_min;i < n_max;i++)
+        {
+            iter_C.next(A1, W1, B1, C1);
+
+            T temp = T();
+
+            TBLIS_SPECIAL_CASE(conj_A,
+            TBLIS_SPECIAL_CASE(conj_W,
+            TBLIS_SPECIAL_CASE(conj_B,
+            while (iter_AB.next(A1, W1, B1))
+            {
+                temp += (conj_A ? conj(*A1) : *A1)*
+                        (conj_W ? conj(*W1) : *W1)*
+                        (conj_B ? conj(*B1) : *B1);
+            }
+            )))
+            temp *= alpha;
+
+            if (beta == T(0))
+            {
+                *C1 = temp;
+            }
+            else
+            {
+                *C1 = temp + beta*(conj_C ? conj(*C1) : *C1);
+            }
+        }
+    });
+}
+
 template <typename T>
 void mult_vec(const communicator& comm, const config& cfg,
               const len_vector& len_ABC,
@@ -773,48 +1129,268 @@ void mult_vec(const communicator& comm, const config& cfg,
     });
 }
 
+/*
+ * Whether a group of dimensions is contiguous (in the given order) in both
+ * operands, and if so its stride in each as a single dimension.
+ */
+static bool fold_group(const len_vector& len,
+                       const stride_vector& stride1,
+                       const stride_vector& stride2,
+                       stride_type& folded1, stride_type& folded2)
+{
+    folded1 = stride1.empty() ? 1 : stride1[0];
+    folded2 = stride2.empty() ? 1 : stride2[0];
+
+    for (unsigned i = 1;i < len.size();i++)
+    {
+        if (stride1[i] != stride1[i-1]*len[i-1] ||
+            stride2[i] != stride2[i-1]*len[i-1]) return false;
+    }
+
+    return true;
+}
+
+mult_plan::mult_plan(const len_vector& len_AB_,
+                     const len_vector& len_AC_,
+                     const len_vector& len_BC_,
+                     const len_vector& len_ABC_,
+                     const stride_vector& stride_A_AB_,
+                     const stride_vector& stride_A_AC_,
+                     const stride_vector& stride_A_ABC_,
+                     const stride_vector& stride_B_AB_,
+                     const stride_vector& stride_B_BC_,
+                     const stride_vector& stride_B_ABC_,
+                     const stride_vector& stride_C_AC_,
+                     const stride_vector& stride_C_BC_,
+                     const stride_vector& stride_C_ABC_)
+: len_AB(len_AB_), len_AC(len_AC_), len_BC(len_BC_), len_ABC(len_ABC_),
+  stride_A_AB(stride_A_AB_), stride_A_AC(stride_A_AC_), stride_A_ABC(stride_A_ABC_),
+  stride_B_AB(stride_B_AB_), stride_B_BC(stride_B_BC_), stride_B_ABC(stride_B_ABC_),
+  stride_C_AC(stride_C_AC_), stride_C_BC(stride_C_BC_), stride_C_ABC(stride_C_ABC_),
+  len_C(len_AC_+len_BC_+len_ABC_), stride_C(stride_C_AC_+stride_C_BC_+stride_C_ABC_)
+{
+    n_AB = stl_ext::prod(len_AB);
+    n_AC = stl_ext::prod(len_AC);
+    n_BC = stl_ext::prod(len_BC);
+    n_ABC = stl_ext::prod(len_ABC);
+
+    groups = (n_AB  == 1 ? 0 : HAS_AB ) +
+             (n_AC  == 1 ? 0 : HAS_AC ) +
+             (n_BC  == 1 ? 0 : HAS_BC ) +
+             (n_ABC == 1 ? 0 : HAS_ABC);
+
+    if (!uses_tensor_gemm()) return;
+
+    auto reorder_AC = detail::sort_by_stride(stride_C_AC, stride_A_AC);
+    auto reorder_BC = detail::sort_by_stride(stride_C_BC, stride_B_BC);
+    auto reorder_AB = detail::sort_by_stride(stride_A_AB, stride_B_AB);
+
+    unsigned unit_A_AC = unit_dim(stride_A_AC, reorder_AC);
+    unsigned unit_C_AC = unit_dim(stride_C_AC, reorder_AC);
+    unsigned unit_B_BC = unit_dim(stride_B_BC, reorder_BC);
+    unsigned unit_C_BC = unit_dim(stride_C_BC, reorder_BC);
+    unsigned unit_A_AB = unit_dim(stride_A_AB, reorder_AB);
+    unsigned unit_B_AB = unit_dim(stride_B_AB, reorder_AB);
+
+    TBLIS_ASSERT(unit_C_AC == 0 || unit_C_AC == len_AC.size());
+    TBLIS_ASSERT(unit_C_BC == 0 || unit_C_BC == len_BC.size());
+    TBLIS_ASSERT(unit_A_AB == 0 || unit_B_AB == 0 ||
+                 (unit_A_AB == len_AB.size() && unit_B_AB == len_AB.size()));
+
+    pack_M_3d = unit_A_AC > 0 && unit_A_AC < len_AC.size();
+    pack_N_3d = unit_B_BC > 0 && unit_B_BC < len_BC.size();
+    pack_K_3d = (unit_A_AB > 0 && unit_A_AB < len_AB.size()) ||
+                (unit_B_AB > 0 && unit_B_AB < len_AB.size());
+
+    if (pack_M_3d)
+        std::rotate(reorder_AC.begin()+1, reorder_AC.begin()+unit_A_AC, reorder_AC.end());
+
+    if (pack_N_3d)
+        std::rotate(reorder_BC.begin()+1, reorder_BC.begin()+unit_B_BC, reorder_BC.end());
+
+    if (pack_K_3d)
+        std::rotate(reorder_AB.begin()+1, reorder_AB.begin()+std::max(unit_A_AB, unit_B_AB), reorder_AB.end());
+
+    reorder_M = reorder_AC;
+    reorder_N = reorder_BC;
+    reorder_K = reorder_AB;
+
+    len_M = stl_ext::permuted(len_AC, reorder_AC);
+    len_N = stl_ext::permuted(len_BC, reorder_BC);
+    len_K = stl_ext::permuted(len_AB, reorder_AB);
+    stride_A_M = stl_ext::permuted(stride_A_AC, reorder_AC);
+    stride_A_K = stl_ext::permuted(stride_A_AB, reorder_AB);
+    stride_B_K = stl_ext::permuted(stride_B_AB, reorder_AB);
+    stride_B_N = stl_ext::permuted(stride_B_BC, reorder_BC);
+    stride_C_M = stl_ext::permuted(stride_C_AC, reorder_AC);
+    stride_C_N = stl_ext::permuted(stride_C_BC, reorder_BC);
+
+    is_matrix = fold_group(len_M, stride_A_M, stride_C_M, rs_A, rs_C) &&
+                fold_group(len_N, stride_B_N, stride_C_N, cs_B, cs_C) &&
+                fold_group(len_K, stride_A_K, stride_B_K, cs_A, rs_B);
+
+    if (groups & HAS_ABC)
+    {
+        reorder_L = detail::sort_by_stride(stride_C_ABC, stride_A_ABC, stride_B_ABC);
+
+        len_L = stl_ext::permuted(len_ABC, reorder_L);
+        stride_A_L = stl_ext::permuted(stride_A_ABC, reorder_L);
+        stride_B_L = stl_ext::permuted(stride_B_ABC, reorder_L);
+        stride_C_L = stl_ext::permuted(stride_C_ABC, reorder_L);
+    }
+}
+
+bool mult_plan::uses_tensor_gemm() const
+{
+    return n_AC != 0 && n_BC != 0 && n_ABC != 0 &&
+           (groups & ~HAS_ABC) == HAS_AB+HAS_AC+HAS_BC;
+}
+
+/*
+ * Work out the thread partitioning done by mult_blis and TensorGEMM ahead of
+ * time. The result is only used when running on exactly nt threads.
+ */
 template <typename T>
-void mult(const communicator& comm, const config& cfg,
-          const len_vector& len_AB,
-          const len_vector& len_AC,
-          const len_vector& len_BC,
-          const len_vector& len_ABC,
-          T alpha, bool conj_A, const T* A,
-          const stride_vector& stride_A_AB,
-          const stride_vector& stride_A_AC,
-          const stride_vector& stride_A_ABC,
-                   bool conj_B, const T* B,
-          const stride_vector& stride_B_AB,
-          const stride_vector& stride_B_BC,
-          const stride_vector& stride_B_ABC,
-          T  beta, bool conj_C,       T* C,
-          const stride_vector& stride_C_AC,
-          const stride_vector& stride_C_BC,
-          const stride_vector& stride_C_ABC)
+void mult_plan::partition(const config& cfg, unsigned nt)
 {
-    auto n_AB = stl_ext::prod(len_AB);
-    auto n_AC = stl_ext::prod(len_AC);
-    auto n_BC = stl_ext::prod(len_BC);
-    auto n_ABC = stl_ext::prod(len_ABC);
+    if (!uses_tensor_gemm()) return;
+
+    unsigned nt_MN = nt;
+    if (groups & HAS_ABC)
+        std::tie(nt_L, nt_MN) = partition_2x2(nt, n_ABC, n_ABC, n_AC*n_BC, n_AC*n_BC);
+
+    /*
+     * See gemm::operator(), C^T = B^T A^T is computed instead when C is
+     * "transposed" with respect to the microkernel.
+     */
+    const bool row_major = cfg.gemm_row_major.value<T>();
+    const auto& stride_C_trans = row_major ? stride_C_M : stride_C_N;
+    const bool trans = stride_C_trans.empty() || stride_C_trans[0] == 1;
+
+    thread_config = make_gemm_thread_config<T>(cfg, nt_MN,
+                                               trans ? n_BC : n_AC,
+                                               trans ? n_AC : n_BC, n_AB);
+    num_threads = nt;
+}
+
+#define FOREACH_TYPE(T) \
+template void mult_plan::partition<T>(const config& cfg, unsigned nt);
+#include "configs/foreach_type.h"
 
-    if (n_AC == 0 || n_BC == 0 || n_ABC == 0) return;
+static const tblis_mult_options default_mult_options = {};
 
-    if (n_AB == 0)
+static const tblis_mult_options*& thread_mult_options()
+{
+    static thread_local const tblis_mult_options* options = nullptr;
+    return options;
+}
+
+const tblis_mult_options& current_mult_options()
+{
+    auto options = thread_mult_options();
+    return options ? *options : default_mult_options;
+}
+
+mult_options_scope::mult_options_scope(const tblis_mult_options* options)
+: _prev(thread_mult_options())
+{
+    if (options) thread_mult_options() = options;
+}
+
+mult_options_scope::~mult_options_scope()
+{
+    thread_mult_options() = _prev;
+}
+
+/*
+ * For AUTO: contractions with no more than this many flops per element of
+ * the ABC (batch) dimensions use the vector path when there are enough batch
+ * elements to go around, and those with m, n, and k all at least
+ * transpose_min_length, no batch dimensions, and an operand which is not
+ * unit-stride in any dimension are transposed into matrices.
+ */
+constexpr stride_type vector_max_flops = 512;
+constexpr len_type transpose_min_length = 256;
+
+static bool has_unit_stride(const stride_vector& stride1,
+                            const stride_vector& stride2)
+{
+    for (auto s : stride1) if (s == 1) return true;
+    for (auto s : stride2) if (s == 1) return true;
+    return false;
+}
+
+static impl_t auto_impl(const mult_plan& plan, unsigned num_threads)
+{
+    /*
+     * Otherwise the cases with a dedicated (level 1 or 2) path use it.
+     */
+    if (!plan.uses_tensor_gemm()) return BLIS_BASED;
+
+    if (2*plan.n_AB*plan.n_AC*plan.n_BC <= vector_max_flops &&
+        plan.n_ABC >= num_threads)
+        return REFERENCE;
+
+    if (plan.n_ABC == 1 &&
+        std::min({plan.n_AB, plan.n_AC, plan.n_BC}) >= transpose_min_length &&
+        (!has_unit_stride(plan.stride_A_AB, plan.stride_A_AC) ||
+         !has_unit_stride(plan.stride_B_AB, plan.stride_B_BC) ||
+         !has_unit_stride(plan.stride_C_AC, plan.stride_C_BC)))
+        return BLAS_BASED;
+
+    return BLIS_BASED;
+}
+
+impl_t select_impl(const mult_plan& plan, unsigned num_threads)
+{
+    switch (current_mult_options().algorithm)
+    {
+        case MULT_ALGORITHM_AUTO:           return auto_impl(plan, num_threads);
+        case MULT_ALGORITHM_TENSOR_GEMM:    return BLIS_BASED;
+        case MULT_ALGORITHM_TRANSPOSE_GEMM: return BLAS_BASED;
+        case MULT_ALGORITHM_VECTOR:         return REFERENCE;
+        default:                            return impl;
+    }
+}
+
+template <typename T>
+void mult(const communicator& comm, const config& cfg, const mult_plan& plan,
+          T alpha, bool conj_A, const T* A,
+                   bool conj_B, const T* B,
+          T  beta, bool conj_C,       T* C)
+{
+    const auto& len_AB = plan.len_AB;
+    const auto& len_AC = plan.len_AC;
+    const auto& len_BC = plan.len_BC;
+    const auto& len_ABC = plan.len_ABC;
+    const auto& stride_A_AB = plan.stride_A_AB;
+    const auto& stride_A_AC = plan.stride_A_AC;
+    const auto& stride_A_ABC = plan.stride_A_ABC;
+    const auto& stride_B_AB = plan.stride_B_AB;
+    const auto& stride_B_BC = plan.stride_B_BC;
+    const auto& stride_B_ABC = plan.stride_B_ABC;
+    const auto& stride_C_AC = plan.stride_C_AC;
+    const auto& stride_C_BC = plan.stride_C_BC;
+    const auto& stride_C_ABC = plan.stride_C_ABC;
+
+    if (plan.n_AC == 0 || plan.n_BC == 0 || plan.n_ABC == 0) return;
+
+    if (plan.n_AB == 0)
     {
         if (beta == T(0))
         {
-            set(comm, cfg, len_AC+len_BC+len_ABC, beta, C,
-                stride_C_AC+stride_C_BC+stride_C_ABC);
+            set(comm, cfg, plan.len_C, beta, C, plan.stride_C);
         }
         else if (beta != T(1) || (is_complex<T>::value && conj_C))
         {
-            scale(comm, cfg, len_AC+len_BC+len_ABC, beta, conj_C, C,
-                  stride_C_AC+stride_C_BC+stride_C_ABC);
+            scale(comm, cfg, plan.len_C, beta, conj_C, C, plan.stride_C);
         }
 
         return;
     }
 
+    auto impl = select_impl(plan, comm.num_threads());
+
     if (impl == REFERENCE)
     {
         mult_ref(comm, cfg,
@@ -836,24 +1412,10 @@ void mult(const communicator& comm, const config& cfg,
         return;
     }
 
-    enum
-    {
-        HAS_NONE = 0x0,
-        HAS_AB   = 0x1,
-        HAS_AC   = 0x2,
-        HAS_BC   = 0x4,
-        HAS_ABC  = 0x8
-    };
-
-    int groups = (n_AB  == 1 ? 0 : HAS_AB ) +
-                 (n_AC  == 1 ? 0 : HAS_AC ) +
-                 (n_BC  == 1 ? 0 : HAS_BC ) +
-                 (n_ABC == 1 ? 0 : HAS_ABC);
-
     T sum;
     viterator<3> iter_ABC(len_ABC, stride_A_ABC, stride_B_ABC, stride_C_ABC);
 
-    switch (groups)
+    switch (plan.groups)
     {
         case HAS_NONE:
         {
@@ -936,11 +1498,12 @@ void mult(const communicator& comm, const config& cfg,
         }
         break;
         case HAS_AB+HAS_AC+HAS_BC:
+        case HAS_AB+HAS_AC+HAS_BC+HAS_ABC:
         {
-            mult_blis(comm, cfg, len_AB, len_AC, len_BC,
-                      alpha, conj_A, A, stride_A_AB, stride_A_AC,
-                             conj_B, B, stride_B_AB, stride_B_BC,
-                       beta, conj_C, C, stride_C_AC, stride_C_BC);
+            mult_blis(comm, cfg, plan,
+                      alpha, conj_A, A,
+                             conj_B, B,
+                       beta, conj_C, C);
         }
         break;
         case HAS_AB+HAS_ABC:
@@ -1008,20 +1571,320 @@ void mult(const communicator& comm, const config& cfg,
                        beta, conj_C, C, stride_C_BC, stride_C_ABC);
         }
         break;
-        case HAS_AB+HAS_AC+HAS_BC+HAS_ABC:
+    }
+
+    comm.barrier();
+}
+
+template <typename T>
+void mult(const communicator& comm, const config& cfg, const mult_plan& plan,
+          T alpha, bool conj_A, const T* A,
+                   bool conj_B, const T* B,
+          T  beta, bool conj_C,       T* C,
+          const mult_epilogue<T>& epilogue)
+{
+    if (plan.n_AC == 0 || plan.n_BC == 0 || plan.n_ABC == 0) return;
+
+    if (plan.n_AB != 0 && plan.uses_tensor_gemm() && !use_strassen(plan) &&
+        select_impl(plan, comm.num_threads()) == BLIS_BASED)
+    {
+        mult_blis(comm, cfg, plan,
+                  alpha, conj_A, A,
+                         conj_B, B,
+                   beta, conj_C, C, epilogue);
+        comm.barrier();
+        return;
+    }
+
+    mult(comm, cfg, plan, alpha, conj_A, A, conj_B, B, beta, conj_C, C);
+    apply_epilogue(comm, cfg, plan, C, epilogue);
+}
+
+template <typename T>
+void mult(const communicator& comm, const config& cfg, const mult_plan& plan,
+          T alpha, bool conj_A, const T* A,
+                   bool conj_W, const T* W,
+          const stride_vector& stride_W_AB,
+          const stride_vector& stride_W_ABC,
+                   bool conj_B, const T* B,
+          T  beta, bool conj_C,       T* C)
+{
+    if (plan.n_AC == 0 || plan.n_BC == 0 || plan.n_ABC == 0) return;
+
+    if (plan.n_AB == 0)
+    {
+        mult(comm, cfg, plan, alpha, conj_A, A, conj_B, B, beta, conj_C, C);
+        return;
+    }
+
+    /*
+     * W can only be folded into packing with TensorGEMM (which is also used
+     * when BLAS_BASED is selected, rather than making a scaled copy of B).
+     * The other cases are at most level 2 operations and use the reference
+     * algorithm.
+     */
+    if (plan.uses_tensor_gemm() &&
+        select_impl(plan, comm.num_threads()) != REFERENCE)
+    {
+        mult_blis(comm, cfg, plan,
+                  alpha, conj_A, A,
+                         conj_W, W, stride_W_AB, stride_W_ABC,
+                         conj_B, B,
+                   beta, conj_C, C);
+    }
+    else
+    {
+        mult_ref(comm, cfg, plan,
+                 alpha, conj_A, A,
+                        conj_W, W, stride_W_AB, stride_W_ABC,
+                        conj_B, B,
+                  beta, conj_C, C);
+    }
+
+    comm.barrier();
+}
+
+/*
+ * Values are collected this many at a time for the epilogue function.
+ */
+constexpr len_type epilogue_chunk = 64;
+
+template <typename T>
+void apply_epilogue(const communicator& comm, const config& cfg,
+                    const mult_plan& plan, T* C,
+                    const mult_epilogue<T>& epilogue)
+{
+    (void)cfg;
+
+    const auto& op = epilogue.op;
+    if (!op.add && !op.divide && !op.func) return;
+
+    std::array<stride_vector, 3> stride;
+    for (unsigned i = 0;i < 3;i++)
+        stride[i] = epilogue.stride_AC[i] + epilogue.stride_BC[i] + epilogue.stride_ABC[i];
+
+    comm.distribute_over_threads(stl_ext::prod(plan.len_C),
+    [&](len_type first, len_type last)
+    {
+        if (first == last) return;
+
+        viterator<4> iter(plan.len_C, plan.stride_C, stride[0], stride[1], stride[2]);
+
+        auto C1 = C;
+        auto E1 = epilogue.E;
+        auto D01 = epilogue.D[0];
+        auto D11 = epilogue.D[1];
+
+        iter.position(first, C1, E1, D01, D11);
+
+        T* ptrs[epilogue_chunk];
+        T values[epilogue_chunk];
+
+        for (len_type i = first;i < last;)
         {
-            mult_blis(comm, cfg,
-                      len_AB, len_AC, len_BC, len_ABC,
-                      alpha, conj_A, A, stride_A_AB, stride_A_AC, stride_A_ABC,
-                             conj_B, B, stride_B_AB, stride_B_BC, stride_B_ABC,
-                       beta, conj_C, C, stride_C_AC, stride_C_BC, stride_C_ABC);
+            len_type n = std::min(epilogue_chunk, last-i);
+
+            for (len_type j = 0;j < n;j++)
+            {
+                iter.next(C1, E1, D01, D11);
+                ptrs[j] = C1;
+                values[j] = op.update(*C1, E1, D01, D11);
+            }
+
+            op.finish(n, values);
+
+            for (len_type j = 0;j < n;j++) *ptrs[j] = values[j];
+
+            i += n;
         }
-        break;
-    }
+    });
 
     comm.barrier();
 }
 
+/*
+ * Copy B = A, converting between precisions.
+ */
+template <typename T, typename U>
+void convert(const communicator& comm, const len_vector& len,
+             const T* A, const stride_vector& stride_A,
+                   U* B, const stride_vector& stride_B)
+{
+    comm.distribute_over_threads(stl_ext::prod(len),
+    [&](len_type n_min, len_type n_max)
+    {
+        auto A1 = A;
+        auto B1 = B;
+
+        viterator<2> iter(len, stride_A, stride_B);
+        iter.position(n_min, A1, B1);
+
+        for (len_type i = n_min;i < n_max;i++)
+        {
+            iter.next(A1, B1);
+            *B1 = U(*A1);
+        }
+    });
+
+    comm.barrier();
+}
+
+static stride_vector sub_strides(const stride_vector& stride, size_t first, size_t n)
+{
+    return stride_vector(stride.begin()+first, stride.begin()+first+n);
+}
+
+/*
+ * Mixed-precision fallback for when A and B are in the lower precision:
+ * contract converted copies of A and B.
+ */
+template <typename T>
+void mult_converted(const communicator& comm, const config& cfg, const mult_plan& plan,
+                    T alpha, bool conj_A, const other_precision_t<T>* A,
+                             bool conj_B, const other_precision_t<T>* B,
+                    T  beta, bool conj_C,                          T* C)
+{
+    auto n_AB = plan.len_AB.size();
+    auto n_AC = plan.len_AC.size();
+    auto n_BC = plan.len_BC.size();
+    auto n_ABC = plan.len_ABC.size();
+
+    varray<T> ar, br;
+
+    if (comm.master())
+    {
+        ar.reset(plan.len_AB+plan.len_AC+plan.len_ABC);
+        br.reset(plan.len_AB+plan.len_BC+plan.len_ABC);
+    }
+
+    comm.broadcast(
+    [&](varray<T>& ar, varray<T>& br)
+    {
+        convert(comm, ar.lengths(),
+                A, plan.stride_A_AB+plan.stride_A_AC+plan.stride_A_ABC,
+                ar.data(), ar.strides());
+
+        convert(comm, br.lengths(),
+                B, plan.stride_B_AB+plan.stride_B_BC+plan.stride_B_ABC,
+                br.data(), br.strides());
+
+        mult(comm, cfg, plan.len_AB, plan.len_AC, plan.len_BC, plan.len_ABC,
+             alpha, conj_A, ar.cdata(), sub_strides(ar.strides(), 0, n_AB),
+                                        sub_strides(ar.strides(), n_AB, n_AC),
+                                        sub_strides(ar.strides(), n_AB+n_AC, n_ABC),
+                    conj_B, br.cdata(), sub_strides(br.strides(), 0, n_AB),
+                                        sub_strides(br.strides(), n_AB, n_BC),
+                                        sub_strides(br.strides(), n_AB+n_BC, n_ABC),
+              beta, conj_C, C, plan.stride_C_AC, plan.stride_C_BC, plan.stride_C_ABC);
+    },
+    ar, br);
+}
+
+/*
+ * Mixed-precision fallback for when C is in the lower precision: update a
+ * converted copy of C and then convert it back.
+ */
+template <typename T>
+void mult_converted(const communicator& comm, const config& cfg, const mult_plan& plan,
+                    T alpha, bool conj_A,                    const T* A,
+                             bool conj_B,                    const T* B,
+                    T  beta, bool conj_C, other_precision_t<T>* C)
+{
+    auto n_AC = plan.len_AC.size();
+    auto n_BC = plan.len_BC.size();
+    auto n_ABC = plan.len_ABC.size();
+
+    varray<T> cr;
+
+    if (comm.master())
+        cr.reset(plan.len_C);
+
+    comm.broadcast(
+    [&](varray<T>& cr)
+    {
+        if (beta != T(0))
+            convert(comm, cr.lengths(), C, plan.stride_C, cr.data(), cr.strides());
+
+        mult(comm, cfg, plan.len_AB, plan.len_AC, plan.len_BC, plan.len_ABC,
+             alpha, conj_A, A, plan.stride_A_AB, plan.stride_A_AC, plan.stride_A_ABC,
+                    conj_B, B, plan.stride_B_AB, plan.stride_B_BC, plan.stride_B_ABC,
+              beta, conj_C, cr.data(), sub_strides(cr.strides(), 0, n_AC),
+                                       sub_strides(cr.strides(), n_AC, n_BC),
+                                       sub_strides(cr.strides(), n_AC+n_BC, n_ABC));
+
+        convert(comm, cr.lengths(), cr.cdata(), cr.strides(), C, plan.stride_C);
+    },
+    cr);
+}
+
+template <typename TAB, typename TC>
+void mult_mixed(const communicator& comm, const config& cfg, const mult_plan& plan,
+                higher_precision_t<TAB,TC> alpha, bool conj_A, const TAB* A,
+                                                  bool conj_B, const TAB* B,
+                higher_precision_t<TAB,TC>  beta, bool conj_C,        TC* C)
+{
+    typedef higher_precision_t<TAB,TC> T;
+
+    if (plan.n_AC == 0 || plan.n_BC == 0 || plan.n_ABC == 0) return;
+
+    /*
+     * Conversion is folded into packing (for A and B) or the microkernel
+     * (for C) when using TensorGEMM.
+     */
+    if (select_impl(plan, comm.num_threads()) == BLIS_BASED &&
+        plan.n_AB != 0 && plan.uses_tensor_gemm())
+    {
+        mult_blis(comm, cfg, plan,
+                  alpha, conj_A, A,
+                         conj_B, B,
+                   beta, conj_C, C);
+        comm.barrier();
+        return;
+    }
+
+    mult_converted<T>(comm, cfg, plan,
+                      alpha, conj_A, A,
+                             conj_B, B,
+                       beta, conj_C, C);
+}
+
+#define TBLIS_INSTANTIATE_MULT_MIXED(TAB, TC) \
+template void mult_mixed(const communicator& comm, const config& cfg, const mult_plan& plan, \
+                         higher_precision_t<TAB,TC> alpha, bool conj_A, const TAB* A, \
+                                                           bool conj_B, const TAB* B, \
+                         higher_precision_t<TAB,TC>  beta, bool conj_C,        TC* C);
+TBLIS_INSTANTIATE_MULT_MIXED(   float,   double)
+TBLIS_INSTANTIATE_MULT_MIXED(  double,    float)
+TBLIS_INSTANTIATE_MULT_MIXED(scomplex, dcomplex)
+TBLIS_INSTANTIATE_MULT_MIXED(dcomplex, scomplex)
+
+template <typename T>
+void mult(const communicator& comm, const config& cfg,
+          const len_vector& len_AB,
+          const len_vector& len_AC,
+          const len_vector& len_BC,
+          const len_vector& len_ABC,
+          T alpha, bool conj_A, const T* A,
+          const stride_vector& stride_A_AB,
+          const stride_vector& stride_A_AC,
+          const stride_vector& stride_A_ABC,
+                   bool conj_B, const T* B,
+          const stride_vector& stride_B_AB,
+          const stride_vector& stride_B_BC,
+          const stride_vector& stride_B_ABC,
+          T  beta, bool conj_C,       T* C,
+          const stride_vector& stride_C_AC,
+          const stride_vector& stride_C_BC,
+          const stride_vector& stride_C_ABC)
+{
+    mult(comm, cfg,
+         mult_plan(len_AB, len_AC, len_BC, len_ABC,
+                   stride_A_AB, stride_A_AC, stride_A_ABC,
+                   stride_B_AB, stride_B_BC, stride_B_ABC,
+                   stride_C_AC, stride_C_BC, stride_C_ABC),
+         alpha, conj_A, A, conj_B, B, beta, conj_C, C);
+}
+
 #define FOREACH_TYPE(T) \
 template void mult(const communicator& comm, const config& cfg, \
                    const len_vector& len_AB, \
@@ -1039,7 +1902,26 @@ template void mult(const communicator& comm, const config& cfg, \
                    T  beta, bool conj_C,       T* C, \
                    const stride_vector& stride_C_AC, \
                    const stride_vector& stride_C_BC, \
-                   const stride_vector& stride_C_ABC);
+                   const stride_vector& stride_C_ABC); \
+template void mult(const communicator& comm, const config& cfg, const mult_plan& plan, \
+                   T alpha, bool conj_A, const T* A, \
+                            bool conj_B, const T* B, \
+                   T  beta, bool conj_C,       T* C); \
+template void mult(const communicator& comm, const config& cfg, const mult_plan& plan, \
+                   T alpha, bool conj_A, const T* A, \
+                            bool conj_B, const T* B, \
+                   T  beta, bool conj_C,       T* C, \
+                   const mult_epilogue<T>& epilogue); \
+template void mult(const communicator& comm, const config& cfg, const mult_plan& plan, \
+                   T alpha, bool conj_A, const T* A, \
+                            bool conj_W, const T* W, \
+                   const stride_vector& stride_W_AB, \
+                   const stride_vector& stride_W_ABC, \
+                            bool conj_B, const T* B, \
+                   T  beta, bool conj_C,       T* C); \
+template void apply_epilogue(const communicator& comm, const config& cfg, \
+                             const mult_plan& plan, T* C, \
+                             const mult_epilogue<T>& epilogue);
 #include "configs/foreach_type.h"
 
 }
@@ -4,6 +4,9 @@
 #include "util/thread.h"
 #include "util/basic_types.h"
 #include "configs/configs.hpp"
+#include "util/gemm_thread.hpp"
+#include "iface/3t/mult.h"
+#include "matrix/epilogue_matrix.hpp"
 
 namespace tblis
 {
@@ -13,6 +16,110 @@ namespace internal
 enum impl_t {BLIS_BASED, BLAS_BASED, REFERENCE};
 extern impl_t impl;
 
+/*
+ * The options of the contraction being computed by the calling thread, as
+ * set by a mult_options_scope for the duration of a call (or the defaults).
+ * All of the work of a call is done on the threads which entered it, so the
+ * options also reach the dense contractions done inside the DPD and indexed
+ * algorithms.
+ */
+const tblis_mult_options& current_mult_options();
+
+class mult_options_scope
+{
+    public:
+        explicit mult_options_scope(const tblis_mult_options* options);
+
+        ~mult_options_scope();
+
+        mult_options_scope(const mult_options_scope&) = delete;
+
+        mult_options_scope& operator=(const mult_options_scope&) = delete;
+
+    protected:
+        const tblis_mult_options* _prev;
+};
+
+/*
+ * Number of levels of Strassen's algorithm to use in BLIS_BASED contractions
+ * where m, n, and k are all at least strassen_min_length after matricization
+ * (the default of zero disables it). The initial values are taken from the
+ * environment variables TBLIS_STRASSEN and TBLIS_STRASSEN_MIN_LENGTH. Note
+ * that Strassen's algorithm is somewhat less accurate than the classical one.
+ */
+extern unsigned strassen_levels;
+extern len_type strassen_min_length;
+
+/*
+ * Everything about a contraction which depends only on the lengths and
+ * strides of the operands (and not on the data or scalars), so that it can
+ * be computed once and reused for any number of calls.
+ */
+struct mult_plan
+{
+    len_vector len_AB, len_AC, len_BC, len_ABC;
+    stride_vector stride_A_AB, stride_A_AC, stride_A_ABC;
+    stride_vector stride_B_AB, stride_B_BC, stride_B_ABC;
+    stride_vector stride_C_AC, stride_C_BC, stride_C_ABC;
+    len_vector len_C;
+    stride_vector stride_C;
+
+    stride_type n_AB, n_AC, n_BC, n_ABC;
+    int groups;
+
+    /*
+     * For contractions which are done with TensorGEMM, the sorted lengths
+     * and strides of the (batched) matrices A_MK, B_KN, and C_MN, and the
+     * orders of the AC, BC, AB, and ABC dimensions which give M, N, K, and L.
+     */
+    dim_vector reorder_M, reorder_N, reorder_K, reorder_L;
+    len_vector len_M, len_N, len_K, len_L;
+    stride_vector stride_A_M, stride_A_K, stride_A_L;
+    stride_vector stride_B_K, stride_B_N, stride_B_L;
+    stride_vector stride_C_M, stride_C_N, stride_C_L;
+    bool pack_M_3d = false, pack_N_3d = false, pack_K_3d = false;
+
+    /*
+     * Whether each of M, N, and K is contiguous in both of the operands that
+     * it appears in, so that A_MK, B_KN, and C_MN are plain matrices with
+     * the given strides and no scatter vectors are needed.
+     */
+    bool is_matrix = false;
+    stride_type rs_A = 1, cs_A = 1, rs_B = 1, cs_B = 1, rs_C = 1, cs_C = 1;
+
+    /*
+     * Thread partitioning when run on num_threads threads, or none if zero.
+     */
+    unsigned num_threads = 0;
+    unsigned nt_L = 1;
+    gemm_thread_config thread_config = {1, 1, 1, 1};
+
+    mult_plan(const len_vector& len_AB,
+              const len_vector& len_AC,
+              const len_vector& len_BC,
+              const len_vector& len_ABC,
+              const stride_vector& stride_A_AB,
+              const stride_vector& stride_A_AC,
+              const stride_vector& stride_A_ABC,
+              const stride_vector& stride_B_AB,
+              const stride_vector& stride_B_BC,
+              const stride_vector& stride_B_ABC,
+              const stride_vector& stride_C_AC,
+              const stride_vector& stride_C_BC,
+              const stride_vector& stride_C_ABC);
+
+    bool uses_tensor_gemm() const;
+
+    template <typename T>
+    void partition(const config& cfg, unsigned nt);
+};
+
+/*
+ * The algorithm to use for a contraction on num_threads threads, according
+ * to current_mult_options().
+ */
+impl_t select_impl(const mult_plan& plan, unsigned num_threads);
+
 template <typename T>
 void mult(const communicator& comm, const config& cfg,
           const len_vector& len_AB,
@@ -32,6 +139,71 @@ void mult(const communicator& comm, const config& cfg,
           const stride_vector& stride_C_BC,
           const stride_vector& stride_C_ABC);
 
+template <typename T>
+void mult(const communicator& comm, const config& cfg, const mult_plan& plan,
+          T alpha, bool conj_A, const T* A,
+                   bool conj_B, const T* B,
+          T  beta, bool conj_C,       T* C);
+
+/*
+ * C = alpha*A*diag(W)*B + beta*C, where W is indexed by the AB and ABC
+ * dimensions of the plan with the given strides (zero for any dimension which
+ * W does not have). When TensorGEMM is used, W is applied while packing B.
+ */
+template <typename T>
+void mult(const communicator& comm, const config& cfg, const mult_plan& plan,
+          T alpha, bool conj_A, const T* A,
+                   bool conj_W, const T* W,
+          const stride_vector& stride_W_AB,
+          const stride_vector& stride_W_ABC,
+                   bool conj_B, const T* B,
+          T  beta, bool conj_C,       T* C);
+
+/*
+ * The operands of an epilogue applied to the result of a contraction (see
+ * epilogue_op): E, and the denominator D_0 + D_1. Their strides are given
+ * for the AC, BC, and ABC groups of the plan in the same way as those of C
+ * (in the order E, D_0, D_1). Operands not used by op may be null.
+ */
+template <typename T>
+struct mult_epilogue
+{
+    epilogue_op<T> op;
+    const T* E = nullptr;
+    std::array<const T*, 2> D = {};
+    std::array<stride_vector, 3> stride_AC, stride_BC, stride_ABC;
+};
+
+/*
+ * C = epilogue(alpha*A*B + beta*C), with the epilogue fused into the
+ * microkernel when TensorGEMM is used, and otherwise applied afterwards.
+ */
+template <typename T>
+void mult(const communicator& comm, const config& cfg, const mult_plan& plan,
+          T alpha, bool conj_A, const T* A,
+                   bool conj_B, const T* B,
+          T  beta, bool conj_C,       T* C,
+          const mult_epilogue<T>& epilogue);
+
+/*
+ * C = epilogue(C) as a separate pass.
+ */
+template <typename T>
+void apply_epilogue(const communicator& comm, const config& cfg,
+                    const mult_plan& plan, T* C,
+                    const mult_epilogue<T>& epilogue);
+
+/*
+ * Contraction where C is in the other precision from A and B (see
+ * other_precision), e.g. single-precision inputs with a double-precision
+ * result. The computation is done in the higher of the two precisions.
+ */
+template <typename TAB, typename TC>
+void mult_mixed(const communicator& comm, const config& cfg, const mult_plan& plan,
+                higher_precision_t<TAB,TC> alpha, bool conj_A, const TAB* A,
+                                                  bool conj_B, const TAB* B,
+                higher_precision_t<TAB,TC>  beta, bool conj_C,        TC* C);
+
 }
 }
 
@@ -8,6 +8,7 @@
 #include "internal/1t/dpd/set.hpp"
 #include "internal/3t/dense/mult.hpp"
 
+#include "util/env.hpp"
 #include "util/gemm_thread.hpp"
 #include "util/tensor.hpp"
 
@@ -15,16 +16,132 @@
 
 #include "nodes/gemm.hpp"
 
-#include <atomic>
-
 namespace tblis
 {
 namespace internal
 {
 
-std::atomic<long> flops;
 dpd_impl_t dpd_impl = BLIS;
 
+stride_type dpd_full_max_size = envtol("TBLIS_DPD_FULL_MAX_SIZE", 1l << 27);
+
+dpd_impl_t requested_dpd_impl()
+{
+    switch (current_mult_options().dpd_algorithm)
+    {
+        case DPD_ALGORITHM_BLIS:    return BLIS;
+        case DPD_ALGORITHM_BLOCKED: return BLOCKED;
+        case DPD_ALGORITHM_FULL:    return FULL;
+        default:                    return dpd_impl;
+    }
+}
+
+template <typename T>
+len_type full_length(const dpd_varray_view<T>& A, unsigned dim)
+{
+    len_type len = 0;
+    for (unsigned irrep = 0;irrep < A.num_irreps();irrep++)
+        len += A.length(dim, irrep);
+    return len;
+}
+
+template <typename T>
+stride_type full_size(const dpd_varray_view<T>& A)
+{
+    stride_type size = 1;
+    for (unsigned i = 0;i < A.dimension();i++)
+        size *= full_length(A, i);
+    return size;
+}
+
+/*
+ * For AUTO: FULL is used when the dense operands fit in dpd_full_max_size
+ * and either densifying at most doubles their size, or the blocks of C are
+ * so small (full_max_block elements on average) that the per-block overhead
+ * would dominate. BLOCKED is used on more than one thread when C has enough
+ * blocks of moderate size to keep all of the threads busy, and BLIS
+ * otherwise.
+ */
+constexpr stride_type full_max_block = 16;
+constexpr stride_type blocked_max_block = 1l << 14;
+constexpr unsigned blocked_min_blocks_per_thread = 4;
+
+template <typename T>
+dpd_impl_t auto_dpd_impl(const communicator& comm,
+                         const dpd_varray_view<const T>& A,
+                         const dpd_varray_view<const T>& B,
+                         const dpd_varray_view<      T>& C)
+{
+    if (A.num_irreps() == 1) return BLIS;
+
+    stride_type size_AB = 0;
+    stride_type size_C = 0;
+    stride_type nblock_C = 0;
+
+    A.for_each_block(
+    [&](const varray_view<const T>& local_A, const irrep_vector&)
+    {
+        size_AB += stl_ext::prod(local_A.lengths());
+    });
+
+    B.for_each_block(
+    [&](const varray_view<const T>& local_B, const irrep_vector&)
+    {
+        size_AB += stl_ext::prod(local_B.lengths());
+    });
+
+    C.for_each_block(
+    [&](const varray_view<T>& local_C, const irrep_vector&)
+    {
+        auto size = stl_ext::prod(local_C.lengths());
+        size_C += size;
+        if (size) nblock_C++;
+    });
+
+    if (nblock_C == 0) return BLIS;
+
+    auto size_full = full_size(A) + full_size(B) + full_size(C);
+
+    if ((dpd_full_max_size == 0 || size_full <= dpd_full_max_size) &&
+        (size_full <= 2*(size_AB + size_C) ||
+         size_C <= full_max_block*nblock_C))
+        return FULL;
+
+    unsigned nt = comm.num_threads();
+    if (nt > 1 && nblock_C >= blocked_min_blocks_per_thread*nt &&
+        size_C <= blocked_max_block*nblock_C)
+        return BLOCKED;
+
+    return BLIS;
+}
+
+/*
+ * Split the irreps of dimension dim into at most ngroup contiguous ranges of
+ * roughly equal total length, returned as the range boundaries.
+ */
+template <typename T>
+irrep_vector partition_irreps(const dpd_varray_view<T>& A, unsigned dim,
+                              unsigned ngroup)
+{
+    unsigned nirrep = A.num_irreps();
+
+    len_type len = 0;
+    for (unsigned irrep = 0;irrep < nirrep;irrep++)
+        len += A.length(dim, irrep);
+
+    irrep_vector bounds(1, 0);
+    len_type off = 0;
+    for (unsigned irrep = 0;irrep < nirrep-1;irrep++)
+    {
+        off += A.length(dim, irrep);
+        if (bounds.size() < ngroup && off*ngroup >= len*bounds.size())
+            bounds.push_back(irrep+1);
+    }
+    bounds.push_back(nirrep);
+
+    return bounds;
+}
+
 template <typename T>
 void mult_full(const communicator& comm, const config& cfg,
                T alpha, bool conj_A, const dpd_varray_view<const T>& A,
@@ -40,35 +157,150 @@ void mult_full(const communicator& comm, const config& cfg,
                const dim_vector& idx_C_BC,
                const dim_vector& idx_C_ABC)
 {
+    unsigned nirrep = A.num_irreps();
+
+    /*
+     * Tile along the longest dimension of each of the AB, AC, and BC groups.
+     */
+    auto longest = [&](const auto& A, const dim_vector& idx)
+    {
+        unsigned longest = 0;
+        for (unsigned i = 1;i < idx.size();i++)
+            if (full_length(A, idx[i]) > full_length(A, idx[longest]))
+                longest = i;
+        return longest;
+    };
+
+    bool has_AB = !idx_A_AB.empty();
+    bool has_AC = !idx_A_AC.empty();
+    bool has_BC = !idx_B_BC.empty();
+    unsigned tile_AB = has_AB ? longest(A, idx_A_AB) : 0;
+    unsigned tile_AC = has_AC ? longest(A, idx_A_AC) : 0;
+    unsigned tile_BC = has_BC ? longest(B, idx_B_BC) : 0;
+
+    stride_type size_A = full_size(A);
+    stride_type size_B = full_size(B);
+    stride_type size_C = full_size(C);
+
+    auto working_set = [&](unsigned ntile_AB, unsigned ntile_AC,
+                           unsigned ntile_BC)
+    {
+        return size_A/(ntile_AB*ntile_AC) +
+               size_B/(ntile_AB*ntile_BC) +
+               size_C/(ntile_AC*ntile_BC);
+    };
+
+    /*
+     * Successively halve the tiles in whichever group most reduces the
+     * working set, until it fits or no group can be split further.
+     */
+    unsigned ntile_AB = 1, ntile_AC = 1, ntile_BC = 1;
+    while (dpd_full_max_size > 0 &&
+           working_set(ntile_AB, ntile_AC, ntile_BC) > dpd_full_max_size)
+    {
+        unsigned* best = nullptr;
+        stride_type best_size = working_set(ntile_AB, ntile_AC, ntile_BC);
+
+        for (auto ntile : {&ntile_AB, &ntile_AC, &ntile_BC})
+        {
+            bool has = ntile == &ntile_AB ? has_AB :
+                       ntile == &ntile_AC ? has_AC : has_BC;
+            if (!has || *ntile >= nirrep) continue;
+
+            *ntile *= 2;
+            auto size = working_set(ntile_AB, ntile_AC, ntile_BC);
+            *ntile /= 2;
+
+            if (size < best_size)
+            {
+                best = ntile;
+                best_size = size;
+            }
+        }
+
+        if (!best) break;
+        *best *= 2;
+    }
+
+    irrep_vector bounds_AB = has_AB ? partition_irreps(A, idx_A_AB[tile_AB], ntile_AB)
+                                    : irrep_vector{0, nirrep};
+    irrep_vector bounds_AC = has_AC ? partition_irreps(A, idx_A_AC[tile_AC], ntile_AC)
+                                    : irrep_vector{0, nirrep};
+    irrep_vector bounds_BC = has_BC ? partition_irreps(B, idx_B_BC[tile_BC], ntile_BC)
+                                    : irrep_vector{0, nirrep};
+
     varray<T> A2, B2, C2;
 
     comm.broadcast(
     [&](varray<T>& A2, varray<T>& B2, varray<T>& C2)
     {
-        block_to_full(comm, cfg, A, A2);
-        block_to_full(comm, cfg, B, B2);
-        block_to_full(comm, cfg, C, C2);
-
-        auto len_AB = stl_ext::select_from(A2.lengths(), idx_A_AB);
-        auto len_AC = stl_ext::select_from(C2.lengths(), idx_C_AC);
-        auto len_BC = stl_ext::select_from(C2.lengths(), idx_C_BC);
-        auto len_ABC = stl_ext::select_from(C2.lengths(), idx_C_ABC);
-        auto stride_A_AB = stl_ext::select_from(A2.strides(), idx_A_AB);
-        auto stride_A_AC = stl_ext::select_from(A2.strides(), idx_A_AC);
-        auto stride_B_AB = stl_ext::select_from(B2.strides(), idx_B_AB);
-        auto stride_B_BC = stl_ext::select_from(B2.strides(), idx_B_BC);
-        auto stride_C_AC = stl_ext::select_from(C2.strides(), idx_C_AC);
-        auto stride_C_BC = stl_ext::select_from(C2.strides(), idx_C_BC);
-        auto stride_A_ABC = stl_ext::select_from(A2.strides(), idx_A_ABC);
-        auto stride_B_ABC = stl_ext::select_from(B2.strides(), idx_B_ABC);
-        auto stride_C_ABC = stl_ext::select_from(C2.strides(), idx_C_ABC);
-
-        mult(comm, cfg, len_AB, len_AC, len_BC, len_ABC,
-             alpha, conj_A, A2.data(), stride_A_AB, stride_A_AC, stride_A_ABC,
-                    conj_B, B2.data(), stride_B_AB, stride_B_BC, stride_B_ABC,
-              beta, conj_C, C2.data(), stride_C_AC, stride_C_BC, stride_C_ABC);
-
-        full_to_block(comm, cfg, C2, C);
+        irrep_vector first_A(A.dimension(), 0), last_A(A.dimension(), nirrep);
+        irrep_vector first_B(B.dimension(), 0), last_B(B.dimension(), nirrep);
+        irrep_vector first_C(C.dimension(), 0), last_C(C.dimension(), nirrep);
+
+        for (unsigned tile_AC_ = 0;tile_AC_ < bounds_AC.size()-1;tile_AC_++)
+        for (unsigned tile_BC_ = 0;tile_BC_ < bounds_BC.size()-1;tile_BC_++)
+        {
+            if (has_AC)
+            {
+                first_A[idx_A_AC[tile_AC]] = first_C[idx_C_AC[tile_AC]] = bounds_AC[tile_AC_];
+                 last_A[idx_A_AC[tile_AC]] =  last_C[idx_C_AC[tile_AC]] = bounds_AC[tile_AC_+1];
+            }
+
+            if (has_BC)
+            {
+                first_B[idx_B_BC[tile_BC]] = first_C[idx_C_BC[tile_BC]] = bounds_BC[tile_BC_];
+                 last_B[idx_B_BC[tile_BC]] =  last_C[idx_C_BC[tile_BC]] = bounds_BC[tile_BC_+1];
+            }
+
+            block_to_full(comm, cfg, C, first_C, last_C, C2);
+
+            for (unsigned tile_AB_ = 0;tile_AB_ < bounds_AB.size()-1;tile_AB_++)
+            {
+                if (has_AB)
+                {
+                    first_A[idx_A_AB[tile_AB]] = first_B[idx_B_AB[tile_AB]] = bounds_AB[tile_AB_];
+                     last_A[idx_A_AB[tile_AB]] =  last_B[idx_B_AB[tile_AB]] = bounds_AB[tile_AB_+1];
+                }
+
+                block_to_full(comm, cfg, A, first_A, last_A, A2);
+                block_to_full(comm, cfg, B, first_B, last_B, B2);
+
+                auto len_AB = stl_ext::select_from(A2.lengths(), idx_A_AB);
+                auto len_AC = stl_ext::select_from(C2.lengths(), idx_C_AC);
+                auto len_BC = stl_ext::select_from(C2.lengths(), idx_C_BC);
+                auto len_ABC = stl_ext::select_from(C2.lengths(), idx_C_ABC);
+                auto stride_A_AB = stl_ext::select_from(A2.strides(), idx_A_AB);
+                auto stride_A_AC = stl_ext::select_from(A2.strides(), idx_A_AC);
+                auto stride_B_AB = stl_ext::select_from(B2.strides(), idx_B_AB);
+                auto stride_B_BC = stl_ext::select_from(B2.strides(), idx_B_BC);
+                auto stride_C_AC = stl_ext::select_from(C2.strides(), idx_C_AC);
+                auto stride_C_BC = stl_ext::select_from(C2.strides(), idx_C_BC);
+                auto stride_A_ABC = stl_ext::select_from(A2.strides(), idx_A_ABC);
+                auto stride_B_ABC = stl_ext::select_from(B2.strides(), idx_B_ABC);
+                auto stride_C_ABC = stl_ext::select_from(C2.strides(), idx_C_ABC);
+
+                /*
+                 * Only the first slice of the AB dimensions scales C.
+                 */
+                bool first_AB = tile_AB_ == 0;
+
+                mult(comm, cfg, len_AB, len_AC, len_BC, len_ABC,
+                     alpha, conj_A, A2.data(), stride_A_AB, stride_A_AC, stride_A_ABC,
+                            conj_B, B2.data(), stride_B_AB, stride_B_BC, stride_B_ABC,
+                     first_AB ? beta : T(1), conj_C && first_AB,
+                                   C2.data(), stride_C_AC, stride_C_BC, stride_C_ABC);
+
+                /*
+                 * Empty tiles return without synchronizing, and the
+                 * next tile reallocates the dense slices.
+                 */
+                comm.barrier();
+            }
+
+            full_to_block(comm, cfg, C2, C, first_C, last_C);
+            comm.barrier();
+        }
     },
     A2, B2, C2);
 }
@@ -757,93 +989,137 @@ void mult_block(const communicator& comm, const config& cfg,
     irrep_vector irreps_B(ndim_B);
     irrep_vector irreps_C(ndim_C);
 
-    for (unsigned irrep_ABC = 0;irrep_ABC < nirrep;irrep_ABC++)
-    {
-        if (ndim_ABC == 0 && irrep_ABC != 0) continue;
+    /*
+     * Each block of C is a separate task, weighted by its number of flops,
+     * so that many small blocks can run concurrently on sub-gangs instead
+     * of each one using all threads in turn.
+     */
+    stride_type idx = 0;
 
-        for (unsigned irrep_AB = 0;irrep_AB < nirrep;irrep_AB++)
+    comm.do_tasks_deferred(nirrep*nirrep*nblock_ABC*nblock_AC*nblock_BC,
+                           dense_AB*nblock_AB*dense_AC*dense_BC*dense_ABC/inout_ratio,
+    [&](communicator::deferred_task_set& tasks)
+    {
+        for (unsigned irrep_ABC = 0;irrep_ABC < nirrep;irrep_ABC++)
         {
-            unsigned irrep_AC = A.irrep()^irrep_ABC^irrep_AB;
-            unsigned irrep_BC = C.irrep()^irrep_ABC^irrep_AC;
-
-            if (ndim_AC == 0 && irrep_AC != 0) continue;
-            if (ndim_BC == 0 && irrep_BC != 0) continue;
+            if (ndim_ABC == 0 && irrep_ABC != 0) continue;
 
-            for (stride_type block_ABC = 0;block_ABC < nblock_ABC;block_ABC++)
+            for (unsigned irrep_AB = 0;irrep_AB < nirrep;irrep_AB++)
             {
-                assign_irreps(ndim_ABC, irrep_ABC, nirrep, block_ABC,
-                              irreps_A, idx_A_ABC, irreps_B, idx_B_ABC, irreps_C, idx_C_ABC);
+                unsigned irrep_AC = A.irrep()^irrep_ABC^irrep_AB;
+                unsigned irrep_BC = C.irrep()^irrep_ABC^irrep_AC;
+
+                if (ndim_AC == 0 && irrep_AC != 0) continue;
+                if (ndim_BC == 0 && irrep_BC != 0) continue;
+
+                bool has_AB = (ndim_AB != 0 || irrep_AB == 0) &&
+                              irrep_ABC == (A.irrep()^B.irrep()^C.irrep());
 
-                for (stride_type block_AC = 0;block_AC < nblock_AC;block_AC++)
+                for (stride_type block_ABC = 0;block_ABC < nblock_ABC;block_ABC++)
                 {
-                    assign_irreps(ndim_AC, irrep_AC, nirrep, block_AC,
-                                  irreps_A, idx_A_AC, irreps_C, idx_C_AC);
+                    assign_irreps(ndim_ABC, irrep_ABC, nirrep, block_ABC,
+                                  irreps_A, idx_A_ABC, irreps_B, idx_B_ABC, irreps_C, idx_C_ABC);
 
-                    for (stride_type block_BC = 0;block_BC < nblock_BC;block_BC++)
+                    for (stride_type block_AC = 0;block_AC < nblock_AC;block_AC++)
                     {
-                        assign_irreps(ndim_BC, irrep_BC, nirrep, block_BC,
-                                      irreps_B, idx_B_BC, irreps_C, idx_C_BC);
+                        assign_irreps(ndim_AC, irrep_AC, nirrep, block_AC,
+                                      irreps_A, idx_A_AC, irreps_C, idx_C_AC);
 
-                        if (is_block_empty(C, irreps_C)) continue;
+                        for (stride_type block_BC = 0;block_BC < nblock_BC;block_BC++)
+                        {
+                            assign_irreps(ndim_BC, irrep_BC, nirrep, block_BC,
+                                          irreps_B, idx_B_BC, irreps_C, idx_C_BC);
 
-                        auto local_C = C(irreps_C);
+                            if (is_block_empty(C, irreps_C)) continue;
 
-                        auto len_ABC = stl_ext::select_from(local_C.lengths(), idx_C_ABC);
-                        auto len_AC = stl_ext::select_from(local_C.lengths(), idx_C_AC);
-                        auto len_BC = stl_ext::select_from(local_C.lengths(), idx_C_BC);
-                        auto stride_C_ABC = stl_ext::select_from(local_C.strides(), idx_C_ABC);
-                        auto stride_C_AC = stl_ext::select_from(local_C.strides(), idx_C_AC);
-                        auto stride_C_BC = stl_ext::select_from(local_C.strides(), idx_C_BC);
+                            stride_type len_AB = 0;
+                            if (has_AB)
+                            {
+                                auto local_irreps_A = irreps_A;
 
-                        T beta = beta_;
-                        bool conj_C = conj_C_;
+                                for (stride_type block_AB = 0;block_AB < nblock_AB;block_AB++)
+                                {
+                                    assign_irreps(ndim_AB, irrep_AB, nirrep, block_AB,
+                                                  local_irreps_A, idx_A_AB);
 
-                        if ((ndim_AB != 0 || irrep_AB == 0) &&
-                            irrep_ABC == (A.irrep()^B.irrep()^C.irrep()))
-                        {
-                            for (stride_type block_AB = 0;block_AB < nblock_AB;block_AB++)
-                            {
-                                assign_irreps(ndim_AB, irrep_AB, nirrep, block_AB,
-                                              irreps_A, idx_A_AB, irreps_B, idx_B_AB);
+                                    if (is_block_empty(A, local_irreps_A)) continue;
 
-                                if (is_block_empty(A, irreps_A)) continue;
+                                    stride_type len = 1;
+                                    for (unsigned i : idx_A_AB)
+                                        len *= A.length(i, local_irreps_A[i]);
+                                    len_AB += len;
+                                }
+                            }
 
-                                auto local_A = A(irreps_A);
-                                auto local_B = B(irreps_B);
+                            stride_type size_C = 1;
+                            for (unsigned i = 0;i < ndim_C;i++)
+                                size_C *= C.length(i, irreps_C[i]);
 
-                                auto len_AB = stl_ext::select_from(local_A.lengths(), idx_A_AB);
-                                auto stride_A_ABC = stl_ext::select_from(local_A.strides(), idx_A_ABC);
-                                auto stride_B_ABC = stl_ext::select_from(local_B.strides(), idx_B_ABC);
-                                auto stride_A_AB = stl_ext::select_from(local_A.strides(), idx_A_AB);
-                                auto stride_B_AB = stl_ext::select_from(local_B.strides(), idx_B_AB);
-                                auto stride_A_AC = stl_ext::select_from(local_A.strides(), idx_A_AC);
-                                auto stride_B_BC = stl_ext::select_from(local_B.strides(), idx_B_BC);
+                            tasks.visit(idx++, 2*size_C*std::max<stride_type>(len_AB, 1),
+                            [&,irrep_AB,irreps_A,irreps_B,irreps_C,has_AB]
+                            (const communicator& subcomm)
+                            {
+                                auto local_irreps_A = irreps_A;
+                                auto local_irreps_B = irreps_B;
+                                auto local_C = C(irreps_C);
 
-                                mult(comm, cfg, len_AB, len_AC, len_BC, len_ABC,
-                                     alpha, conj_A, local_A.data(), stride_A_AB, stride_A_AC, stride_A_ABC,
-                                            conj_B, local_B.data(), stride_B_AB, stride_B_BC, stride_B_ABC,
-                                      beta, conj_C, local_C.data(), stride_C_AC, stride_C_BC, stride_C_ABC);
+                                auto len_ABC = stl_ext::select_from(local_C.lengths(), idx_C_ABC);
+                                auto len_AC = stl_ext::select_from(local_C.lengths(), idx_C_AC);
+                                auto len_BC = stl_ext::select_from(local_C.lengths(), idx_C_BC);
+                                auto stride_C_ABC = stl_ext::select_from(local_C.strides(), idx_C_ABC);
+                                auto stride_C_AC = stl_ext::select_from(local_C.strides(), idx_C_AC);
+                                auto stride_C_BC = stl_ext::select_from(local_C.strides(), idx_C_BC);
 
-                                beta = T(1);
-                                conj_C = false;
-                            }
-                        }
+                                T beta = beta_;
+                                bool conj_C = conj_C_;
 
-                        if (beta == T(0))
-                        {
-                            set(comm, cfg, local_C.lengths(),
-                                beta, local_C.data(), local_C.strides());
-                        }
-                        else if (beta != T(1) || (is_complex<T>::value && conj_C))
-                        {
-                            scale(comm, cfg, local_C.lengths(),
-                                  beta, conj_C, local_C.data(), local_C.strides());
+                                if (has_AB)
+                                {
+                                    for (stride_type block_AB = 0;block_AB < nblock_AB;block_AB++)
+                                    {
+                                        assign_irreps(ndim_AB, irrep_AB, nirrep, block_AB,
+                                                      local_irreps_A, idx_A_AB, local_irreps_B, idx_B_AB);
+
+                                        if (is_block_empty(A, local_irreps_A)) continue;
+
+                                        auto local_A = A(local_irreps_A);
+                                        auto local_B = B(local_irreps_B);
+
+                                        auto len_AB = stl_ext::select_from(local_A.lengths(), idx_A_AB);
+                                        auto stride_A_ABC = stl_ext::select_from(local_A.strides(), idx_A_ABC);
+                                        auto stride_B_ABC = stl_ext::select_from(local_B.strides(), idx_B_ABC);
+                                        auto stride_A_AB = stl_ext::select_from(local_A.strides(), idx_A_AB);
+                                        auto stride_B_AB = stl_ext::select_from(local_B.strides(), idx_B_AB);
+                                        auto stride_A_AC = stl_ext::select_from(local_A.strides(), idx_A_AC);
+                                        auto stride_B_BC = stl_ext::select_from(local_B.strides(), idx_B_BC);
+
+                                        mult(subcomm, cfg, len_AB, len_AC, len_BC, len_ABC,
+                                             alpha, conj_A, local_A.data(), stride_A_AB, stride_A_AC, stride_A_ABC,
+                                                    conj_B, local_B.data(), stride_B_AB, stride_B_BC, stride_B_ABC,
+                                              beta, conj_C, local_C.data(), stride_C_AC, stride_C_BC, stride_C_ABC);
+
+                                        beta = T(1);
+                                        conj_C = false;
+                                    }
+                                }
+
+                                if (beta == T(0))
+                                {
+                                    set(subcomm, cfg, local_C.lengths(),
+                                        beta, local_C.data(), local_C.strides());
+                                }
+                                else if (beta != T(1) || (is_complex<T>::value && conj_C))
+                                {
+                                    scale(subcomm, cfg, local_C.lengths(),
+                                          beta, conj_C, local_C.data(), local_C.strides());
+                                }
+                            });
                         }
                     }
                 }
             }
         }
-    }
+    });
 }
 
 template <typename T>
@@ -1079,7 +1355,10 @@ void mult(const communicator& comm, const config& cfg,
           const dim_vector& idx_C_BC,
           const dim_vector& idx_C_ABC)
 {
-    if (dpd_impl == FULL)
+    auto impl = current_mult_options().dpd_algorithm == DPD_ALGORITHM_AUTO ?
+        auto_dpd_impl(comm, A, B, C) : requested_dpd_impl();
+
+    if (impl == FULL)
     {
         mult_full(comm, cfg,
                   alpha, conj_A, A, idx_A_AB, idx_A_AC, idx_A_ABC,
@@ -1089,7 +1368,7 @@ void mult(const communicator& comm, const config& cfg,
         comm.barrier();
         return;
     }
-    else if (dpd_impl == BLOCKED)
+    else if (impl == BLOCKED)
     {
         mult_block(comm, cfg,
                    alpha, conj_A, A, idx_A_AB, idx_A_AC, idx_A_ABC,
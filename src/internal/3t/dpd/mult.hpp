@@ -13,6 +13,23 @@ namespace internal
 enum dpd_impl_t {BLIS, BLOCKED, FULL};
 extern dpd_impl_t dpd_impl;
 
+/*
+ * Maximum number of elements of A, B, and C which the FULL implementation
+ * densifies at one time. Larger contractions are computed in panels of C
+ * (split by irrep along one AC and one BC dimension), accumulating over
+ * slices of the AB dimensions, and written back one panel at a time. Zero
+ * means no limit. The initial value is taken from the environment variable
+ * TBLIS_DPD_FULL_MAX_SIZE.
+ */
+extern stride_type dpd_full_max_size;
+
+/*
+ * The DPD algorithm requested by current_mult_options(), or dpd_impl for
+ * DEFAULT and AUTO (the automatic choice is made by mult, which knows the
+ * block structure of the operands).
+ */
+dpd_impl_t requested_dpd_impl();
+
 template <typename T>
 void mult(const communicator& comm, const config& cfg,
           T alpha, bool conj_A, const dpd_varray_view<const T>& A,
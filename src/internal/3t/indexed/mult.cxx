@@ -104,7 +104,11 @@ void contract_block(const communicator& comm, const config& cfg,
             {
                 if (indices_C[idx_C].factor == T(0)) return;
 
-                tasks.visit(idx++,
+                /*
+                 * The number of dense blocks of A and B which might match is
+                 * a reasonable estimate of the cost.
+                 */
+                tasks.visit(idx++, std::min(next_A-idx_A, next_B-idx_B),
                 [&,idx_A,idx_B,idx_C,next_A,next_B]
                 (const communicator& subcomm)
                 {
@@ -209,7 +213,7 @@ void mult_block(const communicator& comm, const config& cfg,
                 {
                     if (indices_C[idx_C].factor == T(0)) return;
 
-                    tasks.visit(idx++,
+                    tasks.visit(idx++, std::min(next_A_AB-idx_A, next_B_AB-idx_B),
                     [&,idx_A,idx_B,idx_C,next_A_AB,next_B_AB]
                     (const communicator& subcomm)
                     {
@@ -292,7 +296,7 @@ void mult(const communicator& comm, const config& cfg,
         scale(comm, cfg, beta, conj_C, C, range(C.dimension()));
     }
 
-    if (dpd_impl == FULL)
+    if (requested_dpd_impl() == FULL)
     {
         mult_full(comm, cfg,
                   alpha, conj_A, A, idx_A_AB, idx_A_AC, idx_A_ABC,
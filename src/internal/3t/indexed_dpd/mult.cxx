@@ -1278,7 +1278,7 @@ void mult(const communicator& comm, const config& cfg,
         }
     }
 
-    if (dpd_impl == FULL)
+    if (requested_dpd_impl() == FULL)
     {
         mult_full(comm, cfg,
                   alpha, conj_A, A, idx_A_AB, idx_A_AC, idx_A_ABC,
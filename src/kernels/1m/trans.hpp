@@ -8,12 +8,45 @@
 namespace tblis
 {
 
+#define EXTERN_TRANS_UKR(T, name) \
+extern void name(tblis::len_type m, tblis::len_type n, \
+                 T alpha, bool conj_A, const T* A, \
+                 tblis::stride_type rs_A, tblis::stride_type cs_A, \
+                 T  beta, bool conj_B,       T* B, \
+                 tblis::stride_type rs_B, tblis::stride_type cs_B);
+
 template <typename T>
 using trans_ukr_t =
     void (*)(len_type m, len_type n,
              T alpha, bool conj_A, const T* A, stride_type rs_A, stride_type cs_A,
              T  beta, bool conj_B,       T* B, stride_type rs_B, stride_type cs_B);
 
+/*
+ * B = alpha*A + beta*B for an m x n block with any strides, for the edges
+ * (and unusual layouts) in the transpose microkernels. This is static since it
+ * is compiled into kernels for different instruction sets, and the linker
+ * must not pick one of those copies for all of them.
+ */
+template <typename T>
+static void trans_ukr_gen(len_type m, len_type n,
+                   T alpha, bool conj_A, const T* TBLIS_RESTRICT A, stride_type rs_A, stride_type cs_A,
+                   T  beta, bool conj_B,       T* TBLIS_RESTRICT B, stride_type rs_B, stride_type cs_B)
+{
+    if (beta == T(0))
+    {
+         for (len_type i = 0;i < m;i++)
+            for (len_type j = 0;j < n;j++)
+                B[j*cs_B + i*rs_B] = alpha*conj(conj_A, A[i*rs_A + j*cs_A]);
+    }
+    else
+    {
+         for (len_type i = 0;i < m;i++)
+            for (len_type j = 0;j < n;j++)
+                B[j*cs_B + i*rs_B] = alpha*conj(conj_A, A[i*rs_A + j*cs_A]) +
+                                      beta*conj(conj_B, B[j*cs_B + i*rs_B]);
+    }
+}
+
 template <typename Config, typename T>
 void trans_ukr_def(len_type m, len_type n,
                    T alpha, bool conj_A, const T* TBLIS_RESTRICT A, stride_type rs_A, stride_type cs_A,
@@ -171,19 +204,8 @@ void trans_ukr_def(len_type m, len_type n,
     }
     else
     {
-        if (beta == T(0))
-        {
-             for (len_type i = 0;i < m;i++)
-                for (len_type j = 0;j < n;j++)
-                    B[j*cs_B + i*rs_B] = alpha*conj(conj_A, A[i*rs_A + j*cs_A]);
-        }
-        else
-        {
-             for (len_type i = 0;i < m;i++)
-                for (len_type j = 0;j < n;j++)
-                    B[j*cs_B + i*rs_B] = alpha*conj(conj_A, A[i*rs_A + j*cs_A]) +
-                                          beta*conj(conj_B, B[j*cs_B + i*rs_B]);
-        }
+        trans_ukr_gen(m, n, alpha, conj_A, A, rs_A, cs_A,
+                             beta, conj_B, B, rs_B, cs_B);
     }
 }
 
@@ -0,0 +1,456 @@
+#ifndef _TBLIS_KERNELS_1V_SIMD_HPP_
+#define _TBLIS_KERNELS_1V_SIMD_HPP_
+
+#include "add.hpp"
+#include "dot.hpp"
+#include "mult.hpp"
+#include "reduce.hpp"
+#include "scale.hpp"
+#include "set.hpp"
+#include "shift.hpp"
+
+#include <limits>
+
+namespace tblis
+{
+
+/*
+ * Level-1v microkernels for unit-stride vectors, written in terms of a class V
+ * of operations on SIMD vectors of V::NR reals (see configs/haswell/simd.cxx).
+ * TBLIS_SIMD_1V_UKRS defines the exported functions for one type.
+ * Complex numbers are stored as interleaved (real, imaginary) pairs, so only
+ * complex multiplication and the reductions need to know about them. Strided
+ * vectors and the remainders after the last full SIMD vector go to the
+ * default kernels, which are instantiated with V as the config so that each
+ * instruction set gets its own copy.
+ */
+template <typename V, typename T>
+struct simd_1v
+{
+    typedef real_type_t<T> R;
+    typedef typename V::vec vec;
+
+    constexpr static bool Complex = is_complex<T>::value;
+    constexpr static len_type NE = V::NR/(Complex ? 2 : 1);
+
+    static vec load(const T* x) { return V::load(reinterpret_cast<const R*>(x)); }
+
+    static void store(T* x, vec v) { V::store(reinterpret_cast<R*>(x), v); }
+
+    static vec set1(T x)
+    {
+        return V::set2(std::real(x), Complex ? std::imag(x) : std::real(x));
+    }
+
+    static vec conj(bool conj_v, vec v)
+    {
+        return Complex && conj_v ? V::conj(v) : v;
+    }
+
+    /*
+     * a*b, where b_r and b_i are the real and imaginary parts of b in every
+     * element (for real numbers, b_r is just b).
+     */
+    static vec mul(vec a, vec b_r, vec b_i)
+    {
+        if (!Complex) return V::mul(a, b_r);
+        return V::fmaddsub(a, b_r, V::mul(V::swap(a), b_i));
+    }
+
+    static vec mul(vec a, vec b)
+    {
+        if (!Complex) return V::mul(a, b);
+        return mul(a, V::dup_even(b), V::dup_odd(b));
+    }
+
+    static vec real_part(T x) { return V::set1(std::real(x)); }
+
+    static vec imag_part(T x) { return V::set1(Complex ? std::imag(x) : R()); }
+
+    /*
+     * |a| in every element (both halves of each complex number).
+     */
+    static vec abs(vec a)
+    {
+        if (!Complex) return V::abs(a);
+        vec sq = V::mul(a, a);
+        return V::sqrt(V::add(sq, V::swap(sq)));
+    }
+
+    static T sum(vec v)
+    {
+        R x[V::NR];
+        V::store(x, v);
+
+        R s[2] = {};
+        for (len_type i = 0;i < V::NR;i++) s[i%2] += x[i];
+
+        return make_value(s[0], s[1]);
+    }
+
+    template <typename U=T>
+    static detail::enable_if_t<is_complex<U>::value,U> make_value(R re, R im)
+    {
+        return U(re, im);
+    }
+
+    template <typename U=T>
+    static detail::enable_if_t<!is_complex<U>::value,U> make_value(R re, R im)
+    {
+        return re + im;
+    }
+
+    static void add(len_type n,
+                    T alpha, bool conj_A, const T* A, stride_type inc_A,
+                    T  beta, bool conj_B,       T* B, stride_type inc_B)
+    {
+        len_type nv = (inc_A == 1 && inc_B == 1 ? n - n%NE : 0);
+
+        vec alpha_r = real_part(alpha), alpha_i = imag_part(alpha);
+        vec beta_r = real_part(beta), beta_i = imag_part(beta);
+
+        if (beta == T(0))
+        {
+            for (len_type i = 0;i < nv;i += NE)
+                store(B+i, mul(conj(conj_A, load(A+i)), alpha_r, alpha_i));
+        }
+        else
+        {
+            for (len_type i = 0;i < nv;i += NE)
+                store(B+i, V::add(mul(conj(conj_A, load(A+i)), alpha_r, alpha_i),
+                                  mul(conj(conj_B, load(B+i)),  beta_r,  beta_i)));
+        }
+
+        add_ukr_def<V>(n-nv, alpha, conj_A, A+nv*inc_A, inc_A,
+                              beta, conj_B, B+nv*inc_B, inc_B);
+    }
+
+    static void dot(len_type n,
+                    bool conj_A, const T* A, stride_type inc_A,
+                    bool conj_B, const T* B, stride_type inc_B, T& value)
+    {
+        len_type nv = (inc_A == 1 && inc_B == 1 ? n - n%NE : 0);
+
+        if (nv == 0)
+        {
+            dot_ukr_def<V>(n, conj_A, A, inc_A, conj_B, B, inc_B, value);
+            return;
+        }
+
+        /*
+         * Accumulate a_r*b and a_i*b (swapped) separately for complex numbers
+         * and sort out the signs at the end.
+         */
+        vec p[2] = {V::zero(), V::zero()};
+        vec q[2] = {V::zero(), V::zero()};
+
+        len_type i = 0;
+        for (;i+2*NE <= nv;i += 2*NE)
+        {
+            for (int u = 0;u < 2;u++)
+            {
+                vec a = load(A+i+u*NE);
+                vec b = load(B+i+u*NE);
+
+                if (Complex)
+                {
+                    p[u] = V::fma(a, V::dup_even(b), p[u]);
+                    q[u] = V::fma(V::swap(a), V::dup_odd(b), q[u]);
+                }
+                else
+                {
+                    p[u] = V::fma(a, b, p[u]);
+                }
+            }
+        }
+
+        for (;i < nv;i += NE)
+        {
+            vec a = load(A+i);
+            vec b = load(B+i);
+
+            if (Complex)
+            {
+                p[0] = V::fma(a, V::dup_even(b), p[0]);
+                q[0] = V::fma(V::swap(a), V::dup_odd(b), q[0]);
+            }
+            else
+            {
+                p[0] = V::fma(a, b, p[0]);
+            }
+        }
+
+        T sum_p = sum(V::add(p[0], p[1]));
+        T sum_q = sum(V::add(q[0], q[1]));
+
+        /*
+         * With p = (a_r*b_r, a_i*b_r) and q = (a_i*b_i, a_r*b_i), a*b is
+         * (p_r - q_r, p_i + q_i) and a*conj(b) is (p_r + q_r, p_i - q_i).
+         * conj(a)*b is conj(a*conj(b)), and conj(a)*conj(b) is conj(a*b).
+         */
+        bool flip = (conj_A != conj_B);
+        R re = std::real(sum_p) + (flip ? 1 : -1)*std::real(sum_q);
+        R im = std::imag(sum_p) + (flip ? -1 : 1)*std::imag(sum_q);
+        if (!Complex) re = std::real(sum_p);
+
+        T partial = make_value(re, Complex && conj_A ? -im : im);
+        value += partial;
+
+        dot_ukr_def<V>(n-nv, conj_A, A+nv, inc_A, conj_B, B+nv, inc_B, value);
+    }
+
+    static void mult(len_type n,
+                     T alpha, bool conj_A, const T* A, stride_type inc_A,
+                              bool conj_B, const T* B, stride_type inc_B,
+                     T  beta, bool conj_C,       T* C, stride_type inc_C)
+    {
+        len_type nv = (inc_A == 1 && inc_B == 1 && inc_C == 1 ? n - n%NE : 0);
+
+        vec alpha_r = real_part(alpha), alpha_i = imag_part(alpha);
+        vec beta_r = real_part(beta), beta_i = imag_part(beta);
+
+        if (beta == T(0))
+        {
+            for (len_type i = 0;i < nv;i += NE)
+                store(C+i, mul(mul(conj(conj_A, load(A+i)),
+                                   conj(conj_B, load(B+i))), alpha_r, alpha_i));
+        }
+        else
+        {
+            for (len_type i = 0;i < nv;i += NE)
+                store(C+i, V::add(mul(mul(conj(conj_A, load(A+i)),
+                                          conj(conj_B, load(B+i))), alpha_r, alpha_i),
+                                  mul(conj(conj_C, load(C+i)), beta_r, beta_i)));
+        }
+
+        mult_ukr_def<V>(n-nv, alpha, conj_A, A+nv*inc_A, inc_A,
+                                     conj_B, B+nv*inc_B, inc_B,
+                               beta, conj_C, C+nv*inc_C, inc_C);
+    }
+
+    static void scale(len_type n,
+                      T alpha, bool conj_A, T* A, stride_type inc_A)
+    {
+        len_type nv = (inc_A == 1 ? n - n%NE : 0);
+
+        if (alpha == T(0))
+        {
+            for (len_type i = 0;i < nv;i += NE)
+                store(A+i, V::zero());
+        }
+        else
+        {
+            vec alpha_r = real_part(alpha), alpha_i = imag_part(alpha);
+
+            for (len_type i = 0;i < nv;i += NE)
+                store(A+i, mul(conj(conj_A, load(A+i)), alpha_r, alpha_i));
+        }
+
+        scale_ukr_def<V>(n-nv, alpha, conj_A, A+nv*inc_A, inc_A);
+    }
+
+    static void set(len_type n,
+                    T alpha, T* A, stride_type inc_A)
+    {
+        len_type nv = (inc_A == 1 ? n - n%NE : 0);
+
+        vec alpha_v = set1(alpha);
+
+        for (len_type i = 0;i < nv;i += NE)
+            store(A+i, alpha_v);
+
+        set_ukr_def<V>(n-nv, alpha, A+nv*inc_A, inc_A);
+    }
+
+    static void shift(len_type n,
+                      T alpha, T beta, bool conj_A, T* A, stride_type inc_A)
+    {
+        len_type nv = (inc_A == 1 ? n - n%NE : 0);
+
+        vec alpha_v = set1(alpha);
+
+        if (beta == T(0))
+        {
+            for (len_type i = 0;i < nv;i += NE)
+                store(A+i, alpha_v);
+        }
+        else
+        {
+            vec beta_r = real_part(beta), beta_i = imag_part(beta);
+
+            for (len_type i = 0;i < nv;i += NE)
+                store(A+i, V::add(alpha_v, mul(conj(conj_A, load(A+i)), beta_r, beta_i)));
+        }
+
+        shift_ukr_def<V>(n-nv, alpha, beta, conj_A, A+nv*inc_A, inc_A);
+    }
+
+    /*
+     * The value that REDUCE_MAX etc. compare: the element itself (the real
+     * part of complex numbers, with the imaginary parts set to the initial
+     * value so that they never win), or its absolute value.
+     */
+    static vec key(reduce_t op, vec a, vec init)
+    {
+        if (op == REDUCE_MAX_ABS || op == REDUCE_MIN_ABS) return abs(a);
+        return Complex ? V::blend_odd(a, init) : a;
+    }
+
+    static void reduce(reduce_t op, len_type n,
+                       const T* A, stride_type inc_A, T& value, len_type& idx)
+    {
+        len_type nv = (inc_A == 1 ? n - n%NE : 0);
+
+        if (nv == 0)
+        {
+            reduce_ukr_def<V>(op, n, A, inc_A, value, idx);
+            return;
+        }
+
+        if (op == REDUCE_SUM || op == REDUCE_SUM_ABS || op == REDUCE_NORM_2)
+        {
+            vec acc[4] = {V::zero(), V::zero(), V::zero(), V::zero()};
+
+            len_type i = 0;
+            for (;i+4*NE <= nv;i += 4*NE)
+            {
+                for (int u = 0;u < 4;u++)
+                {
+                    vec a = load(A+i+u*NE);
+
+                    if      (op == REDUCE_SUM)     acc[u] = V::add(acc[u], a);
+                    else if (op == REDUCE_SUM_ABS) acc[u] = V::add(acc[u], abs(a));
+                    else                           acc[u] = V::fma(a, a, acc[u]);
+                }
+            }
+
+            for (;i < nv;i += NE)
+            {
+                vec a = load(A+i);
+
+                if      (op == REDUCE_SUM)     acc[0] = V::add(acc[0], a);
+                else if (op == REDUCE_SUM_ABS) acc[0] = V::add(acc[0], abs(a));
+                else                           acc[0] = V::fma(a, a, acc[0]);
+            }
+
+            T total = sum(V::add(V::add(acc[0], acc[1]), V::add(acc[2], acc[3])));
+
+            /*
+             * The absolute value of a complex number is in both halves, and
+             * the norm is the sum of the squares of both parts.
+             */
+            if (op == REDUCE_SUM_ABS && Complex)
+                value += T(std::real(total)/2);
+            else if (op != REDUCE_SUM)
+                value += T(std::real(total) + std::imag(total));
+            else
+                value += total;
+        }
+        else
+        {
+            bool is_max = (op == REDUCE_MAX || op == REDUCE_MAX_ABS);
+
+            /*
+             * Find the extreme value first, skipping NaNs as the scalar
+             * comparisons do (max and min return the second operand if either
+             * one is NaN), and then the first element which has it.
+             */
+            R init = is_max ? -std::numeric_limits<R>::infinity()
+                            :  std::numeric_limits<R>::infinity();
+            vec init_v = V::set1(init);
+            vec best = init_v;
+
+            for (len_type i = 0;i < nv;i += NE)
+            {
+                vec k = key(op, load(A+i), init_v);
+                best = is_max ? V::max(k, best) : V::min(k, best);
+            }
+
+            R x[V::NR];
+            V::store(x, best);
+
+            R m = init;
+            for (len_type i = 0;i < V::NR;i++)
+                if (is_max ? x[i] > m : x[i] < m) m = x[i];
+
+            if (is_max ? m > std::real(value) : m < std::real(value))
+            {
+                vec m_v = V::set1(m);
+
+                for (len_type i = 0;i < nv;i += NE)
+                {
+                    int lane = V::first_eq(key(op, load(A+i), init_v), m_v);
+
+                    if (lane >= 0)
+                    {
+                        idx = i + lane/(Complex ? 2 : 1);
+                        value = (op == REDUCE_MAX || op == REDUCE_MIN ? A[idx] : T(m));
+                        break;
+                    }
+                }
+            }
+
+            T tail_value = value;
+            len_type tail_idx = -1;
+            reduce_ukr_def<V>(op, n-nv, A+nv, inc_A, tail_value, tail_idx);
+
+            if (tail_idx != -1)
+            {
+                value = tail_value;
+                idx = nv + tail_idx;
+            }
+        }
+    }
+};
+
+#define TBLIS_SIMD_1V_UKRS(prefix, V, T) \
+void prefix##add(len_type n, \
+                 T alpha, bool conj_A, const T* A, stride_type inc_A, \
+                 T  beta, bool conj_B,       T* B, stride_type inc_B) \
+{ \
+    simd_1v<V,T>::add(n, alpha, conj_A, A, inc_A, beta, conj_B, B, inc_B); \
+} \
+\
+void prefix##dot(len_type n, \
+                 bool conj_A, const T* A, stride_type inc_A, \
+                 bool conj_B, const T* B, stride_type inc_B, T& value) \
+{ \
+    simd_1v<V,T>::dot(n, conj_A, A, inc_A, conj_B, B, inc_B, value); \
+} \
+\
+void prefix##mult(len_type n, \
+                  T alpha, bool conj_A, const T* A, stride_type inc_A, \
+                           bool conj_B, const T* B, stride_type inc_B, \
+                  T  beta, bool conj_C,       T* C, stride_type inc_C) \
+{ \
+    simd_1v<V,T>::mult(n, alpha, conj_A, A, inc_A, conj_B, B, inc_B, \
+                       beta, conj_C, C, inc_C); \
+} \
+\
+void prefix##reduce(reduce_t op, len_type n, \
+                    const T* A, stride_type inc_A, T& value, len_type& idx) \
+{ \
+    simd_1v<V,T>::reduce(op, n, A, inc_A, value, idx); \
+} \
+\
+void prefix##scale(len_type n, \
+                   T alpha, bool conj_A, T* A, stride_type inc_A) \
+{ \
+    simd_1v<V,T>::scale(n, alpha, conj_A, A, inc_A); \
+} \
+\
+void prefix##set(len_type n, \
+                 T alpha, T* A, stride_type inc_A) \
+{ \
+    simd_1v<V,T>::set(n, alpha, A, inc_A); \
+} \
+\
+void prefix##shift(len_type n, \
+                   T alpha, T beta, bool conj_A, T* A, stride_type inc_A) \
+{ \
+    simd_1v<V,T>::shift(n, alpha, beta, conj_A, A, inc_A); \
+}
+
+}
+
+#endif
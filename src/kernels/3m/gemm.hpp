@@ -27,6 +27,29 @@ void (*)(stride_type k,
         T* c, stride_type rs_c, stride_type cs_c,
         auxinfo_t* aux);
 
+/*
+ * A GEMM microkernel which computes in T but where C is in the other
+ * precision (see other_precision). Unlike gemm_ukr, this kernel is never
+ * called with A and B swapped, even when gemm_flip_ukr is set.
+ */
+#define EXTERN_GEMM_MIXED_UKR(T, name) \
+extern void name(tblis::stride_type k, \
+                 const T* alpha, \
+                 const T* a, const T* b, \
+                 const T* beta, \
+                 tblis::other_precision_t<T>* c, tblis::stride_type rs_c, \
+                                                 tblis::stride_type cs_c, \
+                 auxinfo_t* aux);
+
+template <typename T>
+using gemm_mixed_ukr_t =
+void (*)(stride_type k,
+        const T* alpha,
+        const T* a, const T* b,
+        const T* beta,
+        other_precision_t<T>* c, stride_type rs_c, stride_type cs_c,
+        auxinfo_t* aux);
+
 template <typename Config, typename T>
 void gemm_ukr_def(stride_type k,
                   const T* TBLIS_RESTRICT alpha,
@@ -66,6 +89,58 @@ void gemm_ukr_def(stride_type k,
     }
 }
 
+/*
+ * Compute the microtile in T using the configuration's GEMM microkernel and
+ * then convert it while updating C.
+ */
+template <typename Config, typename T>
+void gemm_mixed_ukr_def(stride_type k,
+                        const T* TBLIS_RESTRICT alpha,
+                        const T* TBLIS_RESTRICT p_a, const T* TBLIS_RESTRICT p_b,
+                        const T* TBLIS_RESTRICT beta,
+                        other_precision_t<T>* TBLIS_RESTRICT p_c,
+                        stride_type rs_c, stride_type cs_c,
+                        auxinfo_t* aux)
+{
+    typedef other_precision_t<T> U;
+
+    constexpr len_type MR = Config::template gemm_mr<T>::def;
+    constexpr len_type NR = Config::template gemm_nr<T>::def;
+    constexpr bool row_major = Config::template gemm_row_major<T>::value;
+    constexpr bool flip_ukr = Config::template gemm_flip_ukr<T>::value;
+    constexpr len_type rs_ab = (row_major ? NR : 1);
+    constexpr len_type cs_ab = (row_major ? 1 : MR);
+
+    T p_ab[MR*NR] __attribute__((aligned(64)));
+    static const T zero = T(0);
+
+    auto ukr = Config::template gemm_ukr<T>::value;
+
+    if (flip_ukr)
+    {
+        auxinfo_t aux_flip{aux->b_next, aux->a_next, aux->c_prefetch};
+        ukr(k, alpha, p_b, p_a, &zero, &p_ab[0], cs_ab, rs_ab, &aux_flip);
+    }
+    else
+    {
+        ukr(k, alpha, p_a, p_b, &zero, &p_ab[0], rs_ab, cs_ab, aux);
+    }
+
+    if (*beta == T(0))
+    {
+        for (len_type j = 0;j < NR;j++)
+            for (len_type i = 0;i < MR;i++)
+                p_c[i*rs_c + j*cs_c] = U(p_ab[i*rs_ab + j*cs_ab]);
+    }
+    else
+    {
+        for (len_type j = 0;j < NR;j++)
+            for (len_type i = 0;i < MR;i++)
+                p_c[i*rs_c + j*cs_c] = U(p_ab[i*rs_ab + j*cs_ab] +
+                                         (*beta)*T(p_c[i*rs_c + j*cs_c]));
+    }
+}
+
 }
 
 #endif
@@ -9,69 +9,69 @@ namespace tblis
 
 #define EXTERN_PACK_NN_UKR(T, name) \
 extern void name(tblis::len_type m, tblis::len_type k, \
-                 const T* p_a, tblis::stride_type rs_a, \
+                 bool conj_a, const T* p_a, tblis::stride_type rs_a, \
                                tblis::stride_type cs_a, \
                  T* p_ap);
 
 template <typename T>
 using pack_nn_ukr_t =
 void (*)(len_type m, len_type k,
-         const T* p_a, stride_type rs_a, stride_type cs_a,
+         bool conj_a, const T* p_a, stride_type rs_a, stride_type cs_a,
          T* p_ap);
 
 #define EXTERN_PACK_NND_UKR(T, name) \
 extern void name(tblis::len_type m, tblis::len_type k, \
-                 const T* p_a, tblis::stride_type rs_a, \
+                 bool conj_a, const T* p_a, tblis::stride_type rs_a, \
                                tblis::stride_type cs_a, \
-                 const T* p_d, tblis::stride_type inc_d, \
+                 bool conj_d, const T* p_d, tblis::stride_type inc_d, \
                  T* p_ap);
 
 template <typename T>
 using pack_nnd_ukr_t =
 void (*)(len_type m, len_type k,
-         const T* p_a, stride_type rs_a, stride_type cs_a,
-         const T* p_d, stride_type inc_d,
+         bool conj_a, const T* p_a, stride_type rs_a, stride_type cs_a,
+         bool conj_d, const T* p_d, stride_type inc_d,
          T* p_ap);
 
 #define EXTERN_PACK_SN_UKR(T, name) \
 extern void name(tblis::len_type m, tblis::len_type k, \
-                 const T* p_a, const tblis::stride_type* rscat_a, \
+                 bool conj_a, const T* p_a, const tblis::stride_type* rscat_a, \
                                tblis::stride_type cs_a, \
                  T* p_ap);
 
 template <typename T>
 using pack_sn_ukr_t =
 void (*)(len_type m, len_type k,
-         const T* p_a, const stride_type* rscat_a, stride_type cs_a,
+         bool conj_a, const T* p_a, const stride_type* rscat_a, stride_type cs_a,
          T* p_ap);
 
 #define EXTERN_PACK_NS_UKR(T, name) \
 extern void name(tblis::len_type m, tblis::len_type k, \
-                 const T* p_a, tblis::stride_type rs_a, \
+                 bool conj_a, const T* p_a, tblis::stride_type rs_a, \
                                const tblis::stride_type* cscat_a, \
                  T* p_ap);
 
 template <typename T>
 using pack_ns_ukr_t =
 void (*)(len_type m, len_type k,
-         const T* p_a, stride_type rs_a, const stride_type* cscat_a,
+         bool conj_a, const T* p_a, stride_type rs_a, const stride_type* cscat_a,
          T* p_ap);
 
 #define EXTERN_PACK_SS_UKR(T, name) \
 extern void name(tblis::len_type m, tblis::len_type k, \
-                 const T* p_a, const tblis::stride_type* rscat_a, \
+                 bool conj_a, const T* p_a, const tblis::stride_type* rscat_a, \
                                const tblis::stride_type* cscat_a, \
                  T* p_ap);
 
 template <typename T>
 using pack_ss_ukr_t =
 void (*)(len_type m, len_type k,
-         const T* p_a, const stride_type* rscat_a, const stride_type* cscat_a,
+         bool conj_a, const T* p_a, const stride_type* rscat_a, const stride_type* cscat_a,
          T* p_ap);
 
 #define EXTERN_PACK_NB_UKR(T, name) \
 extern void name(tblis::len_type m, tblis::len_type k, \
-                 const T* p_a, tblis::stride_type rs_a, \
+                 bool conj_a, const T* p_a, tblis::stride_type rs_a, \
                                const tblis::stride_type* cscat_a, \
                                const tblis::stride_type* cbs_a, \
                  T* p_ap);
@@ -79,13 +79,13 @@ extern void name(tblis::len_type m, tblis::len_type k, \
 template <typename T>
 using pack_nb_ukr_t =
 void (*)(len_type m, len_type k,
-         const T* p_a, stride_type rs_a, const stride_type* cscat_a,
+         bool conj_a, const T* p_a, stride_type rs_a, const stride_type* cscat_a,
          const stride_type* cbs_a,
          T* p_ap);
 
 #define EXTERN_PACK_SB_UKR(T, name) \
 extern void name(tblis::len_type m, tblis::len_type k, \
-                 const T* p_a, const tblis::stride_type* rscat_a, \
+                 bool conj_a, const T* p_a, const tblis::stride_type* rscat_a, \
                                const tblis::stride_type* cscat_a, \
                                const tblis::stride_type* cbs_a, \
                  T* p_ap);
@@ -93,13 +93,47 @@ extern void name(tblis::len_type m, tblis::len_type k, \
 template <typename T>
 using pack_sb_ukr_t =
 void (*)(len_type m, len_type k,
-         const T* p_a, const stride_type* rscat_a, const stride_type* cscat_a,
+         bool conj_a, const T* p_a, const stride_type* rscat_a, const stride_type* cscat_a,
          const stride_type* cbs_a,
          T* p_ap);
 
+/*
+ * Mixed-precision versions of the nb and sb kernels, which read the
+ * matrix in the other precision (see other_precision) and pack it as T.
+ */
+#define EXTERN_PACK_NB_MIXED_UKR(T, name) \
+extern void name(tblis::len_type m, tblis::len_type k, \
+                 bool conj_a, const tblis::other_precision_t<T>* p_a, \
+                               tblis::stride_type rs_a, \
+                               const tblis::stride_type* cscat_a, \
+                               const tblis::stride_type* cbs_a, \
+                 T* p_ap);
+
+template <typename T>
+using pack_nb_mixed_ukr_t =
+void (*)(len_type m, len_type k,
+         bool conj_a, const other_precision_t<T>* p_a, stride_type rs_a,
+         const stride_type* cscat_a, const stride_type* cbs_a,
+         T* p_ap);
+
+#define EXTERN_PACK_SB_MIXED_UKR(T, name) \
+extern void name(tblis::len_type m, tblis::len_type k, \
+                 bool conj_a, const tblis::other_precision_t<T>* p_a, \
+                               const tblis::stride_type* rscat_a, \
+                               const tblis::stride_type* cscat_a, \
+                               const tblis::stride_type* cbs_a, \
+                 T* p_ap);
+
+template <typename T>
+using pack_sb_mixed_ukr_t =
+void (*)(len_type m, len_type k,
+         bool conj_a, const other_precision_t<T>* p_a, const stride_type* rscat_a,
+         const stride_type* cscat_a, const stride_type* cbs_a,
+         T* p_ap);
+
 #define EXTERN_PACK_SS_SCAL_UKR(T, name) \
 extern void name(tblis::len_type m, tblis::len_type k, \
-                 const T* p_a, const tblis::stride_type* rscat_a, \
+                 bool conj_a, const T* p_a, const tblis::stride_type* rscat_a, \
                                const T* rscale_a, \
                                const tblis::stride_type* cscat_a, \
                                const T* cscale_a, \
@@ -108,12 +142,12 @@ extern void name(tblis::len_type m, tblis::len_type k, \
 template <typename T>
 using pack_ss_scal_ukr_t =
 void (*)(len_type m, len_type k,
-         const T* p_a, const stride_type* rscat_a, const T* rscale_a,
+         bool conj_a, const T* p_a, const stride_type* rscat_a, const T* rscale_a,
          const stride_type* cscat_a, const T* cscale_a, T* p_ap);
 
 template <typename Config, typename T, int Mat>
 void pack_nn_ukr_def(len_type m, len_type k,
-                     const T* TBLIS_RESTRICT p_a, stride_type rs_a, stride_type cs_a,
+                     bool conj_a, const T* TBLIS_RESTRICT p_a, stride_type rs_a, stride_type cs_a,
                      T* TBLIS_RESTRICT p_ap)
 {
     using namespace matrix_constants;
@@ -129,7 +163,7 @@ void pack_nn_ukr_def(len_type m, len_type k,
         {
             #pragma omp simd
             for (len_type mr = 0;mr < MR;mr++)
-                p_ap[mr] = p_a[mr];
+                p_ap[mr] = conj(conj_a, p_a[mr]);
 
             p_a += cs_a;
             p_ap += ME;
@@ -142,7 +176,7 @@ void pack_nn_ukr_def(len_type m, len_type k,
         {
             for (len_type kr = 0;kr < KR;kr++)
                 for (len_type mr = 0;mr < MR;mr++)
-                    p_ap[mr + ME*kr] = p_a[rs_a*mr + kr];
+                    p_ap[mr + ME*kr] = conj(conj_a, p_a[rs_a*mr + kr]);
 
             p_a += KR;
             p_ap += ME*KR;
@@ -150,14 +184,14 @@ void pack_nn_ukr_def(len_type m, len_type k,
 
         for (len_type kr = 0;kr < k-p;kr++)
             for (len_type mr = 0;mr < MR;mr++)
-                p_ap[mr + ME*kr] = p_a[rs_a*mr + kr];
+                p_ap[mr + ME*kr] = conj(conj_a, p_a[rs_a*mr + kr]);
     }
     else
     {
         for (len_type p = 0;p < k;p++)
         {
             for (len_type mr = 0;mr < m;mr++)
-                p_ap[mr + ME*p] = p_a[rs_a*mr + cs_a*p];
+                p_ap[mr + ME*p] = conj(conj_a, p_a[rs_a*mr + cs_a*p]);
 
             for (len_type mr = m;mr < MR;mr++)
                 p_ap[mr + ME*p] = T();
@@ -167,8 +201,8 @@ void pack_nn_ukr_def(len_type m, len_type k,
 
 template <typename Config, typename T, int Mat>
 void pack_nnd_ukr_def(len_type m, len_type k,
-                      const T* TBLIS_RESTRICT p_a, stride_type rs_a, stride_type cs_a,
-                      const T* TBLIS_RESTRICT p_d, stride_type inc_d,
+                      bool conj_a, const T* TBLIS_RESTRICT p_a, stride_type rs_a, stride_type cs_a,
+                      bool conj_d, const T* TBLIS_RESTRICT p_d, stride_type inc_d,
                       T* TBLIS_RESTRICT p_ap)
 {
     using namespace matrix_constants;
@@ -184,7 +218,7 @@ void pack_nnd_ukr_def(len_type m, len_type k,
         {
             #pragma omp simd
             for (len_type mr = 0;mr < MR;mr++)
-                p_ap[mr] = p_a[mr] * (*p_d);
+                p_ap[mr] = conj(conj_a, p_a[mr]) * conj(conj_d, *p_d);
 
             p_a += cs_a;
             p_d += inc_d;
@@ -198,7 +232,7 @@ void pack_nnd_ukr_def(len_type m, len_type k,
         {
             for (len_type kr = 0;kr < KR;kr++)
                 for (len_type mr = 0;mr < MR;mr++)
-                    p_ap[mr + ME*kr] = p_a[rs_a*mr + kr] * p_d[kr*inc_d];
+                    p_ap[mr + ME*kr] = conj(conj_a, p_a[rs_a*mr + kr]) * conj(conj_d, p_d[kr*inc_d]);
 
             p_a += KR;
             p_d += inc_d*KR;
@@ -207,14 +241,14 @@ void pack_nnd_ukr_def(len_type m, len_type k,
 
         for (len_type kr = 0;kr < k-p;kr++)
             for (len_type mr = 0;mr < MR;mr++)
-                p_ap[mr + ME*kr] = p_a[rs_a*mr + kr] * p_d[kr*inc_d];
+                p_ap[mr + ME*kr] = conj(conj_a, p_a[rs_a*mr + kr]) * conj(conj_d, p_d[kr*inc_d]);
     }
     else
     {
         for (len_type p = 0;p < k;p++)
         {
             for (len_type mr = 0;mr < m;mr++)
-                p_ap[mr + ME*p] = p_a[rs_a*mr + cs_a*p] * p_d[inc_d*p];
+                p_ap[mr + ME*p] = conj(conj_a, p_a[rs_a*mr + cs_a*p]) * conj(conj_d, p_d[inc_d*p]);
 
             for (len_type mr = m;mr < MR;mr++)
                 p_ap[mr + ME*p] = T();
@@ -224,7 +258,7 @@ void pack_nnd_ukr_def(len_type m, len_type k,
 
 template <typename Config, typename T, int Mat>
 void pack_sn_ukr_def(len_type m, len_type k,
-                     const T* TBLIS_RESTRICT p_a,
+                     bool conj_a, const T* TBLIS_RESTRICT p_a,
                      const stride_type* TBLIS_RESTRICT rscat_a, stride_type cs_a,
                      T* TBLIS_RESTRICT p_ap)
 {
@@ -237,7 +271,7 @@ void pack_sn_ukr_def(len_type m, len_type k,
     for (len_type p = 0;p < k;p++)
     {
         for (len_type mr = 0;mr < m;mr++)
-            p_ap[mr + ME*p] = p_a[rscat_a[mr] + cs_a*p];
+            p_ap[mr + ME*p] = conj(conj_a, p_a[rscat_a[mr] + cs_a*p]);
 
         for (len_type mr = m;mr < MR;mr++)
             p_ap[mr + ME*p] = T();
@@ -246,7 +280,7 @@ void pack_sn_ukr_def(len_type m, len_type k,
 
 template <typename Config, typename T, int Mat>
 void pack_ns_ukr_def(len_type m, len_type k,
-                     const T* TBLIS_RESTRICT p_a,
+                     bool conj_a, const T* TBLIS_RESTRICT p_a,
                      stride_type rs_a, const stride_type* TBLIS_RESTRICT cscat_a,
                      T* TBLIS_RESTRICT p_ap)
 {
@@ -259,7 +293,7 @@ void pack_ns_ukr_def(len_type m, len_type k,
     for (len_type p = 0;p < k;p++)
     {
         for (len_type mr = 0;mr < m;mr++)
-            p_ap[mr + ME*p] = p_a[rs_a*mr + cscat_a[p]];
+            p_ap[mr + ME*p] = conj(conj_a, p_a[rs_a*mr + cscat_a[p]]);
 
         for (len_type mr = m;mr < MR;mr++)
             p_ap[mr + ME*p] = T();
@@ -268,7 +302,7 @@ void pack_ns_ukr_def(len_type m, len_type k,
 
 template <typename Config, typename T, int Mat>
 void pack_ss_ukr_def(len_type m, len_type k,
-                     const T* TBLIS_RESTRICT p_a,
+                     bool conj_a, const T* TBLIS_RESTRICT p_a,
                      const stride_type* TBLIS_RESTRICT rscat_a,
                      const stride_type* TBLIS_RESTRICT cscat_a,
                      T* TBLIS_RESTRICT p_ap)
@@ -282,16 +316,16 @@ void pack_ss_ukr_def(len_type m, len_type k,
     for (len_type p = 0;p < k;p++)
     {
         for (len_type mr = 0;mr < m;mr++)
-            p_ap[mr + ME*p] = p_a[rscat_a[mr] + cscat_a[p]];
+            p_ap[mr + ME*p] = conj(conj_a, p_a[rscat_a[mr] + cscat_a[p]]);
 
         for (len_type mr = m;mr < MR;mr++)
             p_ap[mr + ME*p] = T();
     }
 }
 
-template <typename Config, typename T, int Mat>
+template <typename Config, typename T, int Mat, typename U=T>
 void pack_nb_ukr_def(len_type m, len_type k,
-                     const T* TBLIS_RESTRICT p_a,
+                     bool conj_a, const U* TBLIS_RESTRICT p_a,
                      stride_type rs_a, const stride_type* TBLIS_RESTRICT cscat_a,
                      const stride_type* TBLIS_RESTRICT cbs_a,
                      T* TBLIS_RESTRICT p_ap)
@@ -316,14 +350,14 @@ void pack_nb_ukr_def(len_type m, len_type k,
                 for (len_type kr = 0;kr < k_loc;kr++)
                     #pragma omp simd
                     for (len_type mr = 0;mr < MR;mr++)
-                        p_ap[mr + ME*kr] = p_a[mr + cs_a*kr + off_a];
+                        p_ap[mr + ME*kr] = conj(conj_a, p_a[mr + cs_a*kr + off_a]);
             }
             else
             {
                 for (len_type kr = 0;kr < k_loc;kr++)
                     #pragma omp simd
                     for (len_type mr = 0;mr < MR;mr++)
-                        p_ap[mr + ME*kr] = p_a[mr + cscat_a[kr]];
+                        p_ap[mr + ME*kr] = conj(conj_a, p_a[mr + cscat_a[kr]]);
             }
 
             p_ap += ME*KR;
@@ -343,19 +377,19 @@ void pack_nb_ukr_def(len_type m, len_type k,
             {
                 for (len_type kr = 0;kr < k_loc;kr++)
                     for (len_type mr = 0;mr < MR;mr++)
-                        p_ap[mr + ME*kr] = p_a[rs_a*mr + kr + off_a];
+                        p_ap[mr + ME*kr] = conj(conj_a, p_a[rs_a*mr + kr + off_a]);
             }
             else if (cs_a)
             {
                 for (len_type kr = 0;kr < k_loc;kr++)
                     for (len_type mr = 0;mr < MR;mr++)
-                        p_ap[mr + ME*kr] = p_a[rs_a*mr + cs_a*kr + off_a];
+                        p_ap[mr + ME*kr] = conj(conj_a, p_a[rs_a*mr + cs_a*kr + off_a]);
             }
             else
             {
                 for (len_type kr = 0;kr < k_loc;kr++)
                     for (len_type mr = 0;mr < MR;mr++)
-                        p_ap[mr + ME*kr] = p_a[rs_a*mr + cscat_a[kr]];
+                        p_ap[mr + ME*kr] = conj(conj_a, p_a[rs_a*mr + cscat_a[kr]]);
             }
 
             p_ap += ME*KR;
@@ -368,7 +402,7 @@ void pack_nb_ukr_def(len_type m, len_type k,
         for (len_type p = 0;p < k;p++)
         {
             for (len_type mr = 0;mr < m;mr++)
-                p_ap[mr + ME*p] = p_a[rs_a*mr + cscat_a[p]];
+                p_ap[mr + ME*p] = conj(conj_a, p_a[rs_a*mr + cscat_a[p]]);
 
             for (len_type mr = m;mr < MR;mr++)
                 p_ap[mr + ME*p] = T();
@@ -376,9 +410,9 @@ void pack_nb_ukr_def(len_type m, len_type k,
     }
 }
 
-template <typename Config, typename T, int Mat>
+template <typename Config, typename T, int Mat, typename U=T>
 void pack_sb_ukr_def(len_type m, len_type k,
-                     const T* TBLIS_RESTRICT p_a,
+                     bool conj_a, const U* TBLIS_RESTRICT p_a,
                      const stride_type* TBLIS_RESTRICT rscat_a,
                      const stride_type* TBLIS_RESTRICT cscat_a,
                      const stride_type* TBLIS_RESTRICT cbs_a,
@@ -395,16 +429,37 @@ void pack_sb_ukr_def(len_type m, len_type k,
     for (len_type p = 0;p < k;p++)
     {
         for (len_type mr = 0;mr < m;mr++)
-            p_ap[mr + ME*p] = p_a[rscat_a[mr] + cscat_a[p]];
+            p_ap[mr + ME*p] = conj(conj_a, p_a[rscat_a[mr] + cscat_a[p]]);
 
         for (len_type mr = m;mr < MR;mr++)
             p_ap[mr + ME*p] = T();
     }
 }
 
+template <typename Config, typename T, int Mat>
+void pack_nb_mixed_ukr_def(len_type m, len_type k,
+                           bool conj_a, const other_precision_t<T>* TBLIS_RESTRICT p_a,
+                           stride_type rs_a, const stride_type* TBLIS_RESTRICT cscat_a,
+                           const stride_type* TBLIS_RESTRICT cbs_a,
+                           T* TBLIS_RESTRICT p_ap)
+{
+    pack_nb_ukr_def<Config, T, Mat>(m, k, conj_a, p_a, rs_a, cscat_a, cbs_a, p_ap);
+}
+
+template <typename Config, typename T, int Mat>
+void pack_sb_mixed_ukr_def(len_type m, len_type k,
+                           bool conj_a, const other_precision_t<T>* TBLIS_RESTRICT p_a,
+                           const stride_type* TBLIS_RESTRICT rscat_a,
+                           const stride_type* TBLIS_RESTRICT cscat_a,
+                           const stride_type* TBLIS_RESTRICT cbs_a,
+                           T* TBLIS_RESTRICT p_ap)
+{
+    pack_sb_ukr_def<Config, T, Mat>(m, k, conj_a, p_a, rscat_a, cscat_a, cbs_a, p_ap);
+}
+
 template <typename Config, typename T, int Mat>
 void pack_ss_scal_ukr_def(len_type m, len_type k,
-                          const T* TBLIS_RESTRICT p_a,
+                          bool conj_a, const T* TBLIS_RESTRICT p_a,
                           const stride_type* TBLIS_RESTRICT rscat_a,
                           const T* TBLIS_RESTRICT rscale_a,
                           const stride_type* TBLIS_RESTRICT cscat_a,
@@ -421,14 +476,14 @@ void pack_ss_scal_ukr_def(len_type m, len_type k,
     {
         for (len_type p = 0;p < k;p++)
             for (len_type mr = 0;mr < MR;mr++)
-                p_ap[mr + ME*p] = p_a[rscat_a[mr] + cscat_a[p]] * rscale_a[mr] * cscale_a[p];
+                p_ap[mr + ME*p] = conj(conj_a, p_a[rscat_a[mr] + cscat_a[p]]) * rscale_a[mr] * cscale_a[p];
     }
     else
     {
         for (len_type p = 0;p < k;p++)
         {
             for (len_type mr = 0;mr < m;mr++)
-                p_ap[mr + ME*p] = p_a[rscat_a[mr] + cscat_a[p]] * rscale_a[mr] * cscale_a[p];
+                p_ap[mr + ME*p] = conj(conj_a, p_a[rscat_a[mr] + cscat_a[p]]) * rscale_a[mr] * cscale_a[p];
 
             for (len_type mr = m;mr < MR;mr++)
                 p_ap[mr + ME*p] = T();
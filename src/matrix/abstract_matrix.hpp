@@ -18,6 +18,7 @@ class abstract_matrix
         std::array<len_type,2> tot_len_ = {};
         std::array<len_type,2> cur_len_ = {};
         std::array<len_type,2> off_ = {};
+        bool conj_ = false;
 
     public:
         abstract_matrix() {}
@@ -45,6 +46,17 @@ class abstract_matrix
             return cur_len_;
         }
 
+        bool conj() const
+        {
+            return conj_;
+        }
+
+        bool conj(bool conj)
+        {
+            std::swap(conj, conj_);
+            return conj;
+        }
+
         void shift(unsigned dim, len_type n)
         {
             TBLIS_ASSERT(dim < 2);
@@ -52,6 +52,7 @@ template <typename T>
 class block_scatter_matrix : public abstract_matrix<T>
 {
     template <typename> friend class patch_block_scatter_matrix;
+    template <typename> friend class diag_scaled_tensor_matrix;
 
     public:
         typedef const stride_type* scatter_type;
@@ -60,6 +61,7 @@ class block_scatter_matrix : public abstract_matrix<T>
         using abstract_matrix<T>::tot_len_;
         using abstract_matrix<T>::cur_len_;
         using abstract_matrix<T>::off_;
+        using abstract_matrix<T>::conj_;
         T* data_ = nullptr;
         std::array<stride_type*, 2> scatter_ = {};
         std::array<stride_type*, 2> block_stride_ = {};
@@ -257,6 +259,52 @@ class block_scatter_matrix : public abstract_matrix<T>
             fill_block_stride(BS, size, scat, bs);
         }
 
+        static void pack_nb(const config& cfg, bool trans, len_type m, len_type k,
+                            bool conj_a, const T* p_a, stride_type rs_a,
+                            scatter_type cscat_a, scatter_type cbs_a, T* p_ap)
+        {
+            if (!trans)
+                cfg.pack_nb_mr_ukr.call<T>(m, k, conj_a, p_a, rs_a, cscat_a, cbs_a, p_ap);
+            else
+                cfg.pack_nb_nr_ukr.call<T>(m, k, conj_a, p_a, rs_a, cscat_a, cbs_a, p_ap);
+        }
+
+        static void pack_nb(const config& cfg, bool trans, len_type m, len_type k,
+                            bool conj_a, const T* p_a, stride_type rs_a,
+                            scatter_type cscat_a, scatter_type cbs_a,
+                            other_precision_t<T>* p_ap)
+        {
+            typedef other_precision_t<T> U;
+
+            if (!trans)
+                cfg.pack_nb_mixed_mr_ukr.call<U>(m, k, conj_a, p_a, rs_a, cscat_a, cbs_a, p_ap);
+            else
+                cfg.pack_nb_mixed_nr_ukr.call<U>(m, k, conj_a, p_a, rs_a, cscat_a, cbs_a, p_ap);
+        }
+
+        static void pack_sb(const config& cfg, bool trans, len_type m, len_type k,
+                            bool conj_a, const T* p_a, scatter_type rscat_a,
+                            scatter_type cscat_a, scatter_type cbs_a, T* p_ap)
+        {
+            if (!trans)
+                cfg.pack_sb_mr_ukr.call<T>(m, k, conj_a, p_a, rscat_a, cscat_a, cbs_a, p_ap);
+            else
+                cfg.pack_sb_nr_ukr.call<T>(m, k, conj_a, p_a, rscat_a, cscat_a, cbs_a, p_ap);
+        }
+
+        static void pack_sb(const config& cfg, bool trans, len_type m, len_type k,
+                            bool conj_a, const T* p_a, scatter_type rscat_a,
+                            scatter_type cscat_a, scatter_type cbs_a,
+                            other_precision_t<T>* p_ap)
+        {
+            typedef other_precision_t<T> U;
+
+            if (!trans)
+                cfg.pack_sb_mixed_mr_ukr.call<U>(m, k, conj_a, p_a, rscat_a, cscat_a, cbs_a, p_ap);
+            else
+                cfg.pack_sb_mixed_nr_ukr.call<U>(m, k, conj_a, p_a, rscat_a, cscat_a, cbs_a, p_ap);
+        }
+
     public:
         block_scatter_matrix() {}
 
@@ -266,6 +314,7 @@ class block_scatter_matrix : public abstract_matrix<T>
         {
             data_ = A.data_;
             tot_len_ = cur_len_ = A.cur_len_;
+            conj_ = A.conj();
             scatter_ = {rscat, cscat};
             block_stride_ = {rbs, cbs};
             block_size_ = {MB, NB};
@@ -287,6 +336,7 @@ class block_scatter_matrix : public abstract_matrix<T>
         {
             data_ = A.data_;
             tot_len_ = cur_len_ = A.cur_len_;
+            conj_ = A.conj();
             scatter_ = {rscat, cscat};
             block_stride_ = {rbs, cbs};
             block_size_ = {MB, NB};
@@ -369,14 +419,19 @@ class block_scatter_matrix : public abstract_matrix<T>
             data = data_ + (rbs ? *rscat : 0) + (cbs ? *cscat : 0);
         }
 
+        /*
+         * Pack into Ap, which may be in the other precision (the packing
+         * microkernels then convert).
+         */
+        template <typename U>
         void pack(const communicator& comm, const config& cfg,
-                  bool trans, normal_matrix<T>& Ap) const
+                  bool trans, normal_matrix<U>& Ap) const
         {
-            const len_type MR = (!trans ? cfg.gemm_mr.def<T>()
-                                        : cfg.gemm_nr.def<T>());
-            const len_type ME = (!trans ? cfg.gemm_mr.extent<T>()
-                                        : cfg.gemm_nr.extent<T>());
-            const len_type KR = cfg.gemm_kr.def<T>();
+            const len_type MR = (!trans ? cfg.gemm_mr.def<U>()
+                                        : cfg.gemm_nr.def<U>());
+            const len_type ME = (!trans ? cfg.gemm_mr.extent<U>()
+                                        : cfg.gemm_nr.extent<U>());
+            const len_type KR = cfg.gemm_kr.def<U>();
 
             TBLIS_ASSERT(block_size_[ trans] == MR);
             TBLIS_ASSERT(block_size_[!trans] == KR);
@@ -387,7 +442,7 @@ class block_scatter_matrix : public abstract_matrix<T>
             comm.distribute_over_threads({m_a, MR}, {k_a, KR},
             [&](len_type m_first, len_type m_last, len_type k_first, len_type k_last)
             {
-                T* p_ap = Ap.data() + (m_first/MR)*ME*Ap.stride(trans) + k_first*ME;
+                U* p_ap = Ap.data() + (m_first/MR)*ME*Ap.stride(trans) + k_first*ME;
                 scatter_type rscat_a = scatter_[ trans] + off_[ trans] + m_first;
                 scatter_type cscat_a = scatter_[!trans] + off_[!trans] + k_first;
                 scatter_type rbs_a = block_stride_[ trans] + off_[ trans] + m_first;
@@ -408,19 +463,9 @@ class block_scatter_matrix : public abstract_matrix<T>
                     TBLIS_ASSERT(p_ap + k*ME <= Ap.data() + ceil_div(Ap.length(trans), MR)*ME*Ap.length(!trans));
 
                     if (rs_a)
-                    {
-                        if (!trans)
-                            cfg.pack_nb_mr_ukr.call<T>(m, k, p_a, rs_a, cscat_a, cbs_a, p_ap);
-                        else
-                            cfg.pack_nb_nr_ukr.call<T>(m, k, p_a, rs_a, cscat_a, cbs_a, p_ap);
-                    }
+                        pack_nb(cfg, trans, m, k, conj_, p_a, rs_a, cscat_a, cbs_a, p_ap);
                     else
-                    {
-                        if (!trans)
-                            cfg.pack_sb_mr_ukr.call<T>(m, k, p_a, rscat_a, cscat_a, cbs_a, p_ap);
-                        else
-                            cfg.pack_sb_nr_ukr.call<T>(m, k, p_a, rscat_a, cscat_a, cbs_a, p_ap);
-                    }
+                        pack_sb(cfg, trans, m, k, conj_, p_a, rscat_a, cscat_a, cbs_a, p_ap);
 
                     p_ap += ME*Ap.stride(trans);
                     m_off += MR;
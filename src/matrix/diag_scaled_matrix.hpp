@@ -17,9 +17,11 @@ class diag_scaled_matrix : public normal_matrix<T>
         using normal_matrix<T>::cur_len_;
         using normal_matrix<T>::off_;
         using normal_matrix<T>::stride_;
+        using normal_matrix<T>::conj_;
         unsigned diag_dim_ = 0;
         T* diag_ = nullptr;
         stride_type diag_stride_ = 0;
+        bool diag_conj_ = false;
 
     public:
         diag_scaled_matrix() {}
@@ -39,6 +41,17 @@ class diag_scaled_matrix : public normal_matrix<T>
             return diag_stride_;
         }
 
+        bool diag_conj() const
+        {
+            return diag_conj_;
+        }
+
+        bool diag_conj(bool conj)
+        {
+            std::swap(conj, diag_conj_);
+            return conj;
+        }
+
         void transpose()
         {
             normal_matrix<T>::transpose();
@@ -79,9 +92,9 @@ class diag_scaled_matrix : public normal_matrix<T>
                     TBLIS_ASSERT(p_ap + k*ME <= Ap.data() + Ap.length(0)*Ap.length(1));
 
                     if (!trans)
-                        cfg.pack_nnd_mr_ukr.call<T>(m, k, p_a, rs_a, cs_a, p_d, inc_d, p_ap);
+                        cfg.pack_nnd_mr_ukr.call<T>(m, k, conj_, p_a, rs_a, cs_a, diag_conj_, p_d, inc_d, p_ap);
                     else
-                        cfg.pack_nnd_nr_ukr.call<T>(m, k, p_a, rs_a, cs_a, p_d, inc_d, p_ap);
+                        cfg.pack_nnd_nr_ukr.call<T>(m, k, conj_, p_a, rs_a, cs_a, diag_conj_, p_d, inc_d, p_ap);
 
                     p_a += m*rs_a;
                     p_ap += ME*k_a;
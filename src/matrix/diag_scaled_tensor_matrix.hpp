@@ -0,0 +1,160 @@
+#ifndef _TBLIS_DIAG_SCALED_TENSOR_MATRIX_HPP_
+#define _TBLIS_DIAG_SCALED_TENSOR_MATRIX_HPP_
+
+#include "util/basic_types.h"
+#include "util/thread.h"
+
+#include "memory/alignment.hpp"
+#include "memory/memory_pool.hpp"
+
+#include "tensor_matrix.hpp"
+#include "block_scatter_matrix.hpp"
+
+namespace tblis
+{
+
+extern MemoryPool BuffersForScatter;
+
+/*
+ * A tensor matrix scaled by a tensor D along one of its dimensions, i.e.
+ * A*diag(D) or diag(D)*A, where D has one stride for each of the tensor
+ * dimensions making up that matrix dimension (zero where D does not depend
+ * on one). Like diag_scaled_matrix, the scaling is done while packing, and
+ * the scatter vectors are built by each thread for the part that it packs,
+ * so no matrify step is needed.
+ */
+template <typename T>
+class diag_scaled_tensor_matrix : public tensor_matrix<T>
+{
+    public:
+        static constexpr bool needs_matrify = false;
+
+    protected:
+        using tensor_matrix<T>::tot_len_;
+        using tensor_matrix<T>::cur_len_;
+        using tensor_matrix<T>::off_;
+        using tensor_matrix<T>::conj_;
+        using tensor_matrix<T>::data_;
+        using tensor_matrix<T>::lens_;
+        using tensor_matrix<T>::strides_;
+        unsigned diag_dim_ = 0;
+        T* diag_ = nullptr;
+        stride_vector diag_strides_;
+        bool diag_conj_ = false;
+
+    public:
+        diag_scaled_tensor_matrix() {}
+
+        template <typename U, typename V, typename W, typename X, typename Y>
+        diag_scaled_tensor_matrix(const U& len_m,
+                                  const V& len_n,
+                                  T* ptr,
+                                  const W& stride_m,
+                                  const X& stride_n,
+                                  unsigned diag_dim,
+                                  T* diag,
+                                  const Y& diag_stride)
+        : tensor_matrix<T>(len_m, len_n, ptr, stride_m, stride_n),
+          diag_dim_(diag_dim), diag_(diag),
+          diag_strides_(diag_stride.begin(), diag_stride.end())
+        {
+            TBLIS_ASSERT(diag_dim < 2);
+            TBLIS_ASSERT(diag_strides_.size() == lens_[diag_dim].size());
+        }
+
+        T* diag() const
+        {
+            return diag_;
+        }
+
+        T* diag(T* ptr)
+        {
+            std::swap(diag_, ptr);
+            return ptr;
+        }
+
+        bool diag_conj() const
+        {
+            return diag_conj_;
+        }
+
+        bool diag_conj(bool conj)
+        {
+            std::swap(conj, diag_conj_);
+            return conj;
+        }
+
+        void transpose()
+        {
+            tensor_matrix<T>::transpose();
+            diag_dim_ = 1-diag_dim_;
+        }
+
+        void pack(const communicator& comm, const config& cfg, bool trans, normal_matrix<T>& Ap) const
+        {
+            const len_type MR = (!trans ? cfg.gemm_mr.def<T>()
+                                        : cfg.gemm_nr.def<T>());
+            const len_type ME = (!trans ? cfg.gemm_mr.extent<T>()
+                                        : cfg.gemm_nr.extent<T>());
+            const len_type KR = cfg.gemm_kr.def<T>();
+
+            const len_type m_a = cur_len_[ trans];
+            const len_type k_a = cur_len_[!trans];
+
+            TBLIS_ASSERT(diag_dim_ == !trans);
+
+            comm.distribute_over_threads({m_a, MR}, {k_a, KR},
+            [&](len_type m_first, len_type m_last, len_type k_first, len_type k_last)
+            {
+                len_type m = m_last-m_first;
+                len_type k = k_last-k_first;
+
+                /*
+                 * Scatter vectors for the rows and columns of A and for D,
+                 * and then the (conjugated) values of D for these columns
+                 * and a row of ones.
+                 */
+                auto buffer = BuffersForScatter.allocate<stride_type>(m + 2*k + size_as_type<T,stride_type>(k+MR));
+                auto rscat_a = buffer.template get<stride_type>();
+                auto cscat_a = rscat_a + m;
+                auto scat_d = cscat_a + k;
+                auto scale_d = convert_and_align<stride_type,T>(scat_d + k);
+                auto ones = scale_d + k;
+
+                block_scatter_matrix<T>::fill_scatter(lens_[ trans], strides_[ trans], MR,
+                                                      off_[ trans] + m_first, m, rscat_a);
+                block_scatter_matrix<T>::fill_scatter(lens_[!trans], strides_[!trans], KR,
+                                                      off_[!trans] + k_first, k, cscat_a);
+                block_scatter_matrix<T>::fill_scatter(lens_[!trans], diag_strides_, KR,
+                                                      off_[!trans] + k_first, k, scat_d);
+
+                for (len_type p = 0;p < k;p++)
+                    scale_d[p] = conj(diag_conj_, diag_[scat_d[p]]);
+
+                for (len_type i = 0;i < MR;i++)
+                    ones[i] = T(1);
+
+                T* p_ap = Ap.data() + (m_first/MR)*ME*Ap.stride(trans) + k_first*ME;
+
+                for (len_type m_off = 0;m_off < m;m_off += MR)
+                {
+                    len_type m_loc = std::min(MR, m - m_off);
+
+                    TBLIS_ASSERT(p_ap + k*ME <= Ap.data() + ceil_div(Ap.length(trans), MR)*ME*Ap.length(!trans));
+
+                    if (!trans)
+                        cfg.pack_ss_scal_mr_ukr.call<T>(m_loc, k, conj_, data_, rscat_a + m_off, ones,
+                                                        cscat_a, scale_d, p_ap);
+                    else
+                        cfg.pack_ss_scal_nr_ukr.call<T>(m_loc, k, conj_, data_, rscat_a + m_off, ones,
+                                                        cscat_a, scale_d, p_ap);
+
+                    p_ap += ME*Ap.stride(trans);
+                }
+            });
+        }
+};
+
+}
+
+#endif
@@ -0,0 +1,160 @@
+#ifndef _TBLIS_EPILOGUE_MATRIX_HPP_
+#define _TBLIS_EPILOGUE_MATRIX_HPP_
+
+#include "util/basic_types.h"
+
+#include "iface/3t/mult.h"
+
+#include "abstract_matrix.hpp"
+
+namespace tblis
+{
+
+/*
+ * The elementwise update of an epilogue, c <- func((c + gamma*e)/(d0 + d1)),
+ * where c already includes the product and beta. The addition and division
+ * are only done if add and divide are set, respectively.
+ */
+template <typename T>
+struct epilogue_op
+{
+    T gamma = T(1);
+    bool conj_E = false;
+    bool add = false;
+    bool divide = false;
+    tblis_epilogue_func func = nullptr;
+    void* func_data = nullptr;
+
+    T update(T c, const T* e, const T* d0, const T* d1) const
+    {
+        if (add) c += gamma*(conj_E ? conj(*e) : *e);
+        if (divide) c /= *d0 + *d1;
+        return c;
+    }
+
+    /*
+     * Apply func to n contiguous values, in place.
+     */
+    void finish(len_type n, T* values) const
+    {
+        if (func) func(func_data, type_tag<T>::value, n, values);
+    }
+};
+
+/*
+ * The output of a contraction along with the operands of an epilogue: a
+ * tensor E to add and the denominator, given as the sum of two terms D_0 and
+ * D_1 (in practice, one over the M dimensions and one over the N dimensions),
+ * all with the same shape as C. Partitioning (length and shift) applies to
+ * all of them at once. The epilogue is only applied by the update of C which
+ * is marked final, i.e. the one for the last block of k.
+ */
+template <typename Matrix>
+class epilogue_matrix
+{
+    public:
+        typedef typename Matrix::value_type value_type;
+
+        enum {OUTPUT, ADD, DENOM0, DENOM1, NUM_TERMS};
+
+    protected:
+        std::array<Matrix, NUM_TERMS> terms_;
+        const epilogue_op<value_type>* op_ = nullptr;
+        bool final_ = false;
+
+    public:
+        epilogue_matrix() {}
+
+        explicit epilogue_matrix(const epilogue_op<value_type>& op, bool final = false)
+        : op_(&op), final_(final) {}
+
+        const epilogue_op<value_type>& op() const
+        {
+            return *op_;
+        }
+
+        bool has_term(unsigned i) const
+        {
+            return i == OUTPUT || (i == ADD && op_->add) ||
+                   ((i == DENOM0 || i == DENOM1) && op_->divide);
+        }
+
+        /*
+         * Whether a term is needed by the current update: only the output is
+         * unless it is the final one.
+         */
+        bool is_active(unsigned i) const
+        {
+            return has_term(i) && (i == OUTPUT || final_);
+        }
+
+        /*
+         * Terms which the epilogue does not use are ignored.
+         */
+        void term(unsigned i, const Matrix& term)
+        {
+            TBLIS_ASSERT(i < NUM_TERMS);
+            terms_[i] = term;
+        }
+
+        Matrix& term(unsigned i)
+        {
+            TBLIS_ASSERT(has_term(i));
+            return terms_[i];
+        }
+
+        const Matrix& term(unsigned i) const
+        {
+            TBLIS_ASSERT(has_term(i));
+            return terms_[i];
+        }
+
+        bool final() const
+        {
+            return final_;
+        }
+
+        void final(bool final)
+        {
+            final_ = final;
+        }
+
+        len_type length(unsigned dim) const
+        {
+            return terms_[OUTPUT].length(dim);
+        }
+
+        len_type length(unsigned dim, len_type len)
+        {
+            for (unsigned i = 1;i < NUM_TERMS;i++)
+                if (has_term(i)) terms_[i].length(dim, len);
+            return terms_[OUTPUT].length(dim, len);
+        }
+
+        stride_type stride(unsigned dim) const
+        {
+            return terms_[OUTPUT].stride(dim);
+        }
+
+        void shift(unsigned dim, len_type n)
+        {
+            for (unsigned i = 0;i < NUM_TERMS;i++)
+                if (has_term(i)) terms_[i].shift(dim, n);
+        }
+
+        void transpose()
+        {
+            for (unsigned i = 0;i < NUM_TERMS;i++)
+                if (has_term(i)) terms_[i].transpose();
+        }
+};
+
+template <typename Matrix>
+void final_block_k(epilogue_matrix<Matrix>& C, bool final)
+{
+    C.final(final);
+}
+
+}
+
+#endif
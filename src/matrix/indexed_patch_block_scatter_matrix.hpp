@@ -25,6 +25,7 @@ class indexed_patch_block_scatter_matrix : public abstract_matrix<T>
         using abstract_matrix<T>::tot_len_;
         using abstract_matrix<T>::cur_len_;
         using abstract_matrix<T>::off_;
+        using abstract_matrix<T>::conj_;
         matrix_view<block_scatter_matrix<T>> patches_;
         std::array<unsigned, 2> patch_ = {};
         std::array<len_type, 2> patch_off_ = {};
@@ -43,6 +44,7 @@ class indexed_patch_block_scatter_matrix : public abstract_matrix<T>
         : idx_data_{idx_data}
         {
             block_size_ = {MB, NB};
+            conj_ = A.conj();
             std::array<len_type, 2> block_round = {ME, NE};
 
             data_ = A.tensor_.data();
@@ -166,6 +168,7 @@ class indexed_patch_block_scatter_matrix : public abstract_matrix<T>
 
                             auto& this_patch = patches_[patch[0]][patch[1]];
                             this_patch.data_ = A2.data();
+                            this_patch.conj_ = A.conj();
                             this_patch.off_ = {};
                             this_patch.cur_len_ = loc;
                             this_patch.tot_len_ = {round_up(loc[0], block_round[0]),
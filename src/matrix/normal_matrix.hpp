@@ -18,6 +18,7 @@ class normal_matrix : public abstract_matrix<T>
         using abstract_matrix<T>::tot_len_;
         using abstract_matrix<T>::cur_len_;
         using abstract_matrix<T>::off_;
+        using abstract_matrix<T>::conj_;
         T* data_ = nullptr;
         std::array<stride_type,2> stride_ = {};
 
@@ -85,9 +86,9 @@ class normal_matrix : public abstract_matrix<T>
                     TBLIS_ASSERT(p_ap + k*ME <= Ap.data() + Ap.length(0)*Ap.length(1));
 
                     if (!trans)
-                        cfg.pack_nn_mr_ukr.call<T>(m, k, p_a, rs_a, cs_a, p_ap);
+                        cfg.pack_nn_mr_ukr.call<T>(m, k, conj_, p_a, rs_a, cs_a, p_ap);
                     else
-                        cfg.pack_nn_nr_ukr.call<T>(m, k, p_a, rs_a, cs_a, p_ap);
+                        cfg.pack_nn_nr_ukr.call<T>(m, k, conj_, p_a, rs_a, cs_a, p_ap);
 
                     p_a += m*rs_a;
                     p_ap += ME*k_a;
@@ -27,6 +27,7 @@ class patch_block_scatter_matrix : public abstract_matrix<T>
         using abstract_matrix<T>::tot_len_;
         using abstract_matrix<T>::cur_len_;
         using abstract_matrix<T>::off_;
+        using abstract_matrix<T>::conj_;
         matrix_view<block_scatter_matrix<T>> patches_;
         std::array<unsigned, 2> patch_ = {};
         std::array<len_type, 2> patch_off_ = {};
@@ -42,6 +43,7 @@ class patch_block_scatter_matrix : public abstract_matrix<T>
         {
             tot_len_ = cur_len_ = {A.cur_len_[0], A.cur_len_[1]};
             block_size_ = {MB, NB};
+            conj_ = A.conj();
 
             patches_.reset({1, 1}, patches);
 
@@ -60,6 +62,7 @@ class patch_block_scatter_matrix : public abstract_matrix<T>
         {
             tot_len_ = cur_len_ = {A.cur_len_[0], A.cur_len_[1]};
             block_size_ = {MB, NB};
+            conj_ = A.conj();
 
             patches_.reset({1, 1}, patches);
 
@@ -77,6 +80,7 @@ class patch_block_scatter_matrix : public abstract_matrix<T>
                                    patch_type patches)
         {
             block_size_ = {MB, NB};
+            conj_ = A.conj();
             std::array<len_type, 2> block_round = {ME, NE};
 
             unsigned nirrep = A.tensor_.num_irreps();
@@ -190,6 +194,7 @@ class patch_block_scatter_matrix : public abstract_matrix<T>
 
                             auto& this_patch = patches_[patch[0]][patch[1]];
                             this_patch.data_ = A2.data();
+                            this_patch.conj_ = A.conj();
                             this_patch.off_ = {};
                             this_patch.cur_len_ = loc;
                             this_patch.tot_len_ = {round_up(loc[0], block_round[0]),
@@ -294,14 +299,15 @@ class patch_block_scatter_matrix : public abstract_matrix<T>
             patch_off_[dim] = n;
         }
 
+        template <typename U>
         void pack(const communicator& comm, const config& cfg,
-                  bool trans, normal_matrix<T>& Ap) const
+                  bool trans, normal_matrix<U>& Ap) const
         {
-            const len_type MR = (!trans ? cfg.gemm_mr.def<T>()
-                                        : cfg.gemm_nr.def<T>());
-            const len_type ME = (!trans ? cfg.gemm_mr.extent<T>()
-                                        : cfg.gemm_nr.extent<T>());
-            const len_type KR = cfg.gemm_kr.def<T>();
+            const len_type MR = (!trans ? cfg.gemm_mr.def<U>()
+                                        : cfg.gemm_nr.def<U>());
+            const len_type ME = (!trans ? cfg.gemm_mr.extent<U>()
+                                        : cfg.gemm_nr.extent<U>());
+            const len_type KR = cfg.gemm_kr.def<U>();
 
             TBLIS_ASSERT(block_size_[ trans] == MR);
             TBLIS_ASSERT(block_size_[!trans] == KR);
@@ -335,7 +341,7 @@ class patch_block_scatter_matrix : public abstract_matrix<T>
             unsigned k_patch_old = k_patch;
             len_type k_off_patch_old = k_off_patch;
 
-            normal_matrix<T> Ap_sub = Ap;
+            normal_matrix<U> Ap_sub = Ap;
 
             len_type m_off = 0;
             for (;m_off < m_a;)
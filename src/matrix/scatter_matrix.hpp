@@ -22,6 +22,7 @@ class scatter_matrix : public abstract_matrix<T>
         using abstract_matrix<T>::tot_len_;
         using abstract_matrix<T>::cur_len_;
         using abstract_matrix<T>::off_;
+        using abstract_matrix<T>::conj_;
         T* data_ = nullptr;
         std::array<stride_type*, 2> scatter_ = {};
 
@@ -72,9 +73,9 @@ class scatter_matrix : public abstract_matrix<T>
                     TBLIS_ASSERT(p_ap + k*ME <= Ap.data() + ceil_div(Ap.length(trans), MR)*ME*Ap.length(!trans));
 
                     if (!trans)
-                        cfg.pack_ss_mr_ukr.call<T>(m, k, p_a, rscat_a, cscat_a, p_ap);
+                        cfg.pack_ss_mr_ukr.call<T>(m, k, conj_, p_a, rscat_a, cscat_a, p_ap);
                     else
-                        cfg.pack_ss_nr_ukr.call<T>(m, k, p_a, rscat_a, cscat_a, p_ap);
+                        cfg.pack_ss_nr_ukr.call<T>(m, k, conj_, p_a, rscat_a, cscat_a, p_ap);
 
                     p_ap += ME*Ap.stride(trans);
                     m_off += MR;
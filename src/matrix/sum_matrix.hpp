@@ -0,0 +1,99 @@
+#ifndef _TBLIS_SUM_MATRIX_HPP_
+#define _TBLIS_SUM_MATRIX_HPP_
+
+#include "util/basic_types.h"
+
+#include "abstract_matrix.hpp"
+
+namespace tblis
+{
+
+/*
+ * A linear combination of equally-sized submatrices, c_0*M_0 + c_1*M_1 + ...
+ * Partitioning (length and shift) applies to all terms at once. Used as an
+ * input to Strassen-like algorithms, where the terms are packed together, and
+ * as an output, where each term is updated with the same product.
+ */
+template <typename Matrix>
+class sum_matrix
+{
+    public:
+        typedef typename Matrix::value_type value_type;
+
+        constexpr static unsigned MAX_TERMS = 4;
+
+    protected:
+        std::array<Matrix, MAX_TERMS> terms_;
+        std::array<value_type, MAX_TERMS> coefs_ = {};
+        unsigned num_terms_ = 0;
+
+    public:
+        sum_matrix() {}
+
+        void push_back(const Matrix& term, value_type coef)
+        {
+            TBLIS_ASSERT(num_terms_ < MAX_TERMS);
+            TBLIS_ASSERT(num_terms_ == 0 ||
+                         (term.length(0) == length(0) &&
+                          term.length(1) == length(1)));
+            terms_[num_terms_] = term;
+            coefs_[num_terms_] = coef;
+            num_terms_++;
+        }
+
+        unsigned num_terms() const
+        {
+            return num_terms_;
+        }
+
+        Matrix& term(unsigned i)
+        {
+            TBLIS_ASSERT(i < num_terms_);
+            return terms_[i];
+        }
+
+        const Matrix& term(unsigned i) const
+        {
+            TBLIS_ASSERT(i < num_terms_);
+            return terms_[i];
+        }
+
+        value_type coef(unsigned i) const
+        {
+            TBLIS_ASSERT(i < num_terms_);
+            return coefs_[i];
+        }
+
+        len_type length(unsigned dim) const
+        {
+            TBLIS_ASSERT(num_terms_ > 0);
+            return terms_[0].length(dim);
+        }
+
+        len_type length(unsigned dim, len_type len)
+        {
+            TBLIS_ASSERT(num_terms_ > 0);
+            for (unsigned i = 1;i < num_terms_;i++) terms_[i].length(dim, len);
+            return terms_[0].length(dim, len);
+        }
+
+        stride_type stride(unsigned dim) const
+        {
+            TBLIS_ASSERT(num_terms_ > 0);
+            return terms_[0].stride(dim);
+        }
+
+        void shift(unsigned dim, len_type n)
+        {
+            for (unsigned i = 0;i < num_terms_;i++) terms_[i].shift(dim, n);
+        }
+
+        void transpose()
+        {
+            for (unsigned i = 0;i < num_terms_;i++) terms_[i].transpose();
+        }
+};
+
+}
+
+#endif
@@ -29,7 +29,7 @@ class tensor_matrix : public abstract_matrix<T>
         std::array<bool, 2> pack_3d_ = {};
 
     public:
-        tensor_matrix();
+        tensor_matrix() {}
 
         template <typename U, typename V>
         tensor_matrix(varray_view<const T> other,
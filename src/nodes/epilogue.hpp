@@ -0,0 +1,234 @@
+#ifndef _TBLIS_NODES_EPILOGUE_HPP_
+#define _TBLIS_NODES_EPILOGUE_HPP_
+
+#include "gemm.hpp"
+
+#include "matrix/epilogue_matrix.hpp"
+
+namespace tblis
+{
+
+/*
+ * TensorGEMM with an elementwise epilogue applied as each microtile of C is
+ * written for the last time, so that C is only read and written once after
+ * the product is complete (see epilogue_matrix).
+ */
+
+namespace detail
+{
+
+/*
+ * Element (i,j) of a microtile of a block scatter matrix, where a stride of
+ * zero means that the scatter vector must be used instead.
+ */
+template <typename T>
+struct epilogue_utile
+{
+    T* data;
+    const stride_type* rscat;
+    const stride_type* cscat;
+    stride_type rs, cs;
+    len_type m, n;
+
+    epilogue_utile(const block_scatter_matrix<T>& C)
+    {
+        C.block(data, rscat, rs, m, cscat, cs, n);
+    }
+
+    T& operator()(len_type i, len_type j) const
+    {
+        return data[(rs ? i*rs : rscat[i]) + (cs ? j*cs : cscat[j])];
+    }
+};
+
+}
+
+/*
+ * Build block scatter vectors for each term of C which is needed by the
+ * current block (all of them only for the last block of k).
+ */
+template <MemoryPool& Pool, typename Child>
+struct epilogue_matrify_c
+{
+    Child child;
+    MemoryPool::Block scat_buffer;
+    stride_type* scat = nullptr;
+    len_type scat_size = 0;
+
+    epilogue_matrify_c() {}
+
+    epilogue_matrify_c(const epilogue_matrify_c& other)
+    : child(other.child) {}
+
+    template <typename T, typename MatrixA, typename MatrixB>
+    void operator()(const communicator& comm, const config& cfg,
+                    T alpha, MatrixA& A, MatrixB& B, T beta,
+                    epilogue_matrix<tensor_matrix<T>>& C)
+    {
+        typedef epilogue_matrix<tensor_matrix<T>> matrix_type;
+
+        const len_type MB = cfg.gemm_mr.def<T>();
+        const len_type NB = cfg.gemm_nr.def<T>();
+
+        len_type m_s = C.length(0) + MB-1;
+        len_type n_s = C.length(1) + NB-1;
+
+        len_type size = 2*(m_s+n_s)*matrix_type::NUM_TERMS;
+
+        if (size > scat_size)
+        {
+            if (comm.master())
+            {
+                scat_buffer = Pool.allocate<stride_type>(size);
+                scat = scat_buffer.template get<stride_type>();
+            }
+
+            comm.broadcast_value(scat);
+            scat_size = size;
+        }
+
+        epilogue_matrix<block_scatter_matrix<T>> M(C.op(), C.final());
+
+        for (unsigned t = 0;t < matrix_type::NUM_TERMS;t++)
+        {
+            if (!C.is_active(t)) continue;
+
+            stride_type* rscat = scat + 2*(m_s+n_s)*t;
+            stride_type* rbs = rscat + m_s;
+            stride_type* cscat = rbs + m_s;
+            stride_type* cbs = cscat + n_s;
+
+            M.term(t, block_scatter_matrix<T>(comm, C.term(t),
+                                              MB, rscat, rbs,
+                                              NB, cscat, cbs));
+        }
+
+        child(comm, cfg, alpha, A, B, beta, M);
+    }
+};
+
+/*
+ * Compute one microtile of A*B and, if this is the last update of C, finish
+ * it off with the epilogue before writing it.
+ */
+struct epilogue_micro_kernel
+{
+    template <typename T>
+    void operator()(const communicator& comm, const config& cfg,
+                    T alpha, normal_matrix<T>& A,
+                             normal_matrix<T>& B,
+                    T  beta, epilogue_matrix<block_scatter_matrix<T>>& C) const
+    {
+        typedef epilogue_matrix<block_scatter_matrix<T>> matrix_type;
+
+        if (!C.final())
+        {
+            gemm_micro_kernel()(comm, cfg, alpha, A, B, beta, C.term(matrix_type::OUTPUT));
+            return;
+        }
+
+        const len_type MR = cfg.gemm_mr.def<T>();
+        const len_type NR = cfg.gemm_nr.def<T>();
+        const bool row_major = cfg.gemm_row_major.value<T>();
+        const bool flip_ukr = cfg.gemm_flip_ukr.value<T>();
+        const len_type rs_ab = (row_major ? NR : 1);
+        const len_type cs_ab = (row_major ? 1 : MR);
+
+        const auto& op = C.op();
+        const T* p_a = A.data();
+        const T* p_b = B.data();
+        len_type k = A.length(1);
+
+        detail::epilogue_utile<T> c(C.term(matrix_type::OUTPUT));
+        auto c_prefetch = &c(0, 0);
+        len_type m = c.m;
+        len_type n = c.n;
+
+        if (auto stats = thread_stats(KERNEL_GEMM))
+        {
+            stats_add(stats->flops, 2*m*n*k);
+            if (!c.rs || !c.cs) stats_add(stats->bytes_scattered, m*n*sizeof(T));
+        }
+
+        T p_ab[512] __attribute__((aligned(64)));
+        static const T zero = T(0);
+
+        if (flip_ukr)
+        {
+            auxinfo_t aux{p_b, p_a, c_prefetch};
+            cfg.gemm_ukr.call<T>(k, &alpha, p_b, p_a,
+                                 &zero, &p_ab[0], cs_ab, rs_ab, &aux);
+        }
+        else
+        {
+            auxinfo_t aux{p_a, p_b, c_prefetch};
+            cfg.gemm_ukr.call<T>(k, &alpha, p_a, p_b,
+                                 &zero, &p_ab[0], rs_ab, cs_ab, &aux);
+        }
+
+        if (beta != T(0))
+        {
+            for (len_type j = 0;j < n;j++)
+                for (len_type i = 0;i < m;i++)
+                    p_ab[i*rs_ab + j*cs_ab] += beta*c(i, j);
+        }
+
+        if (op.add)
+        {
+            detail::epilogue_utile<T> e(C.term(matrix_type::ADD));
+
+            for (len_type j = 0;j < n;j++)
+                for (len_type i = 0;i < m;i++)
+                    p_ab[i*rs_ab + j*cs_ab] += op.gamma*(op.conj_E ? conj(e(i, j)) : e(i, j));
+        }
+
+        if (op.divide)
+        {
+            detail::epilogue_utile<T> d0(C.term(matrix_type::DENOM0));
+            detail::epilogue_utile<T> d1(C.term(matrix_type::DENOM1));
+
+            for (len_type j = 0;j < n;j++)
+                for (len_type i = 0;i < m;i++)
+                    p_ab[i*rs_ab + j*cs_ab] /= d0(i, j) + d1(i, j);
+        }
+
+        if (op.func)
+        {
+            /*
+             * Hand the function a contiguous tile.
+             */
+            T tile[512] __attribute__((aligned(64)));
+
+            for (len_type j = 0;j < n;j++)
+                for (len_type i = 0;i < m;i++)
+                    tile[i + j*m] = p_ab[i*rs_ab + j*cs_ab];
+
+            op.finish(m*n, tile);
+
+            for (len_type j = 0;j < n;j++)
+                for (len_type i = 0;i < m;i++)
+                    c(i, j) = tile[i + j*m];
+        }
+        else
+        {
+            for (len_type j = 0;j < n;j++)
+                for (len_type i = 0;i < m;i++)
+                    c(i, j) = p_ab[i*rs_ab + j*cs_ab];
+        }
+    }
+};
+
+using EpilogueGEMM = gemm<
+                       partition_gemm_nc<
+                         partition_gemm_kc<
+                           matrify_and_pack_b<BuffersForB,
+                             partition_gemm_mc<
+                               matrify_and_pack_a<BuffersForA,
+                                 epilogue_matrify_c<BuffersForScatter,
+                                   partition_gemm_nr<
+                                     partition_gemm_mr<
+                                       epilogue_micro_kernel>>>>>>>>>;
+
+}
+
+#endif
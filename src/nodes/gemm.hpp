@@ -7,6 +7,8 @@
 #include "gemm_mkr.hpp"
 #include "gemm_ukr.hpp"
 
+#include "util/topology.hpp"
+
 namespace tblis
 {
 
@@ -96,6 +98,7 @@ template <typename Child>
 struct gemm
 {
     Child child;
+    const gemm_thread_config* thread_config = nullptr;
 
     template <typename T, typename MatrixA, typename MatrixB, typename MatrixC>
     void operator()(const communicator& comm, const config& cfg,
@@ -118,12 +121,18 @@ struct gemm
             std::swap(m, n);
         }
 
-        if (comm.master()) flops += 2*m*n*k;
-
         int nt = comm.num_threads();
-        auto tc = make_gemm_thread_config<T>(cfg, nt, m, n, k);
+        auto tc = thread_config ? *thread_config :
+                  make_gemm_thread_config<T>(cfg, nt, m, n, k);
+        TBLIS_ASSERT(tc.jc_nt*tc.ic_nt*tc.jr_nt*tc.ir_nt == nt);
+
+        /*
+         * Each jc gang packs its own panels of B, so keep the threads of a
+         * gang within one NUMA domain where possible.
+         */
+        unsigned rank = tc.jc_nt > 1 ? numa_thread_rank(comm) : comm.thread_num();
 
-        communicator comm_nc =    comm.gang(TCI_EVENLY, tc.jc_nt);
+        communicator comm_nc =    comm.gang(TCI_EVENLY, tc.jc_nt, 0, rank);
         communicator comm_kc = comm_nc.gang(TCI_EVENLY,        1);
         communicator comm_mc = comm_kc.gang(TCI_EVENLY, tc.ic_nt);
         communicator comm_nr = comm_mc.gang(TCI_EVENLY, tc.jr_nt);
@@ -3,6 +3,7 @@
 
 #include "util/basic_types.h"
 #include "util/thread.h"
+#include "util/stats.h"
 
 #include "configs/configs.hpp"
 
@@ -53,6 +54,8 @@ struct gemm_macro_kernel
                 {
                     len_type m_loc = std::min(MR, m-m_off*MR);
 
+                    count_flops(KERNEL_GEMM, 2*m_loc*n_loc*k);
+
                     const T* p_a = A.data() + m_off*ME*k;
                     const T* p_b = B.data() + n_off*NE*k;
                           T* p_c = C.data() + m_off*MR*rs_c + n_off*NR*cs_c;
@@ -3,6 +3,7 @@
 
 #include "util/basic_types.h"
 #include "util/thread.h"
+#include "util/stats.h"
 
 #include "matrix/normal_matrix.hpp"
 #include "matrix/block_scatter_matrix.hpp"
@@ -13,10 +14,10 @@
 namespace tblis
 {
 
-template <typename T>
+template <typename T, typename U>
 void accum_utile(len_type m, len_type n,
                  const T* TBLIS_RESTRICT p_ab, stride_type rs_ab, stride_type cs_ab,
-                 T beta, T* TBLIS_RESTRICT p_c, stride_type rs_c, stride_type cs_c)
+                 T beta, U* TBLIS_RESTRICT p_c, stride_type rs_c, stride_type cs_c)
 {
     if (beta == T(0))
     {
@@ -24,7 +25,7 @@ void accum_utile(len_type m, len_type n,
         {
             for (len_type i = 0;i < m;i++)
             {
-                p_c[i*rs_c + j*cs_c] = p_ab[i*rs_ab + j*cs_ab];
+                p_c[i*rs_c + j*cs_c] = U(p_ab[i*rs_ab + j*cs_ab]);
             }
         }
     }
@@ -34,16 +35,16 @@ void accum_utile(len_type m, len_type n,
         {
             for (len_type i = 0;i < m;i++)
             {
-                p_c[i*rs_c + j*cs_c] = p_ab[i*rs_ab + j*cs_ab] + beta*p_c[i*rs_c + j*cs_c];
+                p_c[i*rs_c + j*cs_c] = U(p_ab[i*rs_ab + j*cs_ab] + beta*T(p_c[i*rs_c + j*cs_c]));
             }
         }
     }
 }
 
-template <typename T>
+template <typename T, typename U>
 void accum_utile(len_type m, len_type n,
                  const T* TBLIS_RESTRICT p_ab, stride_type rs_ab, stride_type cs_ab,
-                 T beta, T* TBLIS_RESTRICT p_c,
+                 T beta, U* TBLIS_RESTRICT p_c,
                  const stride_type* TBLIS_RESTRICT rs_c, stride_type cs_c)
 {
     if (beta == T(0))
@@ -52,7 +53,7 @@ void accum_utile(len_type m, len_type n,
         {
             for (len_type i = 0;i < m;i++)
             {
-                p_c[rs_c[i] + j*cs_c] = p_ab[i*rs_ab + j*cs_ab];
+                p_c[rs_c[i] + j*cs_c] = U(p_ab[i*rs_ab + j*cs_ab]);
             }
         }
     }
@@ -62,16 +63,16 @@ void accum_utile(len_type m, len_type n,
         {
             for (len_type i = 0;i < m;i++)
             {
-                p_c[rs_c[i] + j*cs_c] = p_ab[i*rs_ab + j*cs_ab] + beta*p_c[rs_c[i] + j*cs_c];
+                p_c[rs_c[i] + j*cs_c] = U(p_ab[i*rs_ab + j*cs_ab] + beta*T(p_c[rs_c[i] + j*cs_c]));
             }
         }
     }
 }
 
-template <typename T>
+template <typename T, typename U>
 void accum_utile(len_type m, len_type n,
                  const T* TBLIS_RESTRICT p_ab, stride_type rs_ab, stride_type cs_ab,
-                 T beta, T* TBLIS_RESTRICT p_c,
+                 T beta, U* TBLIS_RESTRICT p_c,
                  stride_type rs_c, const stride_type* TBLIS_RESTRICT cs_c)
 {
     if (beta == T(0))
@@ -80,7 +81,7 @@ void accum_utile(len_type m, len_type n,
         {
             for (len_type i = 0;i < m;i++)
             {
-                p_c[i*rs_c + cs_c[j]] = p_ab[i*rs_ab + j*cs_ab];
+                p_c[i*rs_c + cs_c[j]] = U(p_ab[i*rs_ab + j*cs_ab]);
             }
         }
     }
@@ -90,16 +91,16 @@ void accum_utile(len_type m, len_type n,
         {
             for (len_type i = 0;i < m;i++)
             {
-                p_c[i*rs_c + cs_c[j]] = p_ab[i*rs_ab + j*cs_ab] + beta*p_c[i*rs_c + cs_c[j]];
+                p_c[i*rs_c + cs_c[j]] = U(p_ab[i*rs_ab + j*cs_ab] + beta*T(p_c[i*rs_c + cs_c[j]]));
             }
         }
     }
 }
 
-template <typename T>
+template <typename T, typename U>
 void accum_utile(len_type m, len_type n,
                  const T* TBLIS_RESTRICT p_ab, stride_type rs_ab, stride_type cs_ab,
-                 T beta, T* TBLIS_RESTRICT p_c,
+                 T beta, U* TBLIS_RESTRICT p_c,
                  const stride_type* TBLIS_RESTRICT rs_c,
                  const stride_type* TBLIS_RESTRICT cs_c)
 {
@@ -109,7 +110,7 @@ void accum_utile(len_type m, len_type n,
         {
             for (len_type i = 0;i < m;i++)
             {
-                p_c[rs_c[i] + cs_c[j]] = p_ab[i*rs_ab + j*cs_ab];
+                p_c[rs_c[i] + cs_c[j]] = U(p_ab[i*rs_ab + j*cs_ab]);
             }
         }
     }
@@ -119,7 +120,7 @@ void accum_utile(len_type m, len_type n,
         {
             for (len_type i = 0;i < m;i++)
             {
-                p_c[rs_c[i] + cs_c[j]] = p_ab[i*rs_ab + j*cs_ab] + beta*p_c[rs_c[i] + cs_c[j]];
+                p_c[rs_c[i] + cs_c[j]] = U(p_ab[i*rs_ab + j*cs_ab] + beta*T(p_c[rs_c[i] + cs_c[j]]));
             }
         }
     }
@@ -127,6 +128,36 @@ void accum_utile(len_type m, len_type n,
 
 struct gemm_micro_kernel
 {
+    template <typename T>
+    static void full_utile(const config& cfg, len_type k, T alpha,
+                           const T* p_a, const T* p_b, void* c_prefetch,
+                           T beta, T* p_c, stride_type rs_c, stride_type cs_c)
+    {
+        if (cfg.gemm_flip_ukr.value<T>())
+        {
+            auxinfo_t aux{p_b, p_a, c_prefetch};
+            cfg.gemm_ukr.call<T>(k, &alpha, p_b, p_a,
+                                 &beta, p_c, cs_c, rs_c, &aux);
+        }
+        else
+        {
+            auxinfo_t aux{p_a, p_b, c_prefetch};
+            cfg.gemm_ukr.call<T>(k, &alpha, p_a, p_b,
+                                 &beta, p_c, rs_c, cs_c, &aux);
+        }
+    }
+
+    template <typename T>
+    static void full_utile(const config& cfg, len_type k, T alpha,
+                           const T* p_a, const T* p_b, void* c_prefetch,
+                           T beta, other_precision_t<T>* p_c,
+                           stride_type rs_c, stride_type cs_c)
+    {
+        auxinfo_t aux{p_a, p_b, c_prefetch};
+        cfg.gemm_mixed_ukr.call<T>(k, &alpha, p_a, p_b,
+                                   &beta, p_c, rs_c, cs_c, &aux);
+    }
+
     template <typename T>
     void operator()(const communicator& comm, const config& cfg,
                     T alpha, normal_matrix<T>& A,
@@ -152,6 +183,8 @@ struct gemm_micro_kernel
         stride_type rs_c = C.stride(0);
         stride_type cs_c = C.stride(1);
 
+        count_flops(KERNEL_GEMM, 2*m*n*k);
+
         if (m == MR && n == NR)
         {
             if (flip_ukr)
@@ -190,11 +223,11 @@ struct gemm_micro_kernel
         }
     }
 
-    template <typename T>
+    template <typename T, typename U>
     void operator()(const communicator& comm, const config& cfg,
                     T alpha,        normal_matrix<T>& A,
                                     normal_matrix<T>& B,
-                    T  beta, block_scatter_matrix<T>& C) const
+                    T  beta, block_scatter_matrix<U>& C) const
     {
         (void)comm;
 
@@ -207,7 +240,7 @@ struct gemm_micro_kernel
 
         const T* p_a = A.data();
         const T* p_b = B.data();
-              T* p_c;
+              U* p_c;
 
         TBLIS_ASSERT(C.block_size(0) == MR);
         TBLIS_ASSERT(C.block_size(1) == NR);
@@ -220,20 +253,16 @@ struct gemm_micro_kernel
         C.block(p_c, rscat_c, rs_c, m, cscat_c, cs_c, n);
         auto c_prefetch = p_c + (rs_c ? 0 : *rscat_c) + (cs_c ? 0 : *cscat_c);
 
+        if (auto stats = thread_stats(KERNEL_GEMM))
+        {
+            stats_add(stats->flops, 2*m*n*k);
+            if (!rs_c || !cs_c) stats_add(stats->bytes_scattered, m*n*sizeof(U));
+        }
+
         if (m == MR && n == NR && rs_c && cs_c)
         {
-            if (flip_ukr)
-            {
-                auxinfo_t aux{p_b, p_a, c_prefetch};
-                cfg.gemm_ukr.call<T>(k, &alpha, p_b, p_a,
-                                     &beta, p_c, cs_c, rs_c, &aux);
-            }
-            else
-            {
-                auxinfo_t aux{p_a, p_b, c_prefetch};
-                cfg.gemm_ukr.call<T>(k, &alpha, p_a, p_b,
-                                     &beta, p_c, rs_c, cs_c, &aux);
-            }
+            full_utile(cfg, k, alpha, p_a, p_b, c_prefetch,
+                       beta, p_c, rs_c, cs_c);
         }
         else
         {
@@ -276,11 +305,11 @@ struct gemm_micro_kernel
         }
     }
 
-    template <typename T>
+    template <typename T, typename U>
     void operator()(const communicator& comm, const config& cfg,
                     T alpha,              normal_matrix<T>& A,
                                           normal_matrix<T>& B,
-                    T  beta, patch_block_scatter_matrix<T>& C) const
+                    T  beta, patch_block_scatter_matrix<U>& C) const
     {
         (void)comm;
 
@@ -293,7 +322,7 @@ struct gemm_micro_kernel
 
         const T* p_a = A.data();
         const T* p_b = B.data();
-              T* p_c;
+              U* p_c;
 
         TBLIS_ASSERT(C.block_size(0) == MR);
         TBLIS_ASSERT(C.block_size(1) == NR);
@@ -306,20 +335,16 @@ struct gemm_micro_kernel
         C.block(p_c, rscat_c, rs_c, m, cscat_c, cs_c, n);
         auto c_prefetch = p_c + (rs_c ? 0 : *rscat_c) + (cs_c ? 0 : *cscat_c);
 
+        if (auto stats = thread_stats(KERNEL_GEMM))
+        {
+            stats_add(stats->flops, 2*m*n*k);
+            if (!rs_c || !cs_c) stats_add(stats->bytes_scattered, m*n*sizeof(U));
+        }
+
         if (m == MR && n == NR && rs_c && cs_c)
         {
-            if (flip_ukr)
-            {
-                auxinfo_t aux{p_b, p_a, c_prefetch};
-                cfg.gemm_ukr.call<T>(k, &alpha, p_b, p_a,
-                                     &beta, p_c, cs_c, rs_c, &aux);
-            }
-            else
-            {
-                auxinfo_t aux{p_a, p_b, c_prefetch};
-                cfg.gemm_ukr.call<T>(k, &alpha, p_a, p_b,
-                                     &beta, p_c, rs_c, cs_c, &aux);
-            }
+            full_utile(cfg, k, alpha, p_a, p_b, c_prefetch,
+                       beta, p_c, rs_c, cs_c);
         }
         else
         {
@@ -24,8 +24,8 @@ extern MemoryPool BuffersForScatter;
 template <typename Step>
 struct is_pack : std::false_type {};
 
-template <int Mat, blocksize config::*BS, MemoryPool& Pool, typename Child>
-struct is_pack<pack<Mat, BS, Pool, Child>> : std::true_type {};
+template <int Mat, blocksize config::*BS, MemoryPool& Pool, typename Child, bool Pipelined>
+struct is_pack<pack<Mat, BS, Pool, Child, Pipelined>> : std::true_type {};
 
 template <typename Matrix, typename=void>
 struct needs_matrify : std::false_type {};
@@ -40,7 +40,7 @@ template <int Mat> struct matrify_and_run;
 template <int Mat, blocksize config::*MBS, blocksize config::*NBS, MemoryPool& Pool, typename Child>
 struct matrify;
 
-template <typename Matrify, typename Child, typename MatrixA>
+template <typename T, typename Matrify, typename Child, typename MatrixA>
 detail::enable_if_t<!detail::is_pack<Child>::value &&
                     !detail::needs_matrify<MatrixA>::value>
 allocate_buffers(len_type MB, len_type NB, Matrify& parent, Child&,
@@ -48,7 +48,7 @@ allocate_buffers(len_type MB, len_type NB, Matrify& parent, Child&,
 {
 }
 
-template <typename Matrify, typename Child, typename MatrixA>
+template <typename T, typename Matrify, typename Child, typename MatrixA>
 detail::enable_if_t<!detail::is_pack<Child>::value &&
                     detail::needs_matrify<MatrixA>::value>
 allocate_buffers(len_type MB, len_type NB, Matrify& parent, Child&,
@@ -77,22 +77,22 @@ allocate_buffers(len_type MB, len_type NB, Matrify& parent, Child&,
     }
 }
 
-template <typename Matrify, typename Child, typename MatrixA>
+template <typename T, typename Matrify, typename Child, typename MatrixA>
 detail::enable_if_t<detail::is_pack<Child>::value &&
                     !detail::needs_matrify<MatrixA>::value>
 allocate_buffers(len_type MB, len_type NB, Matrify& parent, Child& child,
                  const communicator& comm, MatrixA& A)
 {
-    typedef typename MatrixA::value_type T;
-
     if (!child.pack_ptr)
     {
         len_type m = A.length(0) + (MB-1);
         len_type n = A.length(1) + (NB-1);
 
+        child.pack_size = pack_buffer_size<T>(m, n);
+
         if (comm.master())
         {
-            child.pack_buffer = parent.pool().template allocate<T>(m*n + std::max(m,n)*TBLIS_MAX_UNROLL);
+            child.pack_buffer = parent.pool().template allocate<T>(Child::num_buffers*child.pack_size);
             child.pack_ptr = child.pack_buffer.get();
         }
 
@@ -100,14 +100,12 @@ allocate_buffers(len_type MB, len_type NB, Matrify& parent, Child& child,
     }
 }
 
-template <typename Matrify, typename Child, typename MatrixA>
+template <typename T, typename Matrify, typename Child, typename MatrixA>
 detail::enable_if_t<detail::is_pack<Child>::value &&
                     detail::needs_matrify<MatrixA>::value>
 allocate_buffers(len_type MB, len_type NB, Matrify& parent, Child& child,
                  const communicator& comm, MatrixA& A)
 {
-    typedef typename MatrixA::value_type T;
-
     if (!parent.rscat)
     {
         unsigned mp = A.num_patches(0);
@@ -115,17 +113,20 @@ allocate_buffers(len_type MB, len_type NB, Matrify& parent, Child& child,
         len_type m = A.length(0) + (MB-1)*mp;
         len_type n = A.length(1) + (NB-1)*np;
 
+        child.pack_size = pack_buffer_size<T>(m, n);
+        len_type packed_size = Child::num_buffers*child.pack_size;
+
         if (comm.master())
         {
             len_type scatter_size = size_as_type<stride_type,T>(2*m*np + 2*n*mp) +
                                     size_as_type<block_scatter_matrix<float>,T>(mp*np);
-            child.pack_buffer = parent.pool().template allocate<T>(m*n + std::max(m,n)*TBLIS_MAX_UNROLL + scatter_size);
+            child.pack_buffer = parent.pool().template allocate<T>(packed_size + scatter_size);
             child.pack_ptr = child.pack_buffer.get();
         }
 
         comm.broadcast_value(child.pack_ptr);
 
-        parent.rscat = convert_and_align<T,stride_type>(static_cast<T*>(child.pack_ptr) + m*n);
+        parent.rscat = convert_and_align<T,stride_type>(static_cast<T*>(child.pack_ptr) + packed_size);
         parent.cscat = parent.rscat+m*np;
         parent.rbs = parent.cscat+n*mp;
         parent.cbs = parent.rbs+m*np;
@@ -140,7 +141,7 @@ template <> struct matrify_and_run<matrix_constants::MAT_A>
                     T alpha, MatrixA& A, MatrixB& B, T beta, MatrixC& C,
                     std::enable_if_t<!detail::needs_matrify<MatrixA>::value>* = 0)
     {
-        allocate_buffers(MB, NB, parent, parent.child, comm, A);
+        allocate_buffers<T>(MB, NB, parent, parent.child, comm, A);
         parent.child(comm, cfg, alpha, A, B, beta, C);
     }
 
@@ -149,11 +150,12 @@ template <> struct matrify_and_run<matrix_constants::MAT_A>
                     T alpha, MatrixA& A, MatrixB& B, T beta, MatrixC& C,
                     std::enable_if_t<detail::needs_matrify<MatrixA>::value>* = 0)
     {
-        allocate_buffers(MB, NB, parent, parent.child, comm, A);
-        patch_block_scatter_matrix<T> M(comm, A,
+        allocate_buffers<T>(MB, NB, parent, parent.child, comm, A);
+        typedef typename MatrixA::value_type U;
+        patch_block_scatter_matrix<U> M(comm, A,
                                         MB, MB, parent.rscat, parent.rbs,
                                         NB,  1, parent.cscat, parent.cbs,
-                                        static_cast<block_scatter_matrix<T>*>(parent.patches));
+                                        static_cast<block_scatter_matrix<U>*>(parent.patches));
         parent.child(comm, cfg, alpha, M, B, beta, C);
     }
 };
@@ -165,7 +167,7 @@ template <> struct matrify_and_run<matrix_constants::MAT_B>
                     T alpha, MatrixA& A, MatrixB& B, T beta, MatrixC& C,
                     std::enable_if_t<!detail::needs_matrify<MatrixB>::value>* = 0)
     {
-        allocate_buffers(MB, NB, parent, parent.child, comm, B);
+        allocate_buffers<T>(MB, NB, parent, parent.child, comm, B);
         parent.child(comm, cfg, alpha, A, B, beta, C);
     }
 
@@ -174,11 +176,12 @@ template <> struct matrify_and_run<matrix_constants::MAT_B>
                     T alpha, MatrixA& A, MatrixB& B, T beta, MatrixC& C,
                     std::enable_if_t<detail::needs_matrify<MatrixB>::value>* = 0)
     {
-        allocate_buffers(MB, NB, parent, parent.child, comm, B);
-        patch_block_scatter_matrix<T> M(comm, B,
+        allocate_buffers<T>(MB, NB, parent, parent.child, comm, B);
+        typedef typename MatrixB::value_type U;
+        patch_block_scatter_matrix<U> M(comm, B,
                                         MB,  1, parent.rscat, parent.rbs,
                                         NB, NB, parent.cscat, parent.cbs,
-                                        static_cast<block_scatter_matrix<T>*>(parent.patches));
+                                        static_cast<block_scatter_matrix<U>*>(parent.patches));
         parent.child(comm, cfg, alpha, A, M, beta, C);
     }
 };
@@ -190,7 +193,7 @@ template <> struct matrify_and_run<matrix_constants::MAT_C>
                     T alpha, MatrixA& A, MatrixB& B, T beta, MatrixC& C,
                     std::enable_if_t<!detail::needs_matrify<MatrixC>::value>* = 0)
     {
-        allocate_buffers(MB, NB, parent, parent.child, comm, C);
+        allocate_buffers<T>(MB, NB, parent, parent.child, comm, C);
         parent.child(comm, cfg, alpha, A, B, beta, C);
     }
 
@@ -199,11 +202,12 @@ template <> struct matrify_and_run<matrix_constants::MAT_C>
                     T alpha, MatrixA& A, MatrixB& B, T beta, MatrixC& C,
                     std::enable_if_t<detail::needs_matrify<MatrixC>::value>* = 0)
     {
-        allocate_buffers(MB, NB, parent, parent.child, comm, C);
-        patch_block_scatter_matrix<T> M(comm, C,
+        allocate_buffers<T>(MB, NB, parent, parent.child, comm, C);
+        typedef typename MatrixC::value_type U;
+        patch_block_scatter_matrix<U> M(comm, C,
                                         MB, MB, parent.rscat, parent.rbs,
                                         NB, NB, parent.cscat, parent.cbs,
-                                        static_cast<block_scatter_matrix<T>*>(parent.patches));
+                                        static_cast<block_scatter_matrix<U>*>(parent.patches));
         parent.child(comm, cfg, alpha, A, B, beta, M);
     }
 };
@@ -250,7 +254,7 @@ using matrify_c = matrify<matrix_constants::MAT_C, &config::gemm_mr, &config::ge
 
 template <MemoryPool& Pool, typename Child>
 using matrify_and_pack_a = matrify<matrix_constants::MAT_A, &config::gemm_mr, &config::gemm_kr, Pool,
-                             pack<matrix_constants::MAT_A, &config::gemm_mr, Pool, Child>>;
+                             pack_a<Pool, Child>>;
 
 template <MemoryPool& Pool, typename Child>
 using matrify_and_pack_b = matrify<matrix_constants::MAT_B, &config::gemm_nr, &config::gemm_kr, Pool,
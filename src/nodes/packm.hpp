@@ -3,6 +3,7 @@
 
 #include "util/thread.h"
 #include "util/basic_types.h"
+#include "util/stats.h"
 
 #include "memory/alignment.hpp"
 #include "memory/memory_pool.hpp"
@@ -18,16 +19,42 @@
 namespace tblis
 {
 
+/*
+ * Charge each thread an equal share of the packed panel. Packing anything but
+ * a normal matrix goes through scatter vectors.
+ */
+template <typename T, typename Matrix>
+void count_bytes_packed(stats_counters* stats, const communicator& comm,
+                        const Matrix&, const normal_matrix<T>& P)
+{
+    if (!stats) return;
+
+    int64_t bytes = P.length(0)*P.length(1)*sizeof(T);
+    int64_t nt = comm.num_threads();
+    int64_t tid = comm.thread_num();
+    int64_t share = bytes*(tid+1)/nt - bytes*tid/nt;
+
+    stats_add(stats->bytes_packed, share);
+    if (!std::is_base_of<normal_matrix<T>,Matrix>::value)
+        stats_add(stats->bytes_scattered, share);
+}
+
 template <int Mat> struct pack_and_run;
 
 template <> struct pack_and_run<matrix_constants::MAT_A>
 {
     template <typename Run, typename T, typename MatrixA, typename MatrixB, typename MatrixC, typename MatrixP>
     pack_and_run(Run& run, const communicator& comm, const config& cfg,
-                 T alpha, MatrixA& A, MatrixB& B, T beta, MatrixC& C, MatrixP& P)
+                 T alpha, MatrixA& A, MatrixB& B, T beta, MatrixC& C, MatrixP& P,
+                 bool sync = true)
     {
+        stats_timer timer(KERNEL_GEMM);
+
         A.pack(comm, cfg, false, P);
+        timer.lap(&stats_counters::pack_time);
+        count_bytes_packed(timer.stats(), comm, A, P);
         comm.barrier();
+        timer.lap(&stats_counters::barrier_time);
 #if 0
         if (comm.master())
         {
@@ -44,7 +71,10 @@ template <> struct pack_and_run<matrix_constants::MAT_A>
         comm.barrier();
 #endif
         run(comm, cfg, alpha, P, B, beta, C);
+        timer.lap(&stats_counters::kernel_time);
+        if (!sync) return;
         comm.barrier();
+        timer.lap(&stats_counters::barrier_time);
     }
 };
 
@@ -52,10 +82,16 @@ template <> struct pack_and_run<matrix_constants::MAT_B>
 {
     template <typename Run, typename T, typename MatrixA, typename MatrixB, typename MatrixC, typename MatrixP>
     pack_and_run(Run& run, const communicator& comm, const config& cfg,
-                 T alpha, MatrixA& A, MatrixB& B, T beta, MatrixC& C, MatrixP& P)
+                 T alpha, MatrixA& A, MatrixB& B, T beta, MatrixC& C, MatrixP& P,
+                 bool sync = true)
     {
+        stats_timer timer(KERNEL_GEMM);
+
         B.pack(comm, cfg, true, P);
+        timer.lap(&stats_counters::pack_time);
+        count_bytes_packed(timer.stats(), comm, B, P);
         comm.barrier();
+        timer.lap(&stats_counters::barrier_time);
 #if 0
         if (comm.master())
         {
@@ -71,23 +107,62 @@ template <> struct pack_and_run<matrix_constants::MAT_B>
         }
         comm.barrier();
 #endif
+        /*
+         * The time spent in the inner loops is counted there.
+         */
         run(comm, cfg, alpha, A, P, beta, C);
+        timer.skip();
+        if (!sync) return;
         comm.barrier();
+        timer.lap(&stats_counters::barrier_time);
     }
 };
 
-template <int Mat, blocksize config::*BS, MemoryPool& Pool, typename Child>
+/*
+ * The number of elements of T in one packed buffer for an m x k block, rounded
+ * up so that a second buffer following it is aligned to a cache line.
+ */
+template <typename T>
+len_type pack_buffer_size(len_type m, len_type k)
+{
+    return round_up(m*k + std::max(m,k)*TBLIS_MAX_UNROLL, 64/sizeof(T));
+}
+
+/*
+ * Pack A or B and run the child on the packed block. When Pipelined, the node
+ * alternates between two buffers and skips the barrier after running the
+ * child: threads which are done with one block go on to pack the next one into
+ * the other buffer while the rest are still computing, and the barrier after
+ * packing ensures that every thread is done with a buffer before it is packed
+ * into again. The last skipped barrier is done when the node is destroyed,
+ * before the buffers are released.
+ *
+ * This is only safe if the child has no state shared between threads which is
+ * reused from one block to the next before that barrier (e.g. the scatter
+ * vectors of matrify_c are only filled after it).
+ */
+template <int Mat, blocksize config::*BS, MemoryPool& Pool, typename Child, bool Pipelined=false>
 struct pack
 {
+    static constexpr int num_buffers = (Pipelined ? 2 : 1);
+
     Child child;
     MemoryPool::Block pack_buffer;
     void* pack_ptr = nullptr;
+    len_type pack_size = 0;
+    int cur_buffer = 0;
+    const communicator* pending = nullptr;
 
     pack() {}
 
     pack(const pack& other)
     : child(other.child) {}
 
+    ~pack()
+    {
+        if (pending) pending->barrier();
+    }
+
     template <typename T, typename MatrixA, typename MatrixB, typename MatrixC>
     void operator()(const communicator& comm, const config& cfg,
                     T alpha, MatrixA& A, MatrixB& B, T beta, MatrixC& C)
@@ -104,9 +179,11 @@ struct pack
 
         if (!pack_ptr)
         {
+            pack_size = pack_buffer_size<T>(m_p, k_p);
+
             if (comm.master())
             {
-                pack_buffer = Pool.allocate<T>(m_p*k_p+std::max(m_p,k_p)*TBLIS_MAX_UNROLL);
+                pack_buffer = Pool.allocate<T>(num_buffers*pack_size);
                 pack_ptr = pack_buffer.get();
             }
 
@@ -115,16 +192,26 @@ struct pack
 
         normal_matrix<T> P(!Trans ? m_p : k_p,
                            !Trans ? k_p : m_p,
-                           static_cast<T*>(pack_ptr),
+                           static_cast<T*>(pack_ptr) + cur_buffer*pack_size,
                            !Trans? k_p :   1,
                            !Trans?   1 : k_p);
 
-        pack_and_run<Mat>(child, comm, cfg, alpha, A, B, beta, C, P);
+        pack_and_run<Mat>(child, comm, cfg, alpha, A, B, beta, C, P, !Pipelined);
+
+        if (Pipelined)
+        {
+            cur_buffer = (cur_buffer+1)%num_buffers;
+            pending = &comm;
+        }
     }
 };
 
+/*
+ * A is packed once for each block of M, so it is double-buffered. B is packed
+ * far less often and its buffer is much larger, so it is not.
+ */
 template <MemoryPool& Pool, typename Child>
-using pack_a = pack<matrix_constants::MAT_A, &config::gemm_mr, Pool, Child>;
+using pack_a = pack<matrix_constants::MAT_A, &config::gemm_mr, Pool, Child, true>;
 
 template <MemoryPool& Pool, typename Child>
 using pack_b = pack<matrix_constants::MAT_B, &config::gemm_nr, Pool, Child>;
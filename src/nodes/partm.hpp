@@ -9,6 +9,14 @@
 namespace tblis
 {
 
+/*
+ * Called on C before each block of k with whether it is the last one, after
+ * which C holds the complete product. Only matrices which do something with
+ * the finished result (see epilogue_matrix) need to overload this.
+ */
+template <typename MatrixC>
+void final_block_k(MatrixC&, bool) {}
+
 template <int Dim, blocksize config::*BS, typename Child>
 struct partition
 {
@@ -79,6 +87,8 @@ struct partition
                 len_type m_loc = std::min(m_last-m_off, M_cur);
                 length(m_loc, m_loc);
 
+                if (Dim == DIM_K) final_block_k(local_C, m_off+m_loc == m_last);
+
                 child(*subcomm, cfg, alpha, local_A, local_B, local_beta, local_C);
                 if (Dim == DIM_K) local_beta = 1.0;
 
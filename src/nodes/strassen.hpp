@@ -0,0 +1,574 @@
+#ifndef _TBLIS_NODES_STRASSEN_HPP_
+#define _TBLIS_NODES_STRASSEN_HPP_
+
+#include "gemm.hpp"
+
+#include "matrix/sum_matrix.hpp"
+
+#include <algorithm>
+#include <vector>
+
+namespace tblis
+{
+
+/*
+ * Strassen's algorithm on top of the normal GEMM blocking, in the style of
+ * Huang et al. (SC '16). Instead of forming the sums of submatrices of A and
+ * B explicitly, the terms are packed one after the other and accumulated in
+ * the packing buffers, and the product computed by each microkernel call is
+ * added to every submatrix of C which needs it. Since the tensors are never
+ * matricized (the terms are only addressed through scatter vectors), no
+ * extra workspace is needed beyond one more packing buffer.
+ */
+
+namespace detail
+{
+
+struct strassen_term
+{
+    len_type i, j;
+    int coef;
+};
+
+struct strassen_product
+{
+    std::vector<strassen_term> A, B, C;
+};
+
+/*
+ * Put a positive term first so that it can be packed directly. If all terms
+ * are negative then the sign is moved to C instead.
+ */
+inline void normalize_strassen_terms(std::vector<strassen_term>& X,
+                                     std::vector<strassen_term>& C)
+{
+    std::stable_sort(X.begin(), X.end(),
+                     [](const strassen_term& a, const strassen_term& b)
+                     {
+                         return a.coef > b.coef;
+                     });
+
+    if (X[0].coef < 0)
+    {
+        for (auto& term : X) term.coef = -term.coef;
+        for (auto& term : C) term.coef = -term.coef;
+    }
+}
+
+/*
+ * The products of the given number of levels of Strassen's algorithm, where
+ * each term refers to block (i,j) of the operand after it has been split
+ * into 2^levels blocks along each dimension.
+ */
+inline std::vector<strassen_product> strassen_products(unsigned levels)
+{
+    /*
+     * Coefficients of blocks 00, 01, 10, and 11 of A, B, and C for:
+     *
+     * M1 = (A00 + A11)*(B00 + B11)     C00 += M1, C11 += M1
+     * M2 = (A10 + A11)*B00             C10 += M2, C11 -= M2
+     * M3 = A00*(B01 - B11)             C01 += M3, C11 += M3
+     * M4 = A11*(B10 - B00)             C00 += M4, C10 += M4
+     * M5 = (A00 + A01)*B11             C00 -= M5, C01 += M5
+     * M6 = (A10 - A00)*(B00 + B01)     C11 += M6
+     * M7 = (A01 - A11)*(B10 + B11)     C00 += M7
+     */
+    static const int coefs[7][3][4] =
+    {
+        {{ 1, 0, 0, 1}, { 1, 0, 0, 1}, { 1, 0, 0, 1}},
+        {{ 0, 0, 1, 1}, { 1, 0, 0, 0}, { 0, 0, 1,-1}},
+        {{ 1, 0, 0, 0}, { 0, 1, 0,-1}, { 0, 1, 0, 1}},
+        {{ 0, 0, 0, 1}, {-1, 0, 1, 0}, { 1, 0, 1, 0}},
+        {{ 1, 1, 0, 0}, { 0, 0, 0, 1}, {-1, 1, 0, 0}},
+        {{-1, 0, 1, 0}, { 1, 1, 0, 0}, { 0, 0, 0, 1}},
+        {{ 0, 1, 0,-1}, { 0, 0, 1, 1}, { 1, 0, 0, 0}}
+    };
+
+    std::vector<strassen_product> products(1);
+    products[0].A.push_back({0, 0, 1});
+    products[0].B.push_back({0, 0, 1});
+    products[0].C.push_back({0, 0, 1});
+
+    for (unsigned level = 0;level < levels;level++)
+    {
+        std::vector<strassen_product> next;
+
+        for (auto& product : products)
+        {
+            for (auto& coef : coefs)
+            {
+                strassen_product sub;
+
+                auto split = [&](const std::vector<strassen_term>& from,
+                                 std::vector<strassen_term>& to, const int* c)
+                {
+                    for (auto& term : from)
+                    for (unsigned quad = 0;quad < 4;quad++)
+                    {
+                        if (c[quad] == 0) continue;
+                        to.push_back({2*term.i + quad/2, 2*term.j + quad%2,
+                                      term.coef*c[quad]});
+                    }
+                };
+
+                split(product.A, sub.A, coef[0]);
+                split(product.B, sub.B, coef[1]);
+                split(product.C, sub.C, coef[2]);
+
+                normalize_strassen_terms(sub.A, sub.C);
+                normalize_strassen_terms(sub.B, sub.C);
+
+                next.push_back(sub);
+            }
+        }
+
+        products.swap(next);
+    }
+
+    return products;
+}
+
+/*
+ * C += coef*AB for one microtile. The common case of C having regular strides
+ * with unit stride in the same dimension as AB (and beta == 1, which is
+ * always the case except for the first k block of the classical algorithm) is
+ * written out so that it vectorizes. A stride of zero means that the scatter
+ * vector must be used instead.
+ */
+template <typename T>
+void strassen_accum_utile(len_type m, len_type n, T coef,
+                          const T* TBLIS_RESTRICT p_ab, stride_type rs_ab, stride_type cs_ab,
+                          T beta, T* TBLIS_RESTRICT p_c,
+                          const stride_type* rscat_c, stride_type rs_c,
+                          const stride_type* cscat_c, stride_type cs_c)
+{
+    if (beta == T(1) && rs_c == 1 && cs_c && rs_ab == 1)
+    {
+        for (len_type j = 0;j < n;j++)
+            for (len_type i = 0;i < m;i++)
+                p_c[i + j*cs_c] += coef*p_ab[i + j*cs_ab];
+    }
+    else if (beta == T(1) && cs_c == 1 && rs_c && cs_ab == 1)
+    {
+        for (len_type i = 0;i < m;i++)
+            for (len_type j = 0;j < n;j++)
+                p_c[i*rs_c + j] += coef*p_ab[i*rs_ab + j];
+    }
+    else
+    {
+        T ab[512] __attribute__((aligned(64)));
+
+        for (len_type j = 0;j < n;j++)
+            for (len_type i = 0;i < m;i++)
+                ab[i*rs_ab + j*cs_ab] = coef*p_ab[i*rs_ab + j*cs_ab];
+
+        if (rs_c && cs_c)
+        {
+            accum_utile(m, n, ab, rs_ab, cs_ab,
+                        beta, p_c, rs_c, cs_c);
+        }
+        else if (rs_c)
+        {
+            accum_utile(m, n, ab, rs_ab, cs_ab,
+                        beta, p_c, rs_c, cscat_c);
+        }
+        else if (cs_c)
+        {
+            accum_utile(m, n, ab, rs_ab, cs_ab,
+                        beta, p_c, rscat_c, cs_c);
+        }
+        else
+        {
+            accum_utile(m, n, ab, rs_ab, cs_ab,
+                        beta, p_c, rscat_c, cscat_c);
+        }
+    }
+}
+
+}
+
+template <int Mat> struct strassen_pack_and_run;
+
+template <> struct strassen_pack_and_run<matrix_constants::MAT_A>
+{
+    template <typename Parent, typename T, typename MatrixA, typename MatrixB, typename MatrixC>
+    strassen_pack_and_run(Parent& parent, const communicator& comm, const config& cfg,
+                          T alpha, MatrixA& A, MatrixB& B, T beta, MatrixC& C)
+    {
+        stats_timer timer(KERNEL_GEMM);
+
+        auto P = parent.pack(comm, cfg, A);
+        timer.lap(&stats_counters::pack_time);
+        count_bytes_packed(timer.stats(), comm, A, P);
+        comm.barrier();
+        timer.lap(&stats_counters::barrier_time);
+        parent.child(comm, cfg, alpha, P, B, beta, C);
+        timer.lap(&stats_counters::kernel_time);
+        comm.barrier();
+        timer.lap(&stats_counters::barrier_time);
+    }
+};
+
+template <> struct strassen_pack_and_run<matrix_constants::MAT_B>
+{
+    template <typename Parent, typename T, typename MatrixA, typename MatrixB, typename MatrixC>
+    strassen_pack_and_run(Parent& parent, const communicator& comm, const config& cfg,
+                          T alpha, MatrixA& A, MatrixB& B, T beta, MatrixC& C)
+    {
+        stats_timer timer(KERNEL_GEMM);
+
+        auto P = parent.pack(comm, cfg, B);
+        timer.lap(&stats_counters::pack_time);
+        count_bytes_packed(timer.stats(), comm, B, P);
+        comm.barrier();
+        timer.lap(&stats_counters::barrier_time);
+        parent.child(comm, cfg, alpha, A, P, beta, C);
+        timer.skip();
+        comm.barrier();
+        timer.lap(&stats_counters::barrier_time);
+    }
+};
+
+/*
+ * Matricize and pack a sum of blocks of a tensor. The first term is packed
+ * directly, and the others are packed into a second buffer and added in.
+ */
+template <int Mat, MemoryPool& Pool, typename Child>
+struct strassen_pack
+{
+    Child child;
+    MemoryPool::Block pack_buffer;
+    void* pack_ptr = nullptr;
+    len_type pack_size = 0;
+
+    strassen_pack() {}
+
+    strassen_pack(const strassen_pack& other)
+    : child(other.child) {}
+
+    template <typename T>
+    normal_matrix<T> pack(const communicator& comm, const config& cfg,
+                          const sum_matrix<tensor_matrix<T>>& A)
+    {
+        using namespace matrix_constants;
+
+        constexpr bool Trans = (Mat == MAT_B);
+        const blocksize& M = (!Trans ? cfg.gemm_mr : cfg.gemm_nr);
+        const len_type MR = M.def<T>();
+        const len_type ME = M.extent<T>();
+        const len_type KR = cfg.gemm_kr.def<T>();
+        const len_type MB = (!Trans ? MR : KR);
+        const len_type NB = (!Trans ? KR : MR);
+
+        len_type m_p = ceil_div(A.length(Trans), MR)*ME;
+        len_type k_p = A.length(!Trans);
+        len_type size_p = m_p*k_p + std::max(m_p,k_p)*TBLIS_MAX_UNROLL;
+
+        len_type m_s = A.length(0) + MB-1;
+        len_type n_s = A.length(1) + NB-1;
+        unsigned nterm = A.num_terms();
+        unsigned nbuf = (nterm > 1 ? 2 : 1);
+
+        /*
+         * Unlike the normal GEMM, the first call is not necessarily the
+         * largest (the classical fringe comes after the half-size products),
+         * so grow the buffer when needed.
+         */
+        len_type size = nbuf*size_p + size_as_type<stride_type,T>(2*(m_s+n_s)*nterm);
+
+        if (size > pack_size)
+        {
+            if (comm.master())
+            {
+                pack_buffer = Pool.allocate<T>(size);
+                pack_ptr = pack_buffer.get();
+            }
+
+            comm.broadcast_value(pack_ptr);
+            pack_size = size;
+        }
+
+        T* p_p = static_cast<T*>(pack_ptr);
+        T* p_q = p_p + size_p;
+        stride_type* scat = convert_and_align<T,stride_type>(p_p + nbuf*size_p);
+
+        normal_matrix<T> P(!Trans ? m_p : k_p,
+                           !Trans ? k_p : m_p,
+                           p_p,
+                           !Trans? k_p :   1,
+                           !Trans?   1 : k_p);
+        normal_matrix<T> Q = P;
+        Q.data(p_q);
+
+        TBLIS_ASSERT(A.coef(0) == T(1));
+
+        for (unsigned t = 0;t < nterm;t++)
+        {
+            stride_type* rscat = scat + 2*(m_s+n_s)*t;
+            stride_type* rbs = rscat + m_s;
+            stride_type* cscat = rbs + m_s;
+            stride_type* cbs = cscat + n_s;
+
+            block_scatter_matrix<T> term(comm, A.term(t),
+                                         MB, rscat, rbs,
+                                         NB, cscat, cbs);
+
+            if (t == 0)
+            {
+                term.pack(comm, cfg, Trans, P);
+                continue;
+            }
+
+            term.pack(comm, cfg, Trans, Q);
+            comm.barrier();
+
+            T coef = A.coef(t);
+            comm.distribute_over_threads(m_p*k_p,
+            [&](len_type first, len_type last)
+            {
+                for (len_type i = first;i < last;i++)
+                    p_p[i] += coef*p_q[i];
+            });
+        }
+
+        return P;
+    }
+
+    template <typename T, typename MatrixA, typename MatrixB, typename MatrixC>
+    void operator()(const communicator& comm, const config& cfg,
+                    T alpha, MatrixA& A, MatrixB& B, T beta, MatrixC& C)
+    {
+        strassen_pack_and_run<Mat>(*this, comm, cfg, alpha, A, B, beta, C);
+    }
+};
+
+template <MemoryPool& Pool, typename Child>
+using strassen_pack_a = strassen_pack<matrix_constants::MAT_A, Pool, Child>;
+
+template <MemoryPool& Pool, typename Child>
+using strassen_pack_b = strassen_pack<matrix_constants::MAT_B, Pool, Child>;
+
+/*
+ * Build block scatter vectors for each block of C which is to be updated.
+ */
+template <MemoryPool& Pool, typename Child>
+struct strassen_matrify_c
+{
+    Child child;
+    MemoryPool::Block scat_buffer;
+    stride_type* scat = nullptr;
+    len_type scat_size = 0;
+
+    strassen_matrify_c() {}
+
+    strassen_matrify_c(const strassen_matrify_c& other)
+    : child(other.child) {}
+
+    template <typename T, typename MatrixA, typename MatrixB>
+    void operator()(const communicator& comm, const config& cfg,
+                    T alpha, MatrixA& A, MatrixB& B, T beta,
+                    sum_matrix<tensor_matrix<T>>& C)
+    {
+        const len_type MB = cfg.gemm_mr.def<T>();
+        const len_type NB = cfg.gemm_nr.def<T>();
+
+        len_type m_s = C.length(0) + MB-1;
+        len_type n_s = C.length(1) + NB-1;
+        unsigned nterm = C.num_terms();
+
+        len_type size = 2*(m_s+n_s)*nterm;
+
+        if (size > scat_size)
+        {
+            if (comm.master())
+            {
+                scat_buffer = Pool.allocate<stride_type>(size);
+                scat = scat_buffer.template get<stride_type>();
+            }
+
+            comm.broadcast_value(scat);
+            scat_size = size;
+        }
+
+        sum_matrix<block_scatter_matrix<T>> M;
+
+        for (unsigned t = 0;t < nterm;t++)
+        {
+            stride_type* rscat = scat + 2*(m_s+n_s)*t;
+            stride_type* rbs = rscat + m_s;
+            stride_type* cscat = rbs + m_s;
+            stride_type* cbs = cscat + n_s;
+
+            M.push_back(block_scatter_matrix<T>(comm, C.term(t),
+                                                MB, rscat, rbs,
+                                                NB, cscat, cbs), C.coef(t));
+        }
+
+        child(comm, cfg, alpha, A, B, beta, M);
+    }
+};
+
+/*
+ * Compute one microtile of A*B and add it to each block of C.
+ */
+struct strassen_micro_kernel
+{
+    template <typename T>
+    void operator()(const communicator& comm, const config& cfg,
+                    T alpha, normal_matrix<T>& A,
+                             normal_matrix<T>& B,
+                    T  beta, sum_matrix<block_scatter_matrix<T>>& C) const
+    {
+        if (C.num_terms() == 1)
+        {
+            gemm_micro_kernel()(comm, cfg, alpha*C.coef(0), A, B, beta, C.term(0));
+            return;
+        }
+
+        const len_type MR = cfg.gemm_mr.def<T>();
+        const len_type NR = cfg.gemm_nr.def<T>();
+        const bool row_major = cfg.gemm_row_major.value<T>();
+        const bool flip_ukr = cfg.gemm_flip_ukr.value<T>();
+        const len_type rs_ab = (row_major ? NR : 1);
+        const len_type cs_ab = (row_major ? 1 : MR);
+
+        const T* p_a = A.data();
+        const T* p_b = B.data();
+              T* p_c;
+
+        len_type m, n;
+        len_type k = A.length(1);
+        stride_type rs_c, cs_c;
+        const stride_type *rscat_c, *cscat_c;
+
+        C.term(0).block(p_c, rscat_c, rs_c, m, cscat_c, cs_c, n);
+        auto c_prefetch = p_c + (rs_c ? 0 : *rscat_c) + (cs_c ? 0 : *cscat_c);
+
+        count_flops(KERNEL_GEMM, 2*m*n*k);
+
+        T p_ab[512] __attribute__((aligned(64)));
+        static const T zero = T(0);
+
+        if (flip_ukr)
+        {
+            auxinfo_t aux{p_b, p_a, c_prefetch};
+            cfg.gemm_ukr.call<T>(k, &alpha, p_b, p_a,
+                                 &zero, &p_ab[0], cs_ab, rs_ab, &aux);
+        }
+        else
+        {
+            auxinfo_t aux{p_a, p_b, c_prefetch};
+            cfg.gemm_ukr.call<T>(k, &alpha, p_a, p_b,
+                                 &zero, &p_ab[0], rs_ab, cs_ab, &aux);
+        }
+
+        for (unsigned t = 0;t < C.num_terms();t++)
+        {
+            if (t > 0) C.term(t).block(p_c, rscat_c, rs_c, m, cscat_c, cs_c, n);
+
+            detail::strassen_accum_utile(m, n, C.coef(t), p_ab, rs_ab, cs_ab,
+                                         beta, p_c, rscat_c, rs_c, cscat_c, cs_c);
+        }
+    }
+};
+
+/*
+ * Compute C += alpha*A*B using the given number of levels (at most two) of
+ * Strassen's algorithm for the largest part of C whose lengths (and that of
+ * k) are divisible by 2^levels, and the classical algorithm for the rest.
+ * Since blocks of C receive several updates, there is no beta; scale C
+ * beforehand.
+ */
+template <typename Child>
+struct strassen
+{
+    Child child;
+    unsigned levels = 1;
+
+    template <typename T, typename MatrixA, typename MatrixB, typename MatrixC>
+    void operator()(const communicator& comm, const config& cfg,
+                    T alpha, const MatrixA& A, const MatrixB& B, const MatrixC& C)
+    {
+        len_type m = C.length(0);
+        len_type n = C.length(1);
+        len_type k = A.length(1);
+
+        unsigned nlevel = std::min(levels, 2u);
+        while (nlevel > 0 && (std::min({m, n, k}) >> nlevel) == 0) nlevel--;
+
+        len_type m_s = m >> nlevel;
+        len_type n_s = n >> nlevel;
+        len_type k_s = k >> nlevel;
+
+        auto submatrix = [](auto X, len_type off_m, len_type m,
+                                    len_type off_n, len_type n)
+        {
+            X.length(0, m);
+            X.length(1, n);
+            X.shift(0, off_m);
+            X.shift(1, off_n);
+            return X;
+        };
+
+        for (auto& product : detail::strassen_products(nlevel))
+        {
+            sum_matrix<MatrixA> A_sum;
+            sum_matrix<MatrixB> B_sum;
+            sum_matrix<MatrixC> C_sum;
+
+            for (auto& term : product.A)
+                A_sum.push_back(submatrix(A, term.i*m_s, m_s, term.j*k_s, k_s), T(term.coef));
+
+            for (auto& term : product.B)
+                B_sum.push_back(submatrix(B, term.i*k_s, k_s, term.j*n_s, n_s), T(term.coef));
+
+            for (auto& term : product.C)
+                C_sum.push_back(submatrix(C, term.i*m_s, m_s, term.j*n_s, n_s), T(term.coef));
+
+            child(comm, cfg, alpha, A_sum, B_sum, T(1), C_sum);
+            comm.barrier();
+        }
+
+        auto classical = [&](len_type m0, len_type m1,
+                             len_type n0, len_type n1,
+                             len_type k0, len_type k1)
+        {
+            if (m0 == m1 || n0 == n1 || k0 == k1) return;
+
+            sum_matrix<MatrixA> A_sub;
+            sum_matrix<MatrixB> B_sub;
+            sum_matrix<MatrixC> C_sub;
+
+            A_sub.push_back(submatrix(A, m0, m1-m0, k0, k1-k0), T(1));
+            B_sub.push_back(submatrix(B, k0, k1-k0, n0, n1-n0), T(1));
+            C_sub.push_back(submatrix(C, m0, m1-m0, n0, n1-n0), T(1));
+
+            child(comm, cfg, alpha, A_sub, B_sub, T(1), C_sub);
+            comm.barrier();
+        };
+
+        len_type m_S = m_s << nlevel;
+        len_type n_S = n_s << nlevel;
+        len_type k_S = k_s << nlevel;
+
+        classical(  0, m_S,   0, n_S, k_S, k);
+        classical(m_S,   m,   0,   n,   0, k);
+        classical(  0, m_S, n_S,   n,   0, k);
+    }
+};
+
+using StrassenGEMM = strassen<
+                       gemm<
+                         partition_gemm_nc<
+                           partition_gemm_kc<
+                             strassen_pack_b<BuffersForB,
+                               partition_gemm_mc<
+                                 strassen_pack_a<BuffersForA,
+                                   strassen_matrify_c<BuffersForScatter,
+                                     partition_gemm_nr<
+                                       partition_gemm_mr<
+                                         strassen_micro_kernel>>>>>>>>>>;
+
+}
+
+#endif
@@ -2,6 +2,7 @@
 #define _TBLIS_HPP_
 
 #include "util/configs.h"
+#include "util/stats.h"
 
 #include "iface/1v/add.h"
 #include "iface/1v/dot.h"
@@ -21,6 +22,7 @@
 #include "iface/1t/scale.h"
 #include "iface/1t/set.h"
 
+#include "iface/3m/gemm_backend.h"
 #include "iface/3m/mult.h"
 
 #include "iface/3t/mult.h"
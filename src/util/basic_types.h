@@ -124,6 +124,22 @@ template <> struct type_tag<  double> { static constexpr type_t value =   TYPE_D
 template <> struct type_tag<scomplex> { static constexpr type_t value = TYPE_SCOMPLEX; };
 template <> struct type_tag<dcomplex> { static constexpr type_t value = TYPE_DCOMPLEX; };
 
+/*
+ * The type in the same domain (real or complex) as T but with the other
+ * precision, for mixed-precision operations.
+ */
+template <typename T> struct other_precision;
+template <> struct other_precision<   float> { typedef   double type; };
+template <> struct other_precision<  double> { typedef    float type; };
+template <> struct other_precision<scomplex> { typedef dcomplex type; };
+template <> struct other_precision<dcomplex> { typedef scomplex type; };
+
+template <typename T>
+using other_precision_t = typename other_precision<T>::type;
+
+template <typename T, typename U>
+using higher_precision_t = std::conditional_t<(sizeof(T) >= sizeof(U)), T, U>;
+
 using stl_ext::enable_if_t;
 using stl_ext::enable_if_integral_t;
 using stl_ext::enable_if_floating_point_t;
@@ -34,4 +34,17 @@ else \
 if (condition) { __VA_ARGS__ } \
 else           { __VA_ARGS__ }
 
+/*
+ * Request complete unrolling of a loop with a small, constant trip count.
+ * Register blocks in intrinsics kernels are only kept in registers when
+ * every loop over them has been unrolled.
+ */
+#if defined(__INTEL_COMPILER)
+#define TBLIS_UNROLL _Pragma("unroll")
+#elif defined(__GNUC__)
+#define TBLIS_UNROLL _Pragma("GCC unroll 32")
+#else
+#define TBLIS_UNROLL
+#endif
+
 #endif
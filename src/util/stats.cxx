@@ -0,0 +1,179 @@
+#include "stats.h"
+#include "env.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace tblis
+{
+
+std::atomic<bool> stats_enabled{envtol("TBLIS_STATS") != 0};
+
+namespace
+{
+
+/*
+ * Padded so that no other heap object shares a cache line with the counters.
+ */
+struct thread_record
+{
+    char pad1[64];
+    stats_counters kernel[TBLIS_NUM_KERNEL_CLASSES];
+    char pad2[64];
+};
+
+void accumulate(const stats_counters& from, tblis_stats& to)
+{
+    to.flops += from.flops.load(std::memory_order_relaxed);
+    to.bytes_packed += from.bytes_packed.load(std::memory_order_relaxed);
+    to.bytes_scattered += from.bytes_scattered.load(std::memory_order_relaxed);
+    to.pack_time += from.pack_time.load(std::memory_order_relaxed);
+    to.kernel_time += from.kernel_time.load(std::memory_order_relaxed);
+    to.barrier_time += from.barrier_time.load(std::memory_order_relaxed);
+}
+
+void accumulate(const stats_counters& from, stats_counters& to)
+{
+    stats_add(to.flops, from.flops.load(std::memory_order_relaxed));
+    stats_add(to.bytes_packed, from.bytes_packed.load(std::memory_order_relaxed));
+    stats_add(to.bytes_scattered, from.bytes_scattered.load(std::memory_order_relaxed));
+    stats_add(to.pack_time, from.pack_time.load(std::memory_order_relaxed));
+    stats_add(to.kernel_time, from.kernel_time.load(std::memory_order_relaxed));
+    stats_add(to.barrier_time, from.barrier_time.load(std::memory_order_relaxed));
+}
+
+void clear(stats_counters& counters)
+{
+    counters.flops.store(0, std::memory_order_relaxed);
+    counters.bytes_packed.store(0, std::memory_order_relaxed);
+    counters.bytes_scattered.store(0, std::memory_order_relaxed);
+    counters.pack_time.store(0, std::memory_order_relaxed);
+    counters.kernel_time.store(0, std::memory_order_relaxed);
+    counters.barrier_time.store(0, std::memory_order_relaxed);
+}
+
+/*
+ * Never destroyed, so that threads exiting after static destruction has
+ * started can still retire their counters.
+ */
+struct registry
+{
+    std::mutex lock;
+    std::vector<thread_record*> threads;
+    thread_record retired;
+
+    static registry& get()
+    {
+        static registry* reg = new registry;
+        return *reg;
+    }
+};
+
+/*
+ * The calling thread's record. As with the memory pool caches, whether the
+ * record is live (0 = not yet created, 1 = live, 2 = destroyed) is tracked
+ * in a trivially destructible flag.
+ */
+struct thread_record_holder
+{
+    std::unique_ptr<thread_record> record{new thread_record};
+
+    thread_record_holder()
+    {
+        auto& reg = registry::get();
+        std::lock_guard<std::mutex> guard(reg.lock);
+        reg.threads.push_back(record.get());
+        state() = 1;
+    }
+
+    ~thread_record_holder()
+    {
+        auto& reg = registry::get();
+        std::lock_guard<std::mutex> guard(reg.lock);
+
+        for (int i = 0;i < TBLIS_NUM_KERNEL_CLASSES;i++)
+            accumulate(record->kernel[i], reg.retired.kernel[i]);
+
+        reg.threads.erase(std::find(reg.threads.begin(), reg.threads.end(),
+                                    record.get()));
+        state() = 2;
+    }
+
+    static unsigned& state()
+    {
+        static thread_local unsigned state = 0;
+        return state;
+    }
+};
+
+}
+
+stats_counters* thread_stats_counters(kernel_class_t kernel)
+{
+    if (thread_record_holder::state() == 2) return nullptr;
+
+    static thread_local thread_record_holder holder;
+    return &holder.record->kernel[kernel];
+}
+
+}
+
+using namespace tblis;
+
+extern "C"
+{
+
+void tblis_set_stats_enabled(int enabled)
+{
+    stats_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+int tblis_get_stats_enabled()
+{
+    return stats_enabled.load(std::memory_order_relaxed);
+}
+
+void tblis_reset_stats()
+{
+    auto& reg = registry::get();
+    std::lock_guard<std::mutex> guard(reg.lock);
+
+    for (int i = 0;i < TBLIS_NUM_KERNEL_CLASSES;i++)
+    {
+        clear(reg.retired.kernel[i]);
+        for (auto record : reg.threads) clear(record->kernel[i]);
+    }
+}
+
+void tblis_get_stats(kernel_class_t kernel, tblis_stats* stats)
+{
+    auto& reg = registry::get();
+    std::lock_guard<std::mutex> guard(reg.lock);
+
+    *stats = tblis_stats();
+    accumulate(reg.retired.kernel[kernel], *stats);
+    for (auto record : reg.threads) accumulate(record->kernel[kernel], *stats);
+}
+
+unsigned tblis_get_stats_num_threads()
+{
+    auto& reg = registry::get();
+    std::lock_guard<std::mutex> guard(reg.lock);
+
+    return reg.threads.size();
+}
+
+void tblis_get_thread_stats(unsigned thread, kernel_class_t kernel,
+                            tblis_stats* stats)
+{
+    auto& reg = registry::get();
+    std::lock_guard<std::mutex> guard(reg.lock);
+
+    *stats = tblis_stats();
+    if (thread < reg.threads.size())
+        accumulate(reg.threads[thread]->kernel[kernel], *stats);
+}
+
+}
@@ -0,0 +1,156 @@
+#ifndef _TBLIS_STATS_H_
+#define _TBLIS_STATS_H_
+
+#include "basic_types.h"
+
+typedef enum
+{
+    KERNEL_GEMM   = 0,
+    KERNEL_LEVEL2 = 1,
+    KERNEL_LEVEL1 = 2
+} kernel_class_t;
+
+#define TBLIS_NUM_KERNEL_CLASSES 3
+
+/*
+ * Work done by one thread (or by all threads) in one class of kernels.
+ * Times are in seconds. Bytes packed and bytes scattered are only counted
+ * for packed GEMM, the latter for operands addressed through scatter vectors.
+ */
+typedef struct tblis_stats
+{
+    int64_t flops;
+    int64_t bytes_packed;
+    int64_t bytes_scattered;
+    double pack_time;
+    double kernel_time;
+    double barrier_time;
+} tblis_stats;
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*
+ * Instrumentation is disabled by default and may also be enabled by setting
+ * TBLIS_STATS=1 in the environment. When disabled, kernels only test a flag.
+ */
+void tblis_set_stats_enabled(int enabled);
+
+int tblis_get_stats_enabled();
+
+/*
+ * Zero the counters of all threads. Counts made concurrently with a reset
+ * may be lost.
+ */
+void tblis_reset_stats();
+
+/*
+ * Sum of the counters of all threads, including threads which have exited.
+ */
+void tblis_get_stats(kernel_class_t kernel, tblis_stats* stats);
+
+/*
+ * Number of live threads which have recorded statistics, and the counters of
+ * the i-th such thread.
+ */
+unsigned tblis_get_stats_num_threads();
+
+void tblis_get_thread_stats(unsigned thread, kernel_class_t kernel,
+                            tblis_stats* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#if defined(__cplusplus) && !defined(TBLIS_DONT_USE_CXX11)
+
+#include <atomic>
+
+#include "time.hpp"
+
+namespace tblis
+{
+
+struct stats_counters
+{
+    std::atomic<int64_t> flops{0};
+    std::atomic<int64_t> bytes_packed{0};
+    std::atomic<int64_t> bytes_scattered{0};
+    std::atomic<double> pack_time{0};
+    std::atomic<double> kernel_time{0};
+    std::atomic<double> barrier_time{0};
+};
+
+extern std::atomic<bool> stats_enabled;
+
+/*
+ * The calling thread's counters, or nullptr if instrumentation is disabled
+ * (or the thread's counters have already been destroyed at exit). Counters
+ * are only ever written by their own thread, so updates are plain loads and
+ * stores and no cache line is shared between threads.
+ */
+stats_counters* thread_stats_counters(kernel_class_t kernel);
+
+inline stats_counters* thread_stats(kernel_class_t kernel)
+{
+    if (!stats_enabled.load(std::memory_order_relaxed)) return nullptr;
+    return thread_stats_counters(kernel);
+}
+
+template <typename T, typename U>
+void stats_add(std::atomic<T>& counter, U value)
+{
+    counter.store(counter.load(std::memory_order_relaxed) + T(value),
+                  std::memory_order_relaxed);
+}
+
+inline void count_flops(kernel_class_t kernel, int64_t flops)
+{
+    if (auto stats = thread_stats(kernel)) stats_add(stats->flops, flops);
+}
+
+inline void count_bytes_scattered(kernel_class_t kernel, int64_t bytes)
+{
+    if (auto stats = thread_stats(kernel)) stats_add(stats->bytes_scattered, bytes);
+}
+
+/*
+ * Attributes the time between successive calls of lap() to one of the time
+ * counters.
+ */
+class stats_timer
+{
+    public:
+        stats_timer(kernel_class_t kernel)
+        : _stats(thread_stats(kernel))
+        {
+            if (_stats) _last = tic();
+        }
+
+        void lap(std::atomic<double> stats_counters::*counter)
+        {
+            if (!_stats) return;
+            double now = tic();
+            stats_add(_stats->*counter, now-_last);
+            _last = now;
+        }
+
+        void skip()
+        {
+            if (_stats) _last = tic();
+        }
+
+        stats_counters* stats() const { return _stats; }
+
+    protected:
+        stats_counters* _stats;
+        double _last = 0;
+};
+
+}
+
+#endif
+
+#endif
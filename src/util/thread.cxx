@@ -97,7 +97,6 @@ namespace tblis
 
 tci::communicator single;
 
-std::atomic<long> flops{0};
 len_type inout_ratio = 200000;
 
 }
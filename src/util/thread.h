@@ -42,7 +42,6 @@ using tci::partition_2x2;
 
 extern communicator single;
 
-extern std::atomic<long> flops;
 extern len_type inout_ratio;
 extern int outer_threading;
 
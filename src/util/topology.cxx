@@ -0,0 +1,130 @@
+#include "topology.hpp"
+#include "env.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+namespace tblis
+{
+
+namespace
+{
+
+/*
+ * Parse a CPU list like "0-7,16-23" and mark the listed CPUs as belonging to
+ * node.
+ */
+void parse_cpu_list(const std::string& list, unsigned node,
+                    std::vector<unsigned>& node_of_cpu)
+{
+    std::istringstream is(list);
+    std::string range;
+
+    while (std::getline(is, range, ','))
+    {
+        unsigned first, last;
+        int n = sscanf(range.c_str(), "%u-%u", &first, &last);
+        if (n < 1) continue;
+        if (n == 1) last = first;
+
+        if (node_of_cpu.size() <= last) node_of_cpu.resize(last+1, 0);
+        for (unsigned cpu = first;cpu <= last;cpu++) node_of_cpu[cpu] = node;
+    }
+}
+
+numa_topology discover_topology()
+{
+    numa_topology topo;
+
+    if (!envtol("TBLIS_NUMA", 1)) return topo;
+
+#ifdef __linux__
+
+    unsigned num_nodes = 0;
+
+    /*
+     * System node numbers may have gaps, so look a bit past the last one
+     * found before giving up.
+     */
+    for (unsigned sys_node = 0, misses = 0;misses < 64;sys_node++)
+    {
+        std::ifstream ifs("/sys/devices/system/node/node" +
+                          std::to_string(sys_node) + "/cpulist");
+
+        std::string list;
+        if (!ifs || !std::getline(ifs, list) || list.empty())
+        {
+            misses++;
+            continue;
+        }
+
+        misses = 0;
+        parse_cpu_list(list, num_nodes++, topo.node_of_cpu);
+    }
+
+    if (num_nodes > 1) topo.num_nodes = num_nodes;
+    else topo.node_of_cpu.clear();
+
+#endif
+
+    if (get_verbose() >= 1 && topo.num_nodes > 1)
+        printf("tblis: Found %u NUMA nodes.\n", topo.num_nodes);
+
+    return topo;
+}
+
+}
+
+const numa_topology& get_numa_topology()
+{
+    static numa_topology topo = discover_topology();
+    return topo;
+}
+
+unsigned numa_current_node()
+{
+    auto& topo = get_numa_topology();
+    if (topo.num_nodes == 1) return 0;
+
+#ifdef __linux__
+    int cpu = sched_getcpu();
+    if (cpu >= 0 && unsigned(cpu) < topo.node_of_cpu.size())
+        return topo.node_of_cpu[cpu];
+#endif
+
+    return 0;
+}
+
+unsigned numa_thread_rank(const communicator& comm)
+{
+    if (get_numa_topology().num_nodes == 1 || comm.num_threads() == 1)
+        return comm.thread_num();
+
+    std::vector<unsigned> nodes;
+    auto ptr = &nodes;
+
+    if (comm.master()) nodes.resize(comm.num_threads());
+    comm.broadcast_value(ptr);
+
+    unsigned node = numa_current_node();
+    (*ptr)[comm.thread_num()] = node;
+    comm.barrier();
+
+    unsigned rank = 0;
+    for (unsigned tid = 0;tid < comm.num_threads();tid++)
+    {
+        unsigned other = (*ptr)[tid];
+        if (other < node || (other == node && tid < comm.thread_num())) rank++;
+    }
+    comm.barrier();
+
+    return rank;
+}
+
+}
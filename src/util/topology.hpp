@@ -0,0 +1,41 @@
+#ifndef _TBLIS_TOPOLOGY_HPP_
+#define _TBLIS_TOPOLOGY_HPP_
+
+#include <vector>
+
+#include "thread.h"
+
+namespace tblis
+{
+
+/*
+ * The NUMA domains of the machine, as found in /sys on Linux. Nodes are
+ * numbered contiguously from zero regardless of the system numbering. On
+ * other systems, or when TBLIS_NUMA=0 is set in the environment, there is
+ * just one node.
+ */
+struct numa_topology
+{
+    unsigned num_nodes = 1;
+    std::vector<unsigned> node_of_cpu;
+};
+
+const numa_topology& get_numa_topology();
+
+/*
+ * The node of the CPU which the calling thread is currently running on.
+ * Unless threads are bound to CPUs (e.g. with OMP_PROC_BIND or taskset), this
+ * is only a hint.
+ */
+unsigned numa_current_node();
+
+/*
+ * A rank for each thread in comm such that threads on the same node have
+ * consecutive ranks, suitable for communicator::gang. Must be called by all
+ * threads.
+ */
+unsigned numa_thread_rank(const communicator& comm);
+
+}
+
+#endif
@@ -0,0 +1,101 @@
+#include "../test.hpp"
+
+#include "configs/include_configs.hpp"
+
+using instance_fn_t = const config& (*)(void);
+
+enum config_t
+{
+#define FOREACH_CONFIG(config) config##_value,
+#include "configs/foreach_config.h"
+    num_configs
+};
+
+const check_fn_t checks[] =
+{
+#define FOREACH_CONFIG(config) config::check,
+#include "configs/foreach_config.h"
+};
+
+const instance_fn_t instance[] =
+{
+#define FOREACH_CONFIG(config) &config::instance,
+#include "configs/foreach_config.h"
+};
+
+/*
+ * Assume:
+ *  m_r/n_r <= 32
+ *  general stride = 2
+ */
+TEMPLATED_TEST_CASE(trans_ukr, T, all_types)
+{
+    for (unsigned i = 0;i < num_configs;i++)
+    {
+        if (checks[i]() == -1) continue;
+
+        auto& cfg = instance[i]();
+
+        len_type MR = cfg.trans_mr.def<T>();
+        len_type NR = cfg.trans_nr.def<T>();
+
+        INFO_OR_PRINT("ukernel: " << cfg.name);
+        INFO_OR_PRINT("MR, NR = " << MR << ", " << NR);
+
+        for (auto mn : (len_type[6][2]){{0, 0}, {1, 1}, {MR, 1}, {1, NR},
+                                        {MR-1, NR}, {MR, NR}})
+        {
+            auto m = mn[0];
+            auto n = mn[1];
+
+            INFO("m, n = " << m << ", " << n);
+
+            /*
+             * A row-major and B column-major, the other way around, and
+             * general strides.
+             */
+            for (auto strides : (stride_type[3][4]){{NR+1, 1, 1, MR+3},
+                                                    {1, MR+1, NR+3, 1},
+                                                    {2*NR, 2, 2, 2*MR}})
+            {
+                auto rs_A = strides[0];
+                auto cs_A = strides[1];
+                auto rs_B = strides[2];
+                auto cs_B = strides[3];
+
+                INFO("rs_A, cs_A = " << rs_A << ", " << cs_A);
+                INFO("rs_B, cs_B = " << rs_B << ", " << cs_B);
+
+                for (T beta : {0, 1, -1})
+                {
+                    INFO("beta = " << beta);
+
+                    bool conj_A = random_choice();
+                    bool conj_B = random_choice();
+                    T alpha = random_unit<T>();
+
+                    row<T> A({2*32*32}, uninitialized);
+                    row<T> B({2*32*32}, uninitialized);
+                    row<T> C({2*32*32}, uninitialized);
+
+                    for (len_type j = 0;j < A.length();j++)
+                        A[j] = random_unit<T>();
+                    for (len_type j = 0;j < B.length();j++)
+                        B[j] = C[j] = random_unit<T>();
+
+                    cfg.trans_ukr.call<T>(m, n,
+                                          alpha, conj_A, A.data(), rs_A, cs_A,
+                                           beta, conj_B, B.data(), rs_B, cs_B);
+
+                    trans_ukr_gen(m, n, alpha, conj_A, A.data(), rs_A, cs_A,
+                                         beta, conj_B, C.data(), rs_B, cs_B);
+
+                    add<T>(T(-1), B, T(1), C);
+                    T error = reduce<T>(REDUCE_NORM_2, C).first;
+
+                    check("REF", error, m*n);
+                }
+            }
+        }
+    }
+}
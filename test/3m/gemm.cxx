@@ -48,6 +48,48 @@ REPLICATED_TEMPLATED_TEST_CASE(gemm, R, T, all_types)
     check("REF", error, scale*m*n*k);
 }
 
+REPLICATED_TEMPLATED_TEST_CASE(gemm_stats, R, T, all_types)
+{
+    matrix<T> A, B, C;
+
+    /*
+     * Products with a unit length are done with level 1 and 2 kernels.
+     */
+    do
+    {
+        random_gemm(N/10, A, B, C);
+    }
+    while (C.length(0) == 1 || C.length(1) == 1 || A.length(1) == 1);
+
+    len_type m = C.length(0);
+    len_type n = C.length(1);
+    len_type k = A.length(1);
+
+    INFO_OR_PRINT("m, n, k    = " << m << ", " << n << ", " << k);
+
+    tblis_set_stats_enabled(true);
+    tblis_reset_stats();
+
+    mult<T>(T(1), A, B, T(1), C);
+
+    tblis_set_stats_enabled(false);
+
+    tblis_stats stats;
+    tblis_get_stats(KERNEL_GEMM, &stats);
+
+    INFO_OR_PRINT("flops = " << stats.flops);
+    INFO_OR_PRINT("bytes packed = " << stats.bytes_packed);
+    REQUIRE(stats.flops == 2*m*n*k);
+    REQUIRE(stats.bytes_packed >= (m+n)*k*(stride_type)sizeof(T));
+    REQUIRE(stats.bytes_scattered == 0);
+    REQUIRE(stats.kernel_time >= 0);
+
+    mult<T>(T(1), A, B, T(1), C);
+
+    tblis_get_stats(KERNEL_GEMM, &stats);
+    REQUIRE(stats.flops == 2*m*n*k);
+}
+
 REPLICATED_TEMPLATED_TEST_CASE(gemm_diag, R, T, all_types)
 {
     matrix<T> A, B, C, E, F;
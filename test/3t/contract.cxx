@@ -75,6 +75,653 @@ REPLICATED_TEMPLATED_TEST_CASE(contract, R, T, all_types)
     check("BLIS", error, scale*neps);
 }
 
+REPLICATED_TEMPLATED_TEST_CASE(contract_conj, R, T, all_types)
+{
+    varray<T> A, B, C, D, E;
+    label_vector idx_A, idx_B, idx_C;
+
+    random_contract(N, A, idx_A, B, idx_B, C, idx_C);
+
+    T scale(10.0*random_unit<T>());
+
+    bool conj_A = random_number(0,1);
+    bool conj_B = random_number(0,1);
+    bool conj_C = random_number(0,1);
+
+    TENSOR_INFO(A);
+    TENSOR_INFO(B);
+    TENSOR_INFO(C);
+    INFO_OR_PRINT("conj = " << conj_A << ", " << conj_B << ", " << conj_C);
+
+    auto idx_AB = intersection(idx_A, idx_B);
+    auto neps = (prod(select_from(A.lengths(), idx_A, idx_AB))+1)*prod(C.lengths());
+
+    auto mult_conj = [&](varray<T>& C)
+    {
+        varray_view<T> Av = A, Bv = B, Cv = C;
+        tblis_tensor A_s(scale, Av);
+        tblis_tensor B_s(Bv);
+        tblis_tensor C_s(scale, Cv);
+        A_s.conj = conj_A;
+        B_s.conj = conj_B;
+        C_s.conj = conj_C;
+        tblis_tensor_mult(nullptr, nullptr, &A_s, idx_A.data(), &B_s, idx_B.data(),
+                          &C_s, idx_C.data());
+    };
+
+    impl = REFERENCE;
+    D.reset(C);
+    mult_conj(D);
+
+    impl = BLIS_BASED;
+    E.reset(C);
+    mult_conj(E);
+
+    add<T>(T(-1), D, idx_C.data(), T(1), E, idx_C.data());
+    T error = reduce<T>(REDUCE_NORM_2, E, idx_C.data()).first;
+
+    check("BLIS", error, scale*neps);
+}
+
+/*
+ * A column-major GEMM with the Fortran BLAS calling convention, standing in
+ * for a vendor BLAS.
+ */
+template <typename T>
+void backend_gemm(const char* transa, const char* transb,
+                  const int* m, const int* n, const int* k,
+                  const T* alpha, const T* A, const int* lda,
+                                  const T* B, const int* ldb,
+                  const T* beta,        T* C, const int* ldc)
+{
+    auto elem = [](char trans, const T* X, int ld, int i, int j)
+    {
+        if (trans == 'N') return X[i + j*ld];
+        return trans == 'C' ? tblis::conj(X[j + i*ld]) : X[j + i*ld];
+    };
+
+    for (int j = 0;j < *n;j++)
+    {
+        for (int i = 0;i < *m;i++)
+        {
+            T sum = T();
+            for (int p = 0;p < *k;p++)
+                sum += elem(*transa, A, *lda, i, p)*elem(*transb, B, *ldb, p, j);
+
+            T& c = C[i + j*(*ldc)];
+            c = (*beta == T(0) ? *alpha*sum : *alpha*sum + *beta*c);
+        }
+    }
+}
+
+REPLICATED_TEMPLATED_TEST_CASE(contract_blas_backend, R, T, all_types)
+{
+    varray<T> A, B, C, D, E;
+    label_vector idx_A, idx_B, idx_C;
+
+    random_contract(N, A, idx_A, B, idx_B, C, idx_C);
+
+    T scale(10.0*random_unit<T>());
+
+    bool conj_A = random_number(0,1);
+    bool conj_B = random_number(0,1);
+    bool conj_C = random_number(0,1);
+
+    TENSOR_INFO(A);
+    TENSOR_INFO(B);
+    TENSOR_INFO(C);
+    INFO_OR_PRINT("conj = " << conj_A << ", " << conj_B << ", " << conj_C);
+
+    auto idx_AB = intersection(idx_A, idx_B);
+    auto neps = (prod(select_from(A.lengths(), idx_A, idx_AB))+1)*prod(C.lengths());
+
+    auto mult_conj = [&](varray<T>& C)
+    {
+        varray_view<T> Av = A, Bv = B, Cv = C;
+        tblis_tensor A_s(scale, Av);
+        tblis_tensor B_s(Bv);
+        tblis_tensor C_s(scale, Cv);
+        A_s.conj = conj_A;
+        B_s.conj = conj_B;
+        C_s.conj = conj_C;
+        tblis_tensor_mult(nullptr, nullptr, &A_s, idx_A.data(), &B_s, idx_B.data(),
+                          &C_s, idx_C.data());
+    };
+
+    impl = BLIS_BASED;
+    D.reset(C);
+    mult_conj(D);
+
+    tblis_gemm_backend old_backend;
+    tblis_get_gemm_backend(&old_backend);
+
+    tblis_gemm_backend backend;
+    backend.sgemm = backend_gemm<float>;
+    backend.dgemm = backend_gemm<double>;
+    backend.cgemm = backend_gemm<scomplex>;
+    backend.zgemm = backend_gemm<dcomplex>;
+    tblis_set_gemm_backend(&backend);
+
+    impl = BLAS_BASED;
+    E.reset(C);
+    mult_conj(E);
+
+    tblis_set_gemm_backend(&old_backend);
+    impl = BLIS_BASED;
+
+    add<T>(T(-1), D, idx_C.data(), T(1), E, idx_C.data());
+    T error = reduce<T>(REDUCE_NORM_2, E, idx_C.data()).first;
+
+    check("BACKEND", error, scale*neps);
+}
+
+REPLICATED_TEMPLATED_TEST_CASE(contract_strassen, R, T, all_types)
+{
+    varray<T> A, B, C, D, E;
+    label_vector idx_A, idx_B, idx_C;
+
+    random_contract(N, A, idx_A, B, idx_B, C, idx_C);
+
+    T scale(10.0*random_unit<T>());
+
+    unsigned levels = random_number(1,2);
+
+    TENSOR_INFO(A);
+    TENSOR_INFO(B);
+    TENSOR_INFO(C);
+    INFO_OR_PRINT("levels = " << levels);
+
+    auto idx_AB = intersection(idx_A, idx_B);
+    auto neps = (prod(select_from(A.lengths(), idx_A, idx_AB))+1)*prod(C.lengths());
+
+    impl = REFERENCE;
+    D.reset(C);
+    mult<T>(scale, A, idx_A.data(), B, idx_B.data(), scale, D, idx_C.data());
+
+    /*
+     * Use Strassen's algorithm regardless of size, which also exercises the
+     * handling of lengths which are not divisible by 2^levels.
+     */
+    auto old_levels = strassen_levels;
+    auto old_min_length = strassen_min_length;
+    strassen_levels = levels;
+    strassen_min_length = 1;
+
+    impl = BLIS_BASED;
+    E.reset(C);
+    mult<T>(scale, A, idx_A.data(), B, idx_B.data(), scale, E, idx_C.data());
+
+    strassen_levels = old_levels;
+    strassen_min_length = old_min_length;
+
+    add<T>(T(-1), D, idx_C.data(), T(1), E, idx_C.data());
+    T error = reduce<T>(REDUCE_NORM_2, E, idx_C.data()).first;
+
+    check("STRASSEN", error, 4*levels*scale*neps);
+}
+
+REPLICATED_TEMPLATED_TEST_CASE(contract_matrix, R, T, all_types)
+{
+    /*
+     * Each group of indices is contiguous in both tensors which it appears
+     * in, so that the operands are plain matrices (in either order).
+     */
+    auto random_group = [](label_type first, len_vector& len, label_vector& idx)
+    {
+        unsigned ndim = random_number(1,3);
+        for (unsigned i = 0;i < ndim;i++)
+        {
+            len.push_back(random_number(2,5));
+            idx.push_back(first+i);
+        }
+    };
+
+    len_vector len_AB, len_AC, len_BC;
+    label_vector idx_AB, idx_AC, idx_BC;
+
+    random_group('a', len_AB, idx_AB);
+    random_group('f', len_AC, idx_AC);
+    random_group('k', len_BC, idx_BC);
+
+    bool swap_A = random_number(0,1);
+    bool swap_B = random_number(0,1);
+    bool swap_C = random_number(0,1);
+
+    label_vector idx_A = swap_A ? idx_AB+idx_AC : idx_AC+idx_AB;
+    label_vector idx_B = swap_B ? idx_BC+idx_AB : idx_AB+idx_BC;
+    label_vector idx_C = swap_C ? idx_BC+idx_AC : idx_AC+idx_BC;
+
+    varray<T> A(swap_A ? len_AB+len_AC : len_AC+len_AB);
+    varray<T> B(swap_B ? len_BC+len_AB : len_AB+len_BC);
+    varray<T> C(swap_C ? len_BC+len_AC : len_AC+len_BC);
+    varray<T> D, E;
+
+    randomize_tensor(A);
+    randomize_tensor(B);
+    randomize_tensor(C);
+
+    T scale(10.0*random_unit<T>());
+
+    TENSOR_INFO(A);
+    TENSOR_INFO(B);
+    TENSOR_INFO(C);
+
+    auto neps = (prod(len_AB)+1)*prod(C.lengths());
+
+    impl = REFERENCE;
+    D.reset(C);
+    mult<T>(scale, A, idx_A.data(), B, idx_B.data(), scale, D, idx_C.data());
+
+    impl = BLIS_BASED;
+    E.reset(C);
+
+    tblis_set_stats_enabled(true);
+    tblis_reset_stats();
+
+    mult<T>(scale, A, idx_A.data(), B, idx_B.data(), scale, E, idx_C.data());
+
+    tblis_set_stats_enabled(false);
+
+    tblis_stats stats;
+    tblis_get_stats(KERNEL_GEMM, &stats);
+
+    INFO_OR_PRINT("bytes packed = " << stats.bytes_packed);
+    INFO_OR_PRINT("bytes scattered = " << stats.bytes_scattered);
+    REQUIRE(stats.bytes_packed > 0);
+    REQUIRE(stats.bytes_scattered == 0);
+
+    add<T>(T(-1), D, idx_C.data(), T(1), E, idx_C.data());
+    T error = reduce<T>(REDUCE_NORM_2, E, idx_C.data()).first;
+
+    check("BLIS", error, scale*neps);
+}
+
+/*
+ * An epilogue function which multiplies by the value pointed to by data.
+ */
+template <typename T>
+void scale_epilogue(void* data, type_t type, len_type n, void* values)
+{
+    TBLIS_ASSERT(type == type_tag<T>::value);
+
+    for (len_type i = 0;i < n;i++)
+        static_cast<T*>(values)[i] *= *static_cast<const T*>(data);
+}
+
+REPLICATED_TEMPLATED_TEST_CASE(contract_epilogue, R, T, all_types)
+{
+    varray<T> A, B, C, D, E, F;
+    label_vector idx_A, idx_B, idx_C;
+
+    random_contract(N, A, idx_A, B, idx_B, C, idx_C);
+
+    T scale(10.0*random_unit<T>());
+    T gamma(random_unit<T>());
+    T factor(2.0);
+
+    unsigned ndim_C = C.dimension();
+
+    F.reset(C);
+    randomize_tensor(F);
+
+    /*
+     * Denominators close to one (per index) so that the result is well
+     * conditioned, with some indices left out.
+     */
+    std::vector<row<T>> v(ndim_C);
+    std::vector<tblis_vector> v_s(ndim_C);
+    std::vector<const tblis_vector*> denom(ndim_C);
+
+    for (unsigned i = 0;i < ndim_C;i++)
+    {
+        v[i].reset({C.length(i)}, uninitialized);
+        v[i].for_each_element([](T& e) { e = T(1) + T(0.5)*random_unit<T>(); });
+        v_s[i] = tblis_vector(v[i].data(), v[i].length(), v[i].stride());
+        denom[i] = random_number(0,3) == 0 ? nullptr : &v_s[i];
+    }
+
+    bool divide = std::any_of(denom.begin(), denom.end(),
+                              [](const tblis_vector* v) { return v != nullptr; });
+
+    TENSOR_INFO(A);
+    TENSOR_INFO(B);
+    TENSOR_INFO(C);
+
+    auto idx_AB = intersection(idx_A, idx_B);
+    auto neps = (prod(select_from(A.lengths(), idx_A, idx_AB))+1)*prod(C.lengths());
+
+    impl = REFERENCE;
+    D.reset(C);
+    mult<T>(scale, A, idx_A.data(), B, idx_B.data(), scale, D, idx_C.data());
+
+    D.for_each_element(
+    [&](T& x, const len_vector& pos)
+    {
+        stride_type off_F = 0;
+        T den = T(0);
+
+        for (unsigned i = 0;i < ndim_C;i++)
+        {
+            off_F += pos[i]*F.stride(i);
+            if (denom[i]) den += v[i](pos[i]);
+        }
+
+        x += gamma*F.data()[off_F];
+        if (divide) x /= den;
+        x *= factor;
+    });
+
+    varray_view<T> Fv = F;
+    tblis_tensor F_s(gamma, Fv);
+
+    tblis_mult_epilogue epilogue = {};
+    epilogue.add = &F_s;
+    epilogue.denom = denom.data();
+    epilogue.func = scale_epilogue<T>;
+    epilogue.func_data = &factor;
+
+    /*
+     * The epilogue is fused with TensorGEMM, and applied afterwards
+     * otherwise.
+     */
+    for (auto algorithm : {BLIS_BASED, REFERENCE})
+    {
+        INFO_OR_PRINT("impl = " << algorithm);
+
+        impl = algorithm;
+        E.reset(C);
+
+        varray_view<T> Av = A, Bv = B, Ev = E;
+        tblis_tensor A_s(scale, Av);
+        tblis_tensor B_s(Bv);
+        tblis_tensor E_s(scale, Ev);
+
+        tblis_tensor_mult_epilogue(nullptr, nullptr,
+                                   &A_s, idx_A.data(), &B_s, idx_B.data(),
+                                   &E_s, idx_C.data(), &epilogue);
+
+        add<T>(T(-1), D, idx_C.data(), T(1), E, idx_C.data());
+        T error = reduce<T>(REDUCE_NORM_2, E, idx_C.data()).first;
+
+        check("EPILOGUE", error, T(4)*scale*neps);
+    }
+
+    impl = BLIS_BASED;
+}
+
+REPLICATED_TEMPLATED_TEST_CASE(contract_weighted, R, T, all_types)
+{
+    varray<T> A, B, C, D, E, W, AW;
+    label_vector idx_A, idx_B, idx_C;
+
+    random_contract(N, A, idx_A, B, idx_B, C, idx_C);
+
+    T scale(10.0*random_unit<T>());
+    bool conj_W = random_choice();
+
+    /*
+     * Weight some of the indices shared by A and B.
+     */
+    label_vector idx_W;
+    len_vector len_W;
+    for (auto idx : intersection(idx_A, idx_B))
+    {
+        if (random_choice()) continue;
+
+        idx_W.push_back(idx);
+        len_W.push_back(A.length(std::find(idx_A.begin(), idx_A.end(), idx) - idx_A.begin()));
+    }
+
+    /*
+     * A scalar weight is kept in a tensor of length one and passed with no
+     * dimensions.
+     */
+    W.reset(len_W.empty() ? len_vector{1} : len_W);
+    randomize_tensor(W);
+
+    TENSOR_INFO(A);
+    TENSOR_INFO(W);
+    TENSOR_INFO(B);
+    TENSOR_INFO(C);
+
+    auto idx_AB = intersection(idx_A, idx_B);
+    auto neps = prod(select_from(A.lengths(), idx_A, idx_AB))*prod(C.lengths());
+
+    AW.reset(A);
+    AW.for_each_element(
+    [&](T& x, const len_vector& pos)
+    {
+        stride_type off_W = 0;
+
+        for (unsigned i = 0;i < idx_W.size();i++)
+        {
+            auto dim = std::find(idx_A.begin(), idx_A.end(), idx_W[i]) - idx_A.begin();
+            off_W += pos[dim]*W.stride(i);
+        }
+
+        x *= conj(conj_W, W.data()[off_W]);
+    });
+
+    impl = REFERENCE;
+    D.reset(C);
+    mult<T>(scale, AW, idx_A.data(), B, idx_B.data(), scale, D, idx_C.data());
+
+    for (auto algorithm : {BLIS_BASED, REFERENCE})
+    {
+        INFO_OR_PRINT("impl = " << algorithm);
+
+        impl = algorithm;
+        E.reset(C);
+
+        varray_view<T> Av = A, Wv = W, Bv = B, Ev = E;
+        tblis_tensor A_s(scale, Av);
+        tblis_tensor W_s(Wv);
+        tblis_tensor B_s(Bv);
+        tblis_tensor E_s(scale, Ev);
+        W_s.ndim = idx_W.size();
+        W_s.conj = conj_W;
+
+        tblis_tensor_mult_weighted(nullptr, nullptr,
+                                   &A_s, idx_A.data(), &W_s, idx_W.data(),
+                                   &B_s, idx_B.data(), &E_s, idx_C.data());
+
+        add<T>(T(-1), D, idx_C.data(), T(1), E, idx_C.data());
+        T error = reduce<T>(REDUCE_NORM_2, E, idx_C.data()).first;
+
+        check("WEIGHTED", error, scale*neps);
+    }
+
+    impl = BLIS_BASED;
+}
+
+REPLICATED_TEMPLATED_TEST_CASE(contract_algorithms, R, T, all_types)
+{
+    varray<T> A, B, C, D, E;
+    label_vector idx_A, idx_B, idx_C;
+
+    random_contract(N, A, idx_A, B, idx_B, C, idx_C);
+
+    T scale(10.0*random_unit<T>());
+
+    TENSOR_INFO(A);
+    TENSOR_INFO(B);
+    TENSOR_INFO(C);
+
+    auto idx_AB = intersection(idx_A, idx_B);
+    auto neps = (prod(select_from(A.lengths(), idx_A, idx_AB))+1)*prod(C.lengths());
+
+    impl = REFERENCE;
+    D.reset(C);
+    mult<T>(scale, A, idx_A.data(), B, idx_B.data(), scale, D, idx_C.data());
+
+    /*
+     * The per-call options take precedence over impl.
+     */
+    for (auto algorithm : {MULT_ALGORITHM_AUTO,
+                           MULT_ALGORITHM_TENSOR_GEMM,
+                           MULT_ALGORITHM_TRANSPOSE_GEMM,
+                           MULT_ALGORITHM_VECTOR})
+    {
+        INFO_OR_PRINT("algorithm = " << algorithm);
+
+        tblis_mult_options options = {};
+        options.algorithm = algorithm;
+
+        E.reset(C);
+        mult<T>(scale, A, idx_A.data(), B, idx_B.data(), scale, E, idx_C.data(), &options);
+
+        add<T>(T(-1), D, idx_C.data(), T(1), E, idx_C.data());
+        T error = reduce<T>(REDUCE_NORM_2, E, idx_C.data()).first;
+
+        check("ALGORITHM", error, scale*neps);
+    }
+
+    impl = BLIS_BASED;
+}
+
+REPLICATED_TEMPLATED_TEST_CASE(contract_mixed, R, T, all_types)
+{
+    typedef other_precision_t<T> U;
+    typedef higher_precision_t<T,U> V;
+
+    varray<T> A, B, C;
+    label_vector idx_A, idx_B, idx_C;
+
+    random_contract(N, A, idx_A, B, idx_B, C, idx_C);
+
+    T scale(10.0*random_unit<T>());
+
+    TENSOR_INFO(A);
+    TENSOR_INFO(B);
+    TENSOR_INFO(C);
+
+    auto idx_AB = intersection(idx_A, idx_B);
+    auto neps = prod(select_from(A.lengths(), idx_A, idx_AB))*prod(C.lengths());
+
+    /*
+     * Compare to a contraction done entirely in the higher precision with
+     * the same (converted) data.
+     */
+    varray<U> E(C);
+    varray<V> AV(A), BV(B), CV(E);
+
+    impl = REFERENCE;
+    mult<V>(V(scale), AV, idx_A.data(), BV, idx_B.data(), V(scale), CV, idx_C.data());
+    varray<U> D(CV);
+
+    impl = BLIS_BASED;
+    mult<T>(scale, A, idx_A.data(), B, idx_B.data(), U(scale), E, idx_C.data());
+
+    add<U>(U(-1), D, idx_C.data(), U(1), E, idx_C.data());
+    U error = reduce<U>(REDUCE_NORM_2, E, idx_C.data()).first;
+
+    check("MIXED", error, scale*neps);
+}
+
+REPLICATED_TEMPLATED_TEST_CASE(contract_plan, R, T, all_types)
+{
+    varray<T> A, B, C, D, E;
+    label_vector idx_A, idx_B, idx_C;
+
+    random_contract(N, A, idx_A, B, idx_B, C, idx_C);
+
+    T scale(10.0*random_unit<T>());
+
+    TENSOR_INFO(A);
+    TENSOR_INFO(B);
+    TENSOR_INFO(C);
+
+    auto idx_AB = intersection(idx_A, idx_B);
+    auto neps = prod(select_from(A.lengths(), idx_A, idx_AB))*prod(C.lengths());
+
+    varray_view<T> Av = A, Bv = B, Cv = C;
+    tblis_tensor A_s(Av), B_s(Bv), C_s(Cv);
+
+    auto plan = tblis_tensor_mult_plan_create(nullptr, &A_s, idx_A.data(), &B_s, idx_B.data(),
+                                              &C_s, idx_C.data());
+
+    for (int i = 0;i < 2;i++)
+    {
+        impl = i == 0 ? BLIS_BASED : REFERENCE;
+
+        D.reset(C);
+        mult<T>(scale, A, idx_A.data(), B, idx_B.data(), scale, D, idx_C.data());
+
+        E.reset(C);
+        varray_view<T> Ev = E;
+        tblis_tensor A_s(scale, Av), B_s(Bv), E_s(scale, Ev);
+        tblis_tensor_mult_plan_execute(nullptr, plan, &A_s, &B_s, &E_s);
+
+        add<T>(T(-1), D, idx_C.data(), T(1), E, idx_C.data());
+        T error = reduce<T>(REDUCE_NORM_2, E, idx_C.data()).first;
+
+        check("PLAN", error, scale*neps);
+
+        /*
+         * The plan can be reused with different data and scalars.
+         */
+        A.for_each_element([](T& a) { a = random_unit<T>(); });
+        scale = T(10.0*random_unit<T>());
+    }
+
+    impl = BLIS_BASED;
+
+    tblis_tensor_mult_plan_free(plan);
+}
+
+REPLICATED_TEMPLATED_TEST_CASE(contract_batch, R, T, all_types)
+{
+    constexpr int nbatch = 5;
+
+    varray<T> A[nbatch], B[nbatch], C[nbatch], D[nbatch];
+    varray_view<T> Av[nbatch], Bv[nbatch], Cv[nbatch];
+    label_vector idx_A[nbatch], idx_B[nbatch], idx_C[nbatch];
+    std::vector<tblis_tensor> A_s, B_s, C_s;
+    const label_type *idx_A_s[nbatch], *idx_B_s[nbatch], *idx_C_s[nbatch];
+    stride_type neps[nbatch];
+
+    T scale(10.0*random_unit<T>());
+
+    /*
+     * Mix one full-size contraction in with several much smaller ones.
+     */
+    for (int i = 0;i < nbatch;i++)
+    {
+        random_contract(i == 0 ? N : N/100, A[i], idx_A[i], B[i], idx_B[i], C[i], idx_C[i]);
+
+        TENSOR_INFO(A[i]);
+        TENSOR_INFO(B[i]);
+        TENSOR_INFO(C[i]);
+
+        auto idx_AB = intersection(idx_A[i], idx_B[i]);
+        neps[i] = prod(select_from(A[i].lengths(), idx_A[i], idx_AB))*prod(C[i].lengths());
+
+        D[i].reset(C[i]);
+        mult<T>(scale, A[i], idx_A[i].data(), B[i], idx_B[i].data(), scale, D[i], idx_C[i].data());
+
+        Av[i].reset(A[i]);
+        Bv[i].reset(B[i]);
+        Cv[i].reset(C[i]);
+        A_s.emplace_back(scale, Av[i]);
+        B_s.emplace_back(Bv[i]);
+        C_s.emplace_back(scale, Cv[i]);
+        idx_A_s[i] = idx_A[i].data();
+        idx_B_s[i] = idx_B[i].data();
+        idx_C_s[i] = idx_C[i].data();
+    }
+
+    tblis_tensor_mult_batch(nullptr, nullptr, nbatch, A_s.data(), idx_A_s,
+                            B_s.data(), idx_B_s, C_s.data(), idx_C_s);
+
+    for (int i = 0;i < nbatch;i++)
+    {
+        add<T>(T(-1), D[i], idx_C[i].data(), T(1), C[i], idx_C[i].data());
+        T error = reduce<T>(REDUCE_NORM_2, C[i], idx_C[i].data()).first;
+
+        check("BATCH", error, scale*neps[i]);
+    }
+}
+
 REPLICATED_TEMPLATED_TEST_CASE(dpd_contract, R, T, all_types)
 {
     dpd_varray<T> A, B, C, D, E;
@@ -131,6 +778,68 @@ REPLICATED_TEMPLATED_TEST_CASE(dpd_contract, R, T, all_types)
     check("BLIS", error, scale*neps);
 }
 
+REPLICATED_TEMPLATED_TEST_CASE(dpd_contract_algorithms, R, T, all_types)
+{
+    dpd_varray<T> A, B, C, D, E;
+    label_vector idx_A, idx_B, idx_C;
+
+    T scale(10.0*random_unit<T>());
+
+    random_contract(N, A, idx_A, B, idx_B, C, idx_C);
+
+    DPD_TENSOR_INFO(A);
+    DPD_TENSOR_INFO(B);
+    DPD_TENSOR_INFO(C);
+
+    auto idx_AB = intersection(idx_A, idx_B);
+    auto idx_AC = intersection(idx_A, idx_C);
+    auto idx_BC = intersection(idx_B, idx_C);
+
+    auto size_AB = group_size(A.lengths(), idx_A, idx_AB);
+    auto size_AC = group_size(A.lengths(), idx_A, idx_AC);
+    auto size_BC = group_size(B.lengths(), idx_B, idx_BC);
+
+    unsigned nirrep = A.num_irreps();
+    stride_type neps = 0;
+    for (unsigned irrep_AB = 0;irrep_AB < nirrep;irrep_AB++)
+    {
+        unsigned irrep_AC = A.irrep()^irrep_AB;
+        unsigned irrep_BC = B.irrep()^irrep_AB;
+
+        neps += (size_AB[irrep_AB]+1)*
+                size_AC[irrep_AC]*
+                size_BC[irrep_BC];
+    }
+
+    dpd_impl = dpd_impl_t::FULL;
+    D.reset(C);
+    mult<T>(scale, A, idx_A.data(), B, idx_B.data(), scale, D, idx_C.data());
+
+    /*
+     * The per-call options take precedence over dpd_impl.
+     */
+    for (auto algorithm : {DPD_ALGORITHM_AUTO,
+                           DPD_ALGORITHM_BLIS,
+                           DPD_ALGORITHM_BLOCKED})
+    {
+        INFO_OR_PRINT("algorithm = " << algorithm);
+
+        tblis_mult_options options = {};
+        options.algorithm = MULT_ALGORITHM_AUTO;
+        options.dpd_algorithm = algorithm;
+
+        E.reset(C);
+        mult<T>(scale, A, idx_A.data(), B, idx_B.data(), scale, E, idx_C.data(), &options);
+
+        add<T>(T(-1), D, idx_C.data(), T(1), E, idx_C.data());
+        T error = reduce<T>(REDUCE_NORM_2, E, idx_C.data()).first;
+
+        check("ALGORITHM", error, scale*neps);
+    }
+
+    dpd_impl = dpd_impl_t::BLIS;
+}
+
 REPLICATED_TEMPLATED_TEST_CASE(indexed_contract, R, T, all_types)
 {
     indexed_varray<T> A, B, C, D, E;
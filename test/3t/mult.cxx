@@ -82,7 +82,7 @@ REPLICATED_TEMPLATED_TEST_CASE(mult, R, T, all_types)
 
 REPLICATED_TEMPLATED_TEST_CASE(dpd_mult, R, T, all_types)
 {
-    dpd_varray<T> A, B, C, D, E;
+    dpd_varray<T> A, B, C, D, E, F;
     label_vector idx_A, idx_B, idx_C;
 
     T scale(10.0*random_unit<T>());
@@ -134,8 +134,19 @@ REPLICATED_TEMPLATED_TEST_CASE(dpd_mult, R, T, all_types)
     E.reset(C);
     mult<T>(scale, A, idx_A.data(), B, idx_B.data(), scale, E, idx_C.data());
 
+    auto old_max_size = dpd_full_max_size;
+    dpd_full_max_size = 1;
+    F.reset(C);
+    mult<T>(scale, A, idx_A.data(), B, idx_B.data(), scale, F, idx_C.data());
+    dpd_full_max_size = old_max_size;
+
+    add<T>(T(-1), D, idx_C.data(), T(1), F, idx_C.data());
+    T error = reduce<T>(REDUCE_NORM_2, F, idx_C.data()).first;
+
+    check("TILED", error, scale*neps);
+
     add<T>(T(-1), D, idx_C.data(), T(1), E, idx_C.data());
-    T error = reduce<T>(REDUCE_NORM_2, E, idx_C.data()).first;
+    error = reduce<T>(REDUCE_NORM_2, E, idx_C.data()).first;
 
     check("BLOCKED", error, scale*neps);
 }
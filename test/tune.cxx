@@ -0,0 +1,242 @@
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <limits>
+#include <iostream>
+#include <getopt.h>
+#include <sstream>
+#include <functional>
+#include <vector>
+
+#include "tblis.h"
+#include "configs/tuning.hpp"
+#include "util/time.hpp"
+#include "util/tensor.hpp"
+#include "util/random.hpp"
+
+using namespace std;
+using namespace tblis;
+
+/*
+ * Tune the cache blocksizes and thread partitioning of the default
+ * configuration for this machine by timing a square matrix multiplication
+ * through the normal GEMM code path. Each parameter is varied in turn while
+ * the others are held fixed (coordinate descent), and the best values found
+ * are written to the tuning file, where they are picked up automatically by
+ * get_default_config().
+ */
+
+template <typename T>
+struct tuner
+{
+    config cfg;
+    len_type m, n, k;
+    int R;
+    unsigned nt;
+
+    matrix<T> A, B, C;
+
+    tuner(len_type m, len_type n, len_type k, int R)
+    : cfg(get_default_config()), m(m), n(n), k(k), R(R),
+      nt(tblis_get_num_threads()), A({m, k}), B({k, n}), C({m, n})
+    {
+        A.for_each_element([](T& e) { e = random_unit<T>(); });
+        B.for_each_element([](T& e) { e = random_unit<T>(); });
+        C.for_each_element([](T& e) { e = random_unit<T>(); });
+    }
+
+    double time(const tuning& t)
+    {
+        set_tuning<T>(cfg, t);
+
+        tblis_matrix At(A.view());
+        tblis_matrix Bt(B.view());
+        tblis_matrix Ct(T(0), C.view());
+
+        // warm up the memory pool and caches
+        tblis_matrix_mult(nullptr, cfg, &At, &Bt, &Ct);
+
+        double dt = numeric_limits<double>::max();
+        for (int r = 0;r < R;r++)
+        {
+            double t0 = tic();
+            tblis_matrix_mult(nullptr, cfg, &At, &Bt, &Ct);
+            double t1 = tic();
+            dt = min(dt, t1-t0);
+        }
+
+        return 2*m*n*k*(stl_ext::is_complex<T>::value ? 4 : 1)*1e-9/dt;
+    }
+
+    void print(const char* what, const tuning& t, double perf)
+    {
+        printf("%-12s MC=%4ld NC=%5ld KC=%4ld ratio=%u:%u max=%u:%u %8.3f GFLOPs\n",
+               what, (long)t.mc, (long)t.nc, (long)t.kc,
+               t.m_thread_ratio, t.n_thread_ratio,
+               t.mr_max_thread, t.nr_max_thread, perf);
+        fflush(stdout);
+    }
+
+    void sweep(const char* what, tuning& best, double& best_perf,
+               const vector<tuning>& candidates)
+    {
+        for (auto& t : candidates)
+        {
+            double perf = time(t);
+            print(what, t, perf);
+
+            if (perf > best_perf)
+            {
+                best_perf = perf;
+                best = get_tuning<T>(cfg);
+            }
+        }
+
+        set_tuning<T>(cfg, best);
+    }
+
+    template <typename Field>
+    vector<tuning> scale(const tuning& base, Field field, len_type iota)
+    {
+        vector<tuning> candidates;
+
+        for (double f : {0.5, 0.625, 0.75, 0.875, 1.125, 1.25, 1.5, 2.0})
+        {
+            tuning t = base;
+            t.*field = max(iota, len_type(base.*field*f/iota)*iota);
+            if (t.*field != base.*field) candidates.push_back(t);
+        }
+
+        return candidates;
+    }
+
+    tuning run(int passes)
+    {
+        tuning best = get_tuning<T>(cfg);
+        double best_perf = time(best);
+        print("default", best, best_perf);
+
+        for (int pass = 0;pass < passes;pass++)
+        {
+            tuning prev = best;
+
+            sweep("KC", best, best_perf, scale(best, &tuning::kc, cfg.gemm_kr.def<T>()));
+            sweep("MC", best, best_perf, scale(best, &tuning::mc, cfg.gemm_mr.def<T>()));
+            sweep("NC", best, best_perf, scale(best, &tuning::nc, cfg.gemm_nr.def<T>()));
+
+            if (nt > 1)
+            {
+                vector<tuning> candidates;
+                for (unsigned mr : {1, 2, 3, 4})
+                for (unsigned nr : {1, 2, 3, 4})
+                {
+                    if (mr > 1 && nr > 1 && mr == nr) continue;
+                    tuning t = best;
+                    t.m_thread_ratio = mr;
+                    t.n_thread_ratio = nr;
+                    candidates.push_back(t);
+                }
+                sweep("ratio", best, best_perf, candidates);
+
+                candidates.clear();
+                for (unsigned mr : {1, 2, 4})
+                for (unsigned nr : {1, 2, 4})
+                {
+                    tuning t = best;
+                    t.mr_max_thread = mr;
+                    t.nr_max_thread = nr;
+                    candidates.push_back(t);
+                }
+                sweep("max_thread", best, best_perf, candidates);
+            }
+
+            if (memcmp(&prev, &best, sizeof(tuning)) == 0) break;
+        }
+
+        print("best", best, best_perf);
+
+        return best;
+    }
+};
+
+template <typename T>
+void tune(len_type m, len_type n, len_type k, int R, int passes,
+          const string& file, bool dry_run)
+{
+    tuner<T> t(m, n, k, R);
+
+    printf("Tuning %s on %s with %u thread(s), m=%ld n=%ld k=%ld\n",
+           t.cfg.name, machine_name().c_str(), t.nt, (long)m, (long)n, (long)k);
+
+    t.run(passes);
+
+    if (!dry_run)
+    {
+        save_tuning<T>(t.cfg, file);
+        printf("Wrote %s\n", file.c_str());
+    }
+}
+
+int main(int argc, char** argv)
+{
+    len_type m = 2000, n = -1, k = -1;
+    int R = 3;
+    int passes = 2;
+    string types = "d";
+    string file = tuning_file();
+    bool dry_run = false;
+
+    struct option opts[] = {{"m", required_argument, NULL, 'm'},
+                            {"n", required_argument, NULL, 'n'},
+                            {"k", required_argument, NULL, 'k'},
+                            {"rep", required_argument, NULL, 'r'},
+                            {"passes", required_argument, NULL, 'p'},
+                            {"types", required_argument, NULL, 't'},
+                            {"file", required_argument, NULL, 'f'},
+                            {"dry-run", no_argument, NULL, 'd'},
+                            {0, 0, 0, 0}};
+
+    int arg;
+    int index;
+    while ((arg = getopt_long(argc, argv, "m:n:k:r:p:t:f:d", opts, &index)) != -1)
+    {
+        istringstream iss;
+        switch (arg)
+        {
+            case 'm': iss.str(optarg); iss >> m; break;
+            case 'n': iss.str(optarg); iss >> n; break;
+            case 'k': iss.str(optarg); iss >> k; break;
+            case 'r': iss.str(optarg); iss >> R; break;
+            case 'p': iss.str(optarg); iss >> passes; break;
+            case 't': types = optarg; break;
+            case 'f': file = optarg; break;
+            case 'd': dry_run = true; break;
+            case '?': abort(); break;
+        }
+    }
+
+    if (n < 0) n = m;
+    if (k < 0) k = m;
+
+    if (file.empty() && !dry_run)
+    {
+        fprintf(stderr, "No tuning file, set TBLIS_TUNING_FILE or use --file\n");
+        return 1;
+    }
+
+    for (char type : types)
+    {
+        switch (type)
+        {
+            case 's': tune<   float>(m, n, k, R, passes, file, dry_run); break;
+            case 'd': tune<  double>(m, n, k, R, passes, file, dry_run); break;
+            case 'c': tune<scomplex>(m, n, k, R, passes, file, dry_run); break;
+            case 'z': tune<dcomplex>(m, n, k, R, passes, file, dry_run); break;
+            default:
+                fprintf(stderr, "Unknown type '%c'\n", type);
+                return 1;
+        }
+    }
+
+    return 0;
+}